@@ -3,8 +3,14 @@
 
 #include "srm/autoaim/autoaim-armor.h"
 #include "srm/autoaim/autoaim-base.h"
+#include "srm/autoaim/autoaim-rune.h"
 #include "srm/autoaim/detector-armor.h"
+#include "srm/autoaim/detector-rune.h"
 #include "srm/autoaim/drawer.h"
+#include "srm/autoaim/fire-controller.h"
 #include "srm/autoaim/info.hpp"
+#include "srm/autoaim/predictor-armor.h"
+#include "srm/autoaim/predictor-rune.h"
+#include "srm/autoaim/yolo-input.h"
 
 #endif  // SRM_AUTOAIM_HPP_
\ No newline at end of file
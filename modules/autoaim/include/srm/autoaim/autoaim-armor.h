@@ -5,6 +5,7 @@
 
 #include "srm/autoaim/autoaim-base.h"
 #include "srm/autoaim/detector-armor.h"
+#include "srm/autoaim/predictor-armor.h"
 
 namespace srm::autoaim {
 
@@ -16,11 +17,16 @@ class ArmorAutoaim final : public BaseAutoaim {
   friend class Drawer;
   bool Initialize() override;
   bool Run() override;
+  bool Warmup(cv::Size frame_size) override;
 
   bool InitializeViewerImpl() override;
 
  private:
-  std::unique_ptr<ArmorDetector> armor_detector_;      ///< 装甲板识别器
+  std::unique_ptr<ArmorDetector> armor_detector_;    ///< 装甲板识别器
+  std::unique_ptr<ArmorPredictor> armor_predictor_;  ///< 装甲板位置滤波与预测器
+  double armor_width_{};                             ///< 装甲板宽度，单位 mm
+  double armor_aspect_{1};                           ///< 装甲板正对时的高宽比
+  double pixel_sigma_{1};                            ///< 角点位置的标准差，单位像素
 };
 
 }  // namespace srm::autoaim
@@ -3,6 +3,7 @@
 
 #include <opencv2/core/mat.hpp>
 
+#include "srm/autoaim/fire-controller.h"
 #include "srm/autoaim/info.hpp"
 #include "srm/common.hpp"
 #include "srm/coord.hpp"
@@ -24,15 +25,19 @@ class BaseAutoaim {
   attr_writer_val(coord_solver_, InitCoordSolver);
 
   attr_writer_val(image_, SetImageList);
+  attr_writer_val(pixel_format_, SetPixelFormat);
   attr_writer_val(time_stamp_, SetTimeStamp);
   attr_writer_val(rm_self_, SetRmSelf);
   attr_writer_val(bullet_speed_, SetBulletSpeed);
   attr_writer_val(mode_, SetMode);
   attr_writer_val(color_, SetColor);
+  attr_writer_val(viewer_enabled_, EnableViewer);
 
   attr_reader_ref(yaw_, GetYaw);
   attr_reader_ref(pitch_, GetPitch);
   attr_reader_ref(fire_, IsFire);
+  attr_reader_ref(target_list_, GetTargetList);
+  attr_reader_ref(fire_controller_, GetFireController);
 
   /**
    * @brief 初始化自瞄
@@ -46,23 +51,49 @@ class BaseAutoaim {
    */
   virtual bool Run() { return false; };
 
+  /**
+   * @brief 预热自瞄，使用空白图片完成一次推理，使引擎和显存分配在切换模式前就绪
+   * @param frame_size 输入图片大小
+   * @return 是否预热成功
+   */
+  virtual bool Warmup(cv::Size frame_size) { return true; }
+
+  /**
+   * @brief 设置本相机到坐标求解器所标定相机的外参，多相机共用一套云台外参时使用
+   * @param [in] rm_cam_ref 旋转矩阵，将本相机坐标系下的点转到标定相机坐标系
+   * @param [in] ctv_cam_ref 本相机光心在标定相机坐标系下的位置，单位 mm
+   */
+  void SetCameraExtrinsic(coord::RMat REF_IN rm_cam_ref, coord::CTVec REF_IN ctv_cam_ref) {
+    rm_cam_ref_ = rm_cam_ref;
+    ctv_cam_ref_ = ctv_cam_ref;
+  }
+
  protected:
   std::shared_ptr<coord::Solver> coord_solver_;        ///< 坐标求解器
   std::shared_ptr<Drawer> drawer_;                     ///< 绘图类
-  std::unique_ptr<viewer::VideoViewer> viewer_;        ///< 图像显示接口
+  std::unique_ptr<viewer::WebViewer> viewer_;          ///< 图像显示接口
+  std::unique_ptr<FireController> fire_controller_;    ///< 开火决策器
 
   // 传入的参数
-  cv::Mat image_{};        ///< 图片
-  uint64_t time_stamp_{};  ///< 时间戳
-  coord::RMat rm_self_{};  ///< 位姿矩阵
-  float bullet_speed_{};   ///< 弹丸速度
-  Mode mode_{};            ///< 自瞄模式
-  Color color_{};          ///< 自身颜色
+  cv::Mat image_{};             ///< 图片，Bayer 原始数据时为单通道
+  PixelFormat pixel_format_{};  ///< 图片的像素格式
+  uint64_t time_stamp_{};       ///< 时间戳
+  coord::RMat rm_self_{};       ///< 位姿矩阵
+  float bullet_speed_{};        ///< 弹丸速度
+  Mode mode_{};                 ///< 自瞄模式
+  Color color_{};               ///< 自身颜色
+  bool viewer_enabled_{true};   ///< 是否启用图像显示接口，须在 Initialize 前设置
+
+  coord::RMat rm_cam_ref_{coord::RMat::Identity()};  ///< 本相机到标定相机的旋转
+  coord::CTVec ctv_cam_ref_{coord::CTVec::Zero()};   ///< 本相机光心在标定相机坐标系下的位置
 
   // 传出的参数
-  float yaw_{};    ///< 水平方向
-  float pitch_{};  ///< 竖直方向
-  bool fire_{};    ///< 是否开火
+  float yaw_{};               ///< 水平方向
+  float pitch_{};             ///< 竖直方向
+  bool fire_{};               ///< 是否开火
+  ArmorPtrList target_list_;  ///< 本帧识别到的目标，能量机关扇叶也以四边形形式给出
+
+  viewer::Overlay overlay_;  ///< 本帧的绘图，由绘图类生成，随图像发送到图像显示接口
 
   /// 初始化图像显示接口
   virtual bool InitializeViewer();
@@ -70,6 +101,17 @@ class BaseAutoaim {
   /// 初始化绘图类
   virtual bool InitializeDrawer();
 
+  /// 初始化开火决策器
+  virtual bool InitializeFireController();
+
+  /// 本相机坐标系下的点经相机外参和当前位姿转换到世界坐标系
+  [[nodiscard]] coord::CTVec CamToWorld(coord::CTVec REF_IN ctv_cam) const {
+    return coord_solver_->CamToWorld(rm_cam_ref_ * ctv_cam + ctv_cam_ref_, rm_self_);
+  }
+
+  /// 将当前图像、识别结果和绘图发送到图像显示接口，发送后清空绘图，未启用图像显示接口时只清空绘图
+  void SendViewerFrame();
+
   ///真正调用viewer_->initialize的函数
   virtual bool InitializeViewerImpl()=0;
 };
@@ -0,0 +1,71 @@
+#ifndef SRM_AUTOAIM_AUTOAIM_RUNE_H_
+#define SRM_AUTOAIM_AUTOAIM_RUNE_H_
+
+#include <memory>
+
+#include "srm/autoaim/autoaim-base.h"
+#include "srm/autoaim/detector-rune.h"
+#include "srm/autoaim/predictor-rune.h"
+
+namespace srm::autoaim {
+
+/// 能量机关自瞄类，同时负责小能量机关和大能量机关，由 mode_ 区分
+class RuneAutoaim final : public BaseAutoaim {
+  inline static auto registry = RegistrySub<BaseAutoaim, RuneAutoaim>("rune");
+
+ public:
+  friend class Drawer;
+  bool Initialize() override;
+  bool Run() override;
+  bool Warmup(cv::Size frame_size) override;
+
+  bool InitializeViewerImpl() override;
+
+ private:
+  /// 能量机关平面坐标系，在目标重新出现时建立，之后保持固定
+  struct RunePlane {
+    coord::CTVec origin;  ///< 原点，取建立时的中心位置
+    coord::CTVec normal;  ///< 法向，指向相机一侧
+    coord::CTVec axis_u;  ///< 平面内第一坐标轴
+    coord::CTVec axis_v;  ///< 平面内第二坐标轴
+  };
+
+  /**
+   * @brief 求解扇叶靶心和能量机关中心的世界坐标
+   * @param [in] fan 扇叶
+   * @param [out] ctv_w_target 靶心世界坐标
+   * @param [out] ctv_w_center 中心世界坐标
+   * @param [out] normal 能量机关平面法向（世界坐标系）
+   * @return 是否求解成功
+   */
+  bool SolveFan(RuneFanPtr REF_IN fan, coord::CTVec REF_OUT ctv_w_target, coord::CTVec REF_OUT ctv_w_center,
+                coord::CTVec REF_OUT normal) const;
+
+  /**
+   * @brief 计算击打世界坐标系中某点所需的云台角度，包含重力补偿
+   * @param [in] ctv_w 目标世界坐标
+   * @param [out] yaw 水平角度
+   * @param [out] pitch 竖直角度
+   * @param [out] flight_time 弹丸飞行时间，单位 s
+   * @return 弹速是否足以击中目标
+   */
+  bool Aim(coord::CTVec REF_IN ctv_w, float REF_OUT yaw, float REF_OUT pitch, double REF_OUT flight_time) const;
+
+  std::unique_ptr<RuneDetector> rune_detector_;    ///< 能量机关识别器
+  std::unique_ptr<RunePredictor> rune_predictor_;  ///< 转速拟合与预测器
+  CircleFitter circle_fitter_;                     ///< 旋转中心拟合器
+  RunePlane plane_{};                              ///< 能量机关平面坐标系
+  bool plane_valid_{};                             ///< 平面坐标系是否已建立
+
+  double radius_{};         ///< 靶心到中心的距离，单位 mm
+  double target_size_{};    ///< 靶心外接正方形边长，单位 mm
+  double delay_{};          ///< 除飞行时间以外的系统延迟，单位 s
+  double lost_time_{};      ///< 丢失多久后重置拟合数据，单位 s
+  double fire_interval_{};  ///< 两次开火的最小间隔，单位 s
+  uint64_t last_seen_{};    ///< 上一次看到目标的时间戳
+  uint64_t last_fire_{};    ///< 上一次开火的时间戳
+};
+
+}  // namespace srm::autoaim
+
+#endif  // SRM_AUTOAIM_AUTOAIM_RUNE_H_
@@ -2,6 +2,7 @@
 #define SRM_AUTOAIM_DETECTOR_ARMOR_H_
 
 #include "srm/autoaim/info.hpp"
+#include "srm/autoaim/yolo-input.h"
 #include "srm/common.hpp"
 #include "srm/coord.hpp"
 #include "srm/nn.hpp"
@@ -19,13 +20,15 @@ class ArmorDetector {
   /**
    * @brief 运行装甲板检测器
    * @param [in] image 传入图片
+   * @param pixel_format 图片的像素格式
    * @param [out] armor_list 传出装甲板列表
    * @return 是否运行成功
    */
-  bool Run(cv::Mat REF_IN image, ArmorPtrList REF_OUT armor_list)const;
+  bool Run(cv::Mat REF_IN image, PixelFormat pixel_format, ArmorPtrList REF_OUT armor_list) const;
 
  private:
   std::unique_ptr<nn::Yolo> yolo_;               ///< 神经网络接口
+  mutable YoloInput yolo_input_;                 ///< 神经网络输入准备
   std::shared_ptr<coord::Solver> coord_solver_;  ///< 坐标求解器接口
   std::shared_ptr<viewer::VideoViewer> viewer_;  ///< 可视化接口
 };
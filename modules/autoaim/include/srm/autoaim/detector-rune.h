@@ -0,0 +1,40 @@
+#ifndef SRM_AUTOAIM_DETECTOR_RUNE_H_
+#define SRM_AUTOAIM_DETECTOR_RUNE_H_
+
+#include "srm/autoaim/info.hpp"
+#include "srm/autoaim/yolo-input.h"
+#include "srm/common.hpp"
+#include "srm/nn.hpp"
+
+namespace srm::autoaim {
+
+/**
+ * @brief 能量机关识别器
+ * @details
+ * 网络输出 4 类：0 蓝色待击打，1 蓝色已激活，2 红色待击打，3 红色已激活；
+ * 5 个关键点：前 4 个为靶心外接四边形角点（左上、右上、右下、左下），第 5 个为中心 R 标
+ */
+class RuneDetector {
+ public:
+  bool Initialize();
+
+  /**
+   * @brief 运行能量机关检测器
+   * @param [in] image 传入图片
+   * @param pixel_format 图片的像素格式
+   * @param [out] fan_list 传出扇叶列表
+   * @return 是否运行成功
+   */
+  bool Run(cv::Mat REF_IN image, PixelFormat pixel_format, RuneFanPtrList REF_OUT fan_list) const;
+
+ private:
+  static constexpr int kPointNum = 5;  ///< 关键点数量
+
+  std::unique_ptr<nn::Yolo> yolo_;  ///< 神经网络接口
+  mutable YoloInput yolo_input_;    ///< 神经网络输入准备
+  float min_prob_{};                ///< 最低置信度
+};
+
+}  // namespace srm::autoaim
+
+#endif  // SRM_AUTOAIM_DETECTOR_RUNE_H_
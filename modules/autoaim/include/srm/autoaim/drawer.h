@@ -9,7 +9,10 @@ namespace srm::autoaim {
 
 class BaseAutoaim;
 
-/// 绘图类
+/**
+ * @brief 绘图类
+ * @details 不直接修改图像，而是向自瞄的 overlay_ 中追加绘图，没有图像显示接口或没有读者时不做任何事
+ */
 class Drawer {
  public:
   Drawer() = default;
@@ -20,10 +23,17 @@ class Drawer {
   /// 绘制单装甲板
   void DrawArmor(ArmorPtr REF_IN armor) const;
 
+  /// 绘制能量机关扇叶及其中心
+  void DrawRuneFan(RuneFanPtr REF_IN fan) const;
+
   /// 根据世界坐标在图像中进行绘制
   void DrawWorldPoint(coord::CTVec REF_IN ctv_w_origin_x) const;
 
  protected:
+  /// 是否需要生成绘图
+  [[nodiscard]] bool Enabled() const;
+
+
   BaseAutoaim* autoaim_;
 
  private:
@@ -0,0 +1,96 @@
+#ifndef SRM_AUTOAIM_FIRE_CONTROLLER_H_
+#define SRM_AUTOAIM_FIRE_CONTROLLER_H_
+
+#include <Eigen/Core>
+
+#include "srm/common.hpp"
+#include "srm/coord.hpp"
+
+namespace srm::autoaim {
+
+/// 单次开火决策所需的输入
+struct FireInput {
+  uint64_t time_stamp{};                                ///< 当前帧时间戳，单位 ns
+  coord::CTVec ctv_w_target{coord::CTVec::Zero()};      ///< 弹丸到达时刻目标的预测位置（世界坐标系），单位 mm
+  Eigen::Matrix3d cov_target{Eigen::Matrix3d::Zero()};  ///< 预测位置的协方差，单位 mm^2
+  double target_width{};                                ///< 目标宽度，单位 mm，为 0 时使用配置的装甲板尺寸
+  double target_height{};                               ///< 目标高度，单位 mm，为 0 时使用配置的装甲板尺寸
+  float facing_angle{};                                 ///< 装甲板法向与视线的夹角，单位弧度，0 表示正对
+  float pitch_lift{};                                   ///< 弹道补偿，即命中预测位置所需 pitch 角与其视线 pitch 角之差
+  float yaw_gimbal{};                                   ///< 当前云台 yaw 角
+  float pitch_gimbal{};                                 ///< 当前云台 pitch 角
+};
+
+/// 开火统计数据，用于离线回放时评估开火策略
+struct FireStatistics {
+  uint64_t decisions{};     ///< 决策次数
+  uint64_t shots{};         ///< 开火次数
+  uint64_t heat_limited{};  ///< 因热量限制放弃的开火次数
+  double expected_hits{};   ///< 开火时命中概率之和，即期望命中数
+
+  /// 期望命中率
+  [[nodiscard]] double ExpectedHitRate() const { return shots ? expected_hits / static_cast<double>(shots) : 0; }
+};
+
+/**
+ * @brief 开火决策类
+ * @details
+ * 根据目标在预测位置的角尺寸、云台当前指向与命中预测位置所需指向的偏差、预测位置协方差和装甲板朝向估计命中概率，
+ * 并在本地维护枪口热量模型限制射频。每次决策只包含常数次浮点运算，不依赖随机数，结果可复现。
+ */
+class FireController {
+ public:
+  FireController() = default;
+  ~FireController();
+
+  /**
+   * @brief 从配置文件读取参数
+   * @return 是否初始化成功
+   */
+  bool Initialize();
+
+  /**
+   * @brief 估计一次射击的命中概率
+   * @param [in] input 决策输入
+   * @return 命中概率，范围 [0, 1]
+   */
+  [[nodiscard]] double HitProbability(FireInput REF_IN input) const;
+
+  /**
+   * @brief 做出开火决策，并更新热量和统计数据
+   * @param [in] input 决策输入
+   * @return 是否开火
+   */
+  bool Decide(FireInput REF_IN input);
+
+  /**
+   * @brief 本帧没有可击打的目标，只更新热量模型
+   * @param time_stamp 当前帧时间戳，单位 ns
+   */
+  void Idle(uint64_t time_stamp);
+
+  attr_reader_ref(statistics_, Statistics);
+
+ private:
+  /// 按时间冷却枪口热量
+  void Cool(uint64_t time_stamp);
+
+  double min_probability_{};  ///< 开火所需的最低命中概率
+  double dispersion_{};       ///< 弹道散布标准差，单位弧度
+  double armor_width_{};      ///< 装甲板宽度，单位 mm
+  double armor_height_{};     ///< 装甲板高度，单位 mm
+  double facing_window_{};    ///< 可击打朝向半角，单位弧度
+  double heat_limit_{};       ///< 枪口热量上限
+  double heat_per_shot_{};    ///< 每发弹丸的热量
+  double cooling_rate_{};     ///< 每秒冷却值
+  double shoot_interval_{};   ///< 最小开火间隔，单位 s
+
+  double heat_{};               ///< 当前估计的枪口热量
+  uint64_t last_time_stamp_{};  ///< 上一次更新热量的时间戳
+  uint64_t last_shot_{};        ///< 上一次开火的时间戳
+  FireStatistics statistics_;   ///< 开火统计数据
+};
+
+}  // namespace srm::autoaim
+
+#endif  // SRM_AUTOAIM_FIRE_CONTROLLER_H_
@@ -33,6 +33,7 @@ struct Armor {
   Color color;                     ///< 装甲板颜色
   coord::RMat rm_cam;              ///< 装甲板旋转矩阵
   coord::CTVec ctv_w_x;            ///< 装甲板位移向量
+  float prob{1};                   ///< 识别置信度
 
   Armor(const std::array<cv::Point2f, 4> &pts, const Color color) : pts(pts), color(color) {}
 
@@ -41,6 +42,23 @@ struct Armor {
 using ArmorPtr = std::shared_ptr<Armor>;
 using ArmorPtrList = std::vector<ArmorPtr>;
 
+/// 能量机关扇叶
+struct RuneFan {
+  std::array<cv::Point2f, 4> pts;  ///< 扇叶靶心外接四边形角点，依次为左上、右上、右下、左下
+  cv::Point2f center;              ///< 能量机关中心 R 标在图片中的位置
+  Color color;                     ///< 扇叶颜色
+  bool activated;                  ///< 扇叶是否已被激活
+  float prob;                      ///< 置信度
+
+  RuneFan(const std::array<cv::Point2f, 4> &pts, const cv::Point2f &center, const Color color, const bool activated,
+          const float prob)
+      : pts(pts), center(center), color(color), activated(activated), prob(prob) {}
+
+  [[nodiscard]] cv::Point2f Center() const { return std::accumulate(pts.begin(), pts.end(), cv::Point2f(0, 0))/4; }
+};
+using RuneFanPtr = std::shared_ptr<RuneFan>;
+using RuneFanPtrList = std::vector<RuneFanPtr>;
+
 }  // namespace srm::autoaim
 
 #endif  // SRM_AUTOAIM_INFO_HPP_
@@ -0,0 +1,59 @@
+#ifndef SRM_AUTOAIM_PREDICTOR_ARMOR_H_
+#define SRM_AUTOAIM_PREDICTOR_ARMOR_H_
+
+#include <Eigen/Core>
+
+#include "srm/common.hpp"
+#include "srm/coord.hpp"
+
+namespace srm::autoaim {
+
+/**
+ * @brief 装甲板位置的匀速卡尔曼滤波器
+ * @details
+ * 状态为世界坐标系下的位置和速度，过程噪声为白噪声加速度。
+ * 观测为单帧解算的位置及其协方差，预测给出弹丸到达时刻的位置和协方差，供开火决策使用。
+ * 目标丢失超过 lost_time 或时间戳回退时重新初始化。
+ */
+class ArmorPredictor {
+ public:
+  bool Initialize();
+
+  /// 清空滤波状态
+  void Reset();
+
+  /**
+   * @brief 加入一帧观测
+   * @param time 时间，单位 s
+   * @param [in] position 观测位置，单位 mm
+   * @param [in] cov 观测协方差，单位 mm^2
+   */
+  void Update(double time, coord::CTVec REF_IN position, Eigen::Matrix3d REF_IN cov);
+
+  /**
+   * @brief 预测一段时间后的位置
+   * @param duration 预测时长，单位 s
+   * @param [out] position 预测位置，单位 mm
+   * @param [out] cov 预测位置的协方差，单位 mm^2
+   */
+  void Predict(double duration, coord::CTVec REF_OUT position, Eigen::Matrix3d REF_OUT cov) const;
+
+ private:
+  using State = Eigen::Matrix<double, 6, 1>;
+  using StateCov = Eigen::Matrix<double, 6, 6>;
+
+  /// 按匀速模型将状态向前推进 dt
+  void Propagate(double dt, State REF_OUT x, StateCov REF_OUT p) const;
+
+  double acceleration_noise_{};   ///< 白噪声加速度的标准差，单位 mm/s^2
+  double initial_speed_{};        ///< 初始化时速度的标准差，单位 mm/s
+  double lost_time_{};            ///< 超过此时间没有观测则重新初始化，单位 s
+  bool initialized_{};            ///< 是否已有观测
+  double time_{};                 ///< 最近一次观测的时间，单位 s
+  State x_{State::Zero()};        ///< 位置和速度
+  StateCov p_{StateCov::Zero()};  ///< 状态协方差
+};
+
+}  // namespace srm::autoaim
+
+#endif  // SRM_AUTOAIM_PREDICTOR_ARMOR_H_
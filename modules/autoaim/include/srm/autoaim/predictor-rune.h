@@ -0,0 +1,104 @@
+#ifndef SRM_AUTOAIM_PREDICTOR_RUNE_H_
+#define SRM_AUTOAIM_PREDICTOR_RUNE_H_
+
+#include <Eigen/Core>
+#include <vector>
+
+#include "srm/common.hpp"
+
+namespace srm::autoaim {
+
+/**
+ * @brief 增量式圆拟合器
+ * @details 采用 Kasa 代数拟合，只维护法方程的累加量并按遗忘因子衰减，每次更新和求解的代价均为常数
+ */
+class CircleFitter {
+ public:
+  explicit CircleFitter(double forgetting = 1) : forgetting_(forgetting) {}
+
+  /// 清空拟合数据
+  void Reset();
+
+  /**
+   * @brief 加入一个圆上的点
+   * @param x 横坐标
+   * @param y 纵坐标
+   */
+  void Update(double x, double y);
+
+  /**
+   * @brief 求解圆心和半径
+   * @param [out] center 圆心
+   * @param [out] radius 半径
+   * @return 数据是否足够求解
+   */
+  bool Solve(Eigen::Vector2d REF_OUT center, double REF_OUT radius) const;
+
+ private:
+  double forgetting_;                             ///< 遗忘因子
+  double weight_{};                               ///< 有效样本数
+  Eigen::Matrix3d ata_{Eigen::Matrix3d::Zero()};  ///< 法方程左侧 A^T A
+  Eigen::Vector3d atb_{Eigen::Vector3d::Zero()};  ///< 法方程右侧 A^T b
+};
+
+/**
+ * @brief 能量机关转速拟合与角度预测类
+ * @details
+ * 小能量机关匀速转动，只需估计方向；大能量机关转速满足 spd = a * sin(w * t) + b，
+ * 对固定的 w 可写成线性模型 spd = A * sin(w * t) + B * cos(w * t) + C。
+ * 在 w 的取值范围内取若干候选值，每个候选值各自维护一个带遗忘因子的递推最小二乘，
+ * 按残差选出最优模型，每帧的代价只与候选数量有关，不需要重新拟合历史数据。
+ */
+class RunePredictor {
+ public:
+  bool Initialize();
+
+  /// 清空拟合数据，目标丢失较久时调用
+  void Reset();
+
+  /**
+   * @brief 加入一帧扇叶角度观测
+   * @param time 时间，单位 s
+   * @param angle 扇叶在能量机关平面内的角度，单位弧度
+   */
+  void Update(double time, double angle);
+
+  /**
+   * @brief 预测一段时间内扇叶转过的角度
+   * @param time 当前时间，单位 s
+   * @param duration 预测时长，单位 s
+   * @param big_rune 是否为大能量机关
+   * @return 转过的角度，单位弧度
+   */
+  [[nodiscard]] double Predict(double time, double duration, bool big_rune) const;
+
+  attr_reader_val(samples_, Samples);
+
+ private:
+  /// 固定角频率的转速模型
+  struct SpeedModel {
+    double omega;       ///< 角频率
+    Eigen::Matrix3d p;  ///< 递推最小二乘协方差
+    Eigen::Vector3d x;  ///< 参数 (A, B, C)
+    double residual;    ///< 残差平方的滑动平均
+  };
+
+  /// 最优转速模型
+  [[nodiscard]] const SpeedModel &BestModel() const;
+
+  std::vector<SpeedModel> models_;  ///< 候选转速模型
+  double small_speed_{};            ///< 小能量机关转速，单位 rad/s
+  double forgetting_{};             ///< 递推最小二乘遗忘因子
+  int min_samples_{};               ///< 大能量机关模型生效所需的最少样本数
+
+  bool has_last_{};       ///< 是否有上一帧观测
+  double time_origin_{};  ///< 拟合的时间原点
+  double last_time_{};    ///< 上一帧时间
+  double last_angle_{};   ///< 上一帧角度
+  double mean_speed_{};   ///< 转速的滑动平均，用于判断转向
+  int samples_{};         ///< 已加入的转速样本数
+};
+
+}  // namespace srm::autoaim
+
+#endif  // SRM_AUTOAIM_PREDICTOR_RUNE_H_
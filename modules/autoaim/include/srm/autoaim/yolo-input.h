@@ -0,0 +1,40 @@
+#ifndef SRM_AUTOAIM_YOLO_INPUT_H_
+#define SRM_AUTOAIM_YOLO_INPUT_H_
+
+#include "srm/common.hpp"
+#include "srm/nn.hpp"
+
+namespace srm::autoaim {
+
+/**
+ * @brief 神经网络输入准备
+ * @details
+ * BGR 图像直接交给网络；Bayer 原始数据在一次遍历中完成去马赛克和信箱缩放，直接得到网络大小的输入，
+ * 网络输出的坐标再换算回原图坐标，全程不产生全分辨率的 BGR 图像。
+ */
+class YoloInput {
+ public:
+  /**
+   * @brief 初始化
+   * @param [in] prefix 网络配置路径，读取其中的 input_size
+   * @return 是否初始化成功
+   */
+  bool Initialize(std::string REF_IN prefix);
+
+  /**
+   * @brief 运行神经网络
+   * @param [in] yolo 神经网络接口
+   * @param [in] image 传入图片
+   * @param pixel_format 图片的像素格式
+   * @return 原图坐标下的检测结果
+   */
+  std::vector<nn::Objects> Run(nn::Yolo &yolo, cv::Mat REF_IN image, PixelFormat pixel_format);
+
+ private:
+  cv::Size input_size_;  ///< 网络输入大小
+  cv::Mat input_;        ///< 网络输入缓冲区
+};
+
+}  // namespace srm::autoaim
+
+#endif  // SRM_AUTOAIM_YOLO_INPUT_H_
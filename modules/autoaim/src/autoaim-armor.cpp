@@ -1,5 +1,7 @@
 #include "srm/autoaim/autoaim-armor.h"
 
+#include <algorithm>
+
 #include "srm/autoaim/drawer.h"
 
 namespace srm::autoaim {
@@ -10,6 +12,17 @@ bool ArmorAutoaim::Initialize() {
   /// 初始化detector,chooser,processor
   armor_detector_ = std::make_unique<ArmorDetector>();
   ret &= armor_detector_->Initialize();
+  armor_predictor_ = std::make_unique<ArmorPredictor>();
+  ret &= armor_predictor_->Initialize();
+  const auto armor_size = cfg.Get<std::vector<double>>({"autoaim.fire", "armor_size"});
+  if (armor_size.size() == 2 && armor_size[0] > 0) {
+    armor_width_ = armor_size[0];
+    armor_aspect_ = armor_size[1] / armor_size[0];
+  } else {
+    LOG(ERROR) << "The size of autoaim.fire.armor_size should be 2 with positive width.";
+    ret = false;
+  }
+  pixel_sigma_ = cfg.Get<double>({"autoaim.armor", "pixel_sigma"});
 
   if (!ret) {
     LOG(ERROR) << "Failed to initialize autoaim for armor.";
@@ -19,52 +32,77 @@ bool ArmorAutoaim::Initialize() {
 }
 
 bool ArmorAutoaim::Run() {
-  ArmorPtrList armor_list_;
+  target_list_.clear();
   /// 完成识别和处理，最终需要得到yaw_和pitch_的数据，注意这两个数据并不是相对角，而是要根据电控传来的rm_self_来进行计算其绝对角
   /// 如果未识别到，请发送0，这个时候机器人会自动进行视野的扫描，但如果想要自行在没识别到的时候也要自己操纵机器人的方向，也可不赋值为0
 
   // 运行detector，获得识别信息
-  armor_detector_->Run(image_, armor_list_);
+  armor_detector_->Run(image_, pixel_format_, target_list_);
 
-  if (armor_list_.empty()) {
+  if (target_list_.empty()) {
     // 如果未识别到
     yaw_ = 0;
     pitch_ = 0;
+    fire_ = false;
+    fire_controller_->Idle(time_stamp_);
     return false;
   }
 
   // 获取第一个数据（替换为置信度最高的？）
-  auto armor = armor_list_.front();
+  auto armor = target_list_.front();
 
   // 计算中心点
   cv::Point2f center = (armor->pts[0] + armor->pts[1] + armor->pts[2] + armor->pts[3]) * 0.25;
 
-  // 相机焦距
-  double fx =1.7766199808985457e+03;  ///来自从config.toml
-  // 目标的实际宽度
-  double width_ac = 45.0;
+  // 相机内参，来自config.toml
+  const auto& intrinsic = coord_solver_->intrinsic_mat_eigen();
+  const double fx = intrinsic(0, 0), fy = intrinsic(1, 1), cx = intrinsic(0, 2), cy = intrinsic(1, 2);
   // 目标在图像中的像素宽度
   double width_vr = abs(armor->pts[0].x-armor->pts[1].x);
-  // 计算 z 值
-  double z = (fx * width_ac) / width_vr;
+  // 由配置的装甲板宽度计算 z 值
+  double z = (fx * armor_width_) / width_vr;
 
-  // 使用 Solver 类来转换坐标
-  coord::Solver solver_trans;
-  // 假设 solver 已经初始化并且相关参数已经设置
-  coord::CTVec cam_cd(center.x, center.y, z);
+  // 像素坐标反投影到相机坐标系
+  coord::CTVec cam_cd((center.x - cx) * z / fx, (center.y - cy) * z / fy, z);
 
   // 获得一个在时空中绝对的坐标系
-  coord::RMat rm_imu = rm_self_;
-  coord::CTVec world_cd = solver_trans.CamToWorld(cam_cd, rm_imu);
+  coord::CTVec world_cd = CamToWorld(cam_cd);
+  armor->ctv_w_x = world_cd;
+
+  // 观测协方差：角点误差 pixel_sigma 个像素，横向误差随距离线性增长，深度由像素宽度估计，误差远大于横向误差
+  const coord::CTVec los = world_cd.normalized();
+  const double sigma_lateral = pixel_sigma_ * z / fx;
+  const double sigma_depth = pixel_sigma_ * z / width_vr;
+  const Eigen::Matrix3d cov_measure =
+      sigma_lateral * sigma_lateral * (Eigen::Matrix3d::Identity() - los * los.transpose()) +
+      sigma_depth * sigma_depth * los * los.transpose();
+  const double time = static_cast<double>(time_stamp_) * 1e-9;
+  armor_predictor_->Update(time, world_cd, cov_measure);
+
+  // 瞄准和开火决策都使用滤波器预测的弹丸到达时刻的位置和协方差，飞行时间依赖于预测位置，因此迭代一次
+  FireInput fire_input;
+  fire_input.ctv_w_target = world_cd;
+  for (int i = 0; i < 2; ++i) {
+    const double flight_time = bullet_speed_ > 0 ? fire_input.ctv_w_target.norm() * 1e-3 / bullet_speed_ : 0;
+    armor_predictor_->Predict(flight_time, fire_input.ctv_w_target, fire_input.cov_target);
+  }
 
-  /// 计算在 xy 平面上的距离
-  float xy_distance = sqrt(world_cd(0) * world_cd(0) + world_cd(1) * world_cd(1));
+  // 计算偏航角和俯仰角，世界坐标系方向依次为右、下、前
+  const coord::CTVec &ctv_w_aim = fire_input.ctv_w_target;
+  yaw_ = static_cast<float>(std::atan2(ctv_w_aim.x(), ctv_w_aim.z()));
+  pitch_ = static_cast<float>(std::atan2(-ctv_w_aim.y(), std::hypot(ctv_w_aim.x(), ctv_w_aim.z())));
 
-/*
-  // 计算偏航角和俯仰角
-  yaw_ = atan2(static_cast<float>(world_cd(1)), static_cast<float>(world_cd(0)));
-  pitch_ = atan2(static_cast<float>(world_cd(2)), xy_distance);
-*/
+  // 装甲板转过时水平方向投影变窄，由外接框宽高比相对正对时的比例估计朝向角
+  const double width_px = std::abs(armor->pts[1].x - armor->pts[0].x) / fx;
+  const double height_px = std::abs(armor->pts[3].y - armor->pts[0].y) / fy;
+  if (height_px > 0) {
+    fire_input.facing_angle = static_cast<float>(std::acos(std::clamp(width_px / height_px * armor_aspect_, 0.0, 1.0)));
+  }
+  const auto ea_self = coord::RMatToEAngle(rm_self_);
+  fire_input.time_stamp = time_stamp_;
+  fire_input.yaw_gimbal = static_cast<float>(ea_self.x());
+  fire_input.pitch_gimbal = static_cast<float>(ea_self.y());
+  fire_ = fire_controller_->Decide(fire_input);
 
   // 使用 Drawer 绘制装甲板和世界坐标点
   drawer_->DrawArmor(armor);  // 绘制装甲板的边框和中心点
@@ -72,11 +110,16 @@ bool ArmorAutoaim::Run() {
 
 
 #ifdef DEBUG
-  viewer_->SendFrame(image_);
+  SendViewerFrame();
 #endif
 
   return true;
 }
+bool ArmorAutoaim::Warmup(const cv::Size frame_size) {
+  ArmorPtrList armor_list;
+  return armor_detector_->Run(cv::Mat::zeros(frame_size, PixelFormatType(pixel_format_)), pixel_format_, armor_list);
+}
+
 bool ArmorAutoaim::InitializeViewerImpl() {
   return viewer_->Initialize(cfg.Get<std::string>({"viewer.web.shm_name", "armor"}),
                              cfg.Get<int>({"viewer.web", "armor"}));
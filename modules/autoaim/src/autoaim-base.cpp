@@ -4,15 +4,15 @@ namespace srm::autoaim {
 
 bool BaseAutoaim::Initialize() {
 #ifdef DEBUG
-  return InitializeViewer() && InitializeDrawer();
+  return (!viewer_enabled_ || InitializeViewer()) && InitializeDrawer() && InitializeFireController();
 #else
-  return InitializeDrawer();
+  return InitializeDrawer() && InitializeFireController();
 #endif
 }
 
 bool BaseAutoaim::InitializeViewer() {
   /// 现在只能web了，没有local了
-  viewer_ = std::make_unique<viewer::VideoViewer>();
+  viewer_ = std::make_unique<viewer::WebViewer>();
   if (!InitializeViewerImpl()) {
     LOG(ERROR) << "Failed to initialize viewer.";
     return false;
@@ -27,4 +27,35 @@ bool BaseAutoaim::InitializeDrawer() {
   return true;
 }
 
+bool BaseAutoaim::InitializeFireController() {
+  fire_controller_ = std::make_unique<FireController>();
+  if (!fire_controller_->Initialize()) {
+    LOG(ERROR) << "Failed to initialize fire controller.";
+    return false;
+  }
+  return true;
+}
+
+void BaseAutoaim::SendViewerFrame() {
+  if (!viewer_) {
+    overlay_.Clear();
+    return;
+  }
+  std::vector<viewer::ViewerDetection> detections;
+  detections.reserve(target_list_.size());
+  for (const auto &target : target_list_) {
+    viewer::ViewerDetection detection;
+    for (size_t i = 0; i < target->pts.size(); ++i) {
+      detection.pts[2 * i] = target->pts[i].x;
+      detection.pts[2 * i + 1] = target->pts[i].y;
+    }
+    detection.label = static_cast<int32_t>(target->color);
+    detection.prob = target->prob;
+    detections.push_back(detection);
+  }
+  /// 传入原始图像，只有被选中发送的帧才在编码线程中去马赛克
+  viewer_->SendFrame(image_, time_stamp_, detections, std::move(overlay_), pixel_format_);
+  overlay_.Clear();
+}
+
 }  // namespace srm::autoaim
\ No newline at end of file
@@ -0,0 +1,225 @@
+#include "srm/autoaim/autoaim-rune.h"
+
+#include <Eigen/Geometry>
+#include <cmath>
+#include <opencv2/calib3d.hpp>
+#include <opencv2/core/eigen.hpp>
+
+#include "srm/autoaim/drawer.h"
+
+namespace srm::autoaim {
+
+namespace {
+
+constexpr double kGravity = 9.8e3;  ///< 重力加速度，单位 mm/s^2
+
+}  // namespace
+
+bool RuneAutoaim::Initialize() {
+  /// 公共初始化
+  bool ret = BaseAutoaim::Initialize();
+  /// 初始化detector,predictor
+  rune_detector_ = std::make_unique<RuneDetector>();
+  ret &= rune_detector_->Initialize();
+  rune_predictor_ = std::make_unique<RunePredictor>();
+  ret &= rune_predictor_->Initialize();
+
+  const std::string prefix = "autoaim.rune";
+  radius_ = cfg.Get<double>({prefix, "radius"});
+  target_size_ = cfg.Get<double>({prefix, "target_size"});
+  delay_ = cfg.Get<double>({prefix, "delay"});
+  lost_time_ = cfg.Get<double>({prefix, "lost_time"});
+  fire_interval_ = cfg.Get<double>({prefix, "fire_interval"});
+  circle_fitter_ = CircleFitter(cfg.Get<double>({prefix, "forgetting"}));
+
+  if (!ret) {
+    LOG(ERROR) << "Failed to initialize autoaim for rune.";
+    return false;
+  }
+  return true;
+}
+
+bool RuneAutoaim::Run() {
+  RuneFanPtrList fan_list;
+  target_list_.clear();
+  if (!rune_detector_->Run(image_, pixel_format_, fan_list)) {
+    yaw_ = 0;
+    pitch_ = 0;
+    fire_ = false;
+    fire_controller_->Idle(time_stamp_);
+    return false;
+  }
+  for (const auto &it : fan_list) {
+    target_list_.push_back(std::make_shared<Armor>(it->pts, it->color));
+    target_list_.back()->prob = it->prob;
+  }
+
+  /// 选择自身颜色中置信度最高的待击打扇叶
+  RuneFanPtr fan;
+  for (const auto &it : fan_list) {
+    if (it->color == color_ && !it->activated && (!fan || it->prob > fan->prob)) {
+      fan = it;
+    }
+  }
+  coord::CTVec ctv_w_target, ctv_w_center, normal;
+  if (!fan || !SolveFan(fan, ctv_w_target, ctv_w_center, normal)) {
+    yaw_ = 0;
+    pitch_ = 0;
+    fire_ = false;
+    fire_controller_->Idle(time_stamp_);
+    return false;
+  }
+
+  /// 丢失过久、时间戳回退或首次识别时重新建立平面坐标系并清空拟合数据
+  if (!plane_valid_ || time_stamp_ <= last_seen_ ||
+      static_cast<double>(time_stamp_ - last_seen_) * 1e-9 > lost_time_) {
+    plane_.origin = ctv_w_center;
+    plane_.normal = normal;
+    plane_.axis_u = (coord::CTVec::UnitY() - coord::CTVec::UnitY().dot(normal) * normal).normalized();
+    plane_.axis_v = normal.cross(plane_.axis_u);
+    plane_valid_ = true;
+    circle_fitter_.Reset();
+    rune_predictor_->Reset();
+  }
+  last_seen_ = time_stamp_;
+
+  /// 拟合旋转中心，拟合结果与设定半径相差过大时直接使用 R 标
+  const coord::CTVec rel_target = ctv_w_target - plane_.origin;
+  const Eigen::Vector2d pt_target{rel_target.dot(plane_.axis_u), rel_target.dot(plane_.axis_v)};
+  circle_fitter_.Update(pt_target.x(), pt_target.y());
+  Eigen::Vector2d pt_center;
+  double radius;
+  if (!circle_fitter_.Solve(pt_center, radius) || std::abs(radius - radius_) > 0.2 * radius_) {
+    const coord::CTVec rel_center = ctv_w_center - plane_.origin;
+    pt_center = {rel_center.dot(plane_.axis_u), rel_center.dot(plane_.axis_v)};
+    radius = radius_;
+  }
+  const Eigen::Vector2d pt_radius = pt_target - pt_center;
+  const double angle = std::atan2(pt_radius.y(), pt_radius.x());
+  const double time = static_cast<double>(time_stamp_) * 1e-9;
+  rune_predictor_->Update(time, angle);
+
+  /// 预测弹丸到达时的靶心位置，飞行时间依赖于预测位置，因此迭代一次
+  const coord::CTVec ctv_w_fit_center = plane_.origin + pt_center.x() * plane_.axis_u + pt_center.y() * plane_.axis_v;
+  coord::CTVec ctv_w_predict = ctv_w_target;
+  double flight_time{};
+  for (int i = 0; i < 2; ++i) {
+    if (!Aim(ctv_w_predict, yaw_, pitch_, flight_time)) {
+      fire_ = false;
+      fire_controller_->Idle(time_stamp_);
+      return false;
+    }
+    const double predict_angle =
+        angle + rune_predictor_->Predict(time, delay_ + flight_time, mode_ == Mode::kBigRune);
+    ctv_w_predict = ctv_w_fit_center +
+                    radius * (std::cos(predict_angle) * plane_.axis_u + std::sin(predict_angle) * plane_.axis_v);
+  }
+  Aim(ctv_w_predict, yaw_, pitch_, flight_time);
+
+  /// 每片扇叶只需要击中一次，开火后等待扇叶切换
+  if (last_fire_ && time_stamp_ < last_fire_) {
+    last_fire_ = time_stamp_;
+  }
+  if (last_fire_ && static_cast<double>(time_stamp_ - last_fire_) * 1e-9 < fire_interval_) {
+    fire_ = false;
+    fire_controller_->Idle(time_stamp_);
+  } else {
+    const auto ea_self = coord::RMatToEAngle(rm_self_);
+    FireInput fire_input;
+    fire_input.time_stamp = time_stamp_;
+    fire_input.ctv_w_target = ctv_w_predict;
+    fire_input.target_width = target_size_;
+    fire_input.target_height = target_size_;
+    const double cos_facing = std::abs(normal.dot(ctv_w_predict.normalized()));
+    fire_input.facing_angle = static_cast<float>(std::acos(std::min(1.0, cos_facing)));
+    fire_input.pitch_lift = static_cast<float>(
+        pitch_ - std::atan2(-ctv_w_predict.y(), std::hypot(ctv_w_predict.x(), ctv_w_predict.z())));
+    fire_input.yaw_gimbal = static_cast<float>(ea_self.x());
+    fire_input.pitch_gimbal = static_cast<float>(ea_self.y());
+    fire_ = fire_controller_->Decide(fire_input);
+    if (fire_) {
+      last_fire_ = time_stamp_;
+    }
+  }
+
+  drawer_->DrawRuneFan(fan);
+  drawer_->DrawWorldPoint(ctv_w_predict);
+
+#ifdef DEBUG
+  SendViewerFrame();
+#endif
+
+  return true;
+}
+
+bool RuneAutoaim::Warmup(const cv::Size frame_size) {
+  RuneFanPtrList fan_list;
+  return rune_detector_->Run(cv::Mat::zeros(frame_size, PixelFormatType(pixel_format_)), pixel_format_, fan_list);
+}
+
+bool RuneAutoaim::SolveFan(RuneFanPtr REF_IN fan, coord::CTVec REF_OUT ctv_w_target, coord::CTVec REF_OUT ctv_w_center,
+                           coord::CTVec REF_OUT normal) const {
+  const auto half = static_cast<float>(target_size_ / 2);
+  static const std::vector<cv::Point3f> object_points = {
+      {-half, -half, 0}, {half, -half, 0}, {half, half, 0}, {-half, half, 0}};
+  const std::vector image_points(fan->pts.begin(), fan->pts.end());
+  cv::Mat rvec, tvec;
+  if (!cv::solvePnP(object_points, image_points, coord_solver_->IntrinsicMat(), coord_solver_->DistortionMat(), rvec,
+                    tvec, false, cv::SOLVEPNP_IPPE)) {
+    return false;
+  }
+  cv::Mat rm_cv;
+  cv::Rodrigues(rvec, rm_cv);
+  coord::RMat rm_cam;
+  coord::CTVec ctv_c_target;
+  cv::cv2eigen(rm_cv, rm_cam);
+  cv::cv2eigen(tvec, ctv_c_target);
+  const coord::CTVec normal_cam = rm_cam.col(2);
+
+  /// R 标的视线与能量机关平面求交得到中心位置
+  const coord::CTVec ray =
+      coord_solver_->intrinsic_mat_eigen().inverse() * coord::CTVec{fan->center.x, fan->center.y, 1};
+  const double denominator = normal_cam.dot(ray);
+  if (std::abs(denominator) < 1e-6) {
+    return false;
+  }
+  const coord::CTVec ctv_c_center = normal_cam.dot(ctv_c_target) / denominator * ray;
+
+  ctv_w_target = CamToWorld(ctv_c_target);
+  ctv_w_center = CamToWorld(ctv_c_center);
+  normal = (CamToWorld(ctv_c_target + normal_cam) - ctv_w_target).normalized();
+  /// PnP 得到的法向可能翻转，统一为指向相机一侧
+  if (const coord::CTVec ctv_w_cam = CamToWorld(coord::CTVec::Zero());
+      normal.dot(ctv_w_target - ctv_w_cam) > 0) {
+    normal = -normal;
+  }
+  return true;
+}
+
+bool RuneAutoaim::Aim(coord::CTVec REF_IN ctv_w, float REF_OUT yaw, float REF_OUT pitch,
+                      double REF_OUT flight_time) const {
+  /// 世界坐标系方向依次为右、下、前
+  const double distance = std::hypot(ctv_w.x(), ctv_w.z());
+  const double height = -ctv_w.y();
+  const double speed = bullet_speed_ * 1e3;
+  yaw = static_cast<float>(std::atan2(ctv_w.x(), ctv_w.z()));
+  /// 忽略空气阻力的抛物线模型，取低弹道解
+  const double speed2 = speed * speed;
+  const double discriminant = speed2 * speed2 - kGravity * (kGravity * distance * distance + 2 * height * speed2);
+  if (speed <= 0 || distance <= 0 || discriminant < 0) {
+    pitch = static_cast<float>(std::atan2(height, distance));
+    flight_time = 0;
+    return false;
+  }
+  const double theta = std::atan((speed2 - std::sqrt(discriminant)) / (kGravity * distance));
+  pitch = static_cast<float>(theta);
+  flight_time = distance / (speed * std::cos(theta));
+  return true;
+}
+
+bool RuneAutoaim::InitializeViewerImpl() {
+  return viewer_->Initialize(cfg.Get<std::string>({"viewer.web.shm_name", "bigrune"}),
+                             cfg.Get<int>({"viewer.web", "bigrune"}));
+}
+
+}  // namespace srm::autoaim
@@ -18,10 +18,10 @@ bool ArmorDetector::Initialize() {
     LOG(ERROR) << "Failed to load armor nerual network.";
     return false;
   }
-  return true;
+  return yolo_input_.Initialize(prefix);
 }
 
-bool ArmorDetector::Run(cv::Mat REF_IN image, ArmorPtrList REF_OUT armor_list) const {
+bool ArmorDetector::Run(cv::Mat REF_IN image, const PixelFormat pixel_format, ArmorPtrList REF_OUT armor_list) const {
   ///请补全
 
  // 原始配置文件的路径
@@ -65,7 +65,7 @@ bool ArmorDetector::Run(cv::Mat REF_IN image, ArmorPtrList REF_OUT armor_list) c
 
   //使用YOLO进行目标检测
   //运行神经网络检测
-  std::vector<srm::nn::Objects> detections = yolo_->Run(image);
+  std::vector<srm::nn::Objects> detections = yolo_input_.Run(*yolo_, image, pixel_format);
 
   for(const auto& obj : detections) {
     //置信度
@@ -91,6 +91,9 @@ bool ArmorDetector::Run(cv::Mat REF_IN image, ArmorPtrList REF_OUT armor_list) c
     //智能指针，用来储存灯泡信息
     ArmorPtr lamp = std::make_shared<Armor>(std::array<cv::Point2f, 4> {top_left,top_right,bottom_left,bottom_right}, lamp_color);
 
+    //记录置信度，供录制和回放比较
+    lamp->prob = obj.prob;
+
     //创建一个vector，用来返回信息
     armor_list.push_back(lamp);
   }
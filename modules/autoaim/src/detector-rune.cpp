@@ -0,0 +1,46 @@
+#include "srm/autoaim/detector-rune.h"
+
+namespace srm::autoaim {
+
+bool RuneDetector::Initialize() {
+  /// 初始化yolo
+#if defined(__APPLE__)
+  std::string net_type = "coreml";
+#elif defined(__linux__)
+  std::string net_type = "tensorrt";
+#endif
+  yolo_.reset(nn::CreateYolo(net_type));
+  std::string prefix = "nn.yolo.rune";
+  const auto model_path = cfg.Get<std::string>({prefix, net_type});
+  const auto class_num = cfg.Get<int>({prefix, "class_num"});
+  const auto point_num = cfg.Get<int>({prefix, "point_num"});
+  if (point_num != kPointNum) {
+    LOG(ERROR) << "Rune network should have " << kPointNum << " key points, but " << point_num << " is given.";
+    return false;
+  }
+  if (!yolo_->Initialize(model_path, class_num, point_num)) {
+    LOG(ERROR) << "Failed to load rune nerual network.";
+    return false;
+  }
+  min_prob_ = cfg.Get<float>({"autoaim.rune", "min_prob"});
+  return yolo_input_.Initialize(prefix);
+}
+
+bool RuneDetector::Run(cv::Mat REF_IN image, const PixelFormat pixel_format, RuneFanPtrList REF_OUT fan_list) const {
+  if (image.empty()) {
+    LOG(ERROR) << "Input image is empty.";
+    return false;
+  }
+  for (const auto &obj : yolo_input_.Run(*yolo_, image, pixel_format)) {
+    if (obj.prob < min_prob_ || obj.pts.size() != kPointNum) {
+      continue;
+    }
+    const auto color = obj.cls < 2 ? Color::kBlue : Color::kRed;
+    const bool activated = obj.cls % 2;
+    fan_list.push_back(std::make_shared<RuneFan>(std::array{obj.pts[0], obj.pts[1], obj.pts[2], obj.pts[3]},
+                                                 obj.pts[4], color, activated, obj.prob));
+  }
+  return true;
+}
+
+}  // namespace srm::autoaim
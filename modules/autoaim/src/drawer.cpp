@@ -2,30 +2,42 @@
 
 #include <fmt/format.h>
 
-#include <numeric>
-#include <opencv2/imgproc.hpp>
-
 #include "srm/autoaim/info.hpp"
 
 namespace srm::autoaim {
 
+bool Drawer::Enabled() const { return autoaim_->viewer_ && autoaim_->viewer_->Active(); }
+
 void Drawer::DrawArmor(ArmorPtr REF_IN armor) const {
-  std::stringstream armor_info;
-  // armor_info << color_id_map_.at(armor->color);
-  auto& image = autoaim_->image_;
+  if (!Enabled()) {
+    return;
+  }
+  auto& overlay = autoaim_->overlay_;
   const auto& points = armor->pts;
-  for (int j = 0; j < 4; j++) {
-    line(image, points[j], points[(j + 1) % 4], kGreen, 1);
+  overlay.polylines.push_back({{points.begin(), points.end()}, kGreen, 1, true});
+  overlay.circles.push_back({armor->Center(), 2, kGreen, 2});
+  overlay.texts.push_back({points[0], color_id_map_.at(armor->color), kGreen});
+}
+
+void Drawer::DrawRuneFan(RuneFanPtr REF_IN fan) const {
+  if (!Enabled()) {
+    return;
   }
-  const auto center = std::accumulate(points.begin(), points.end(), cv::Point2f(0, 0));
-  circle(image, center, 2, kGreen, 2);
+  auto& overlay = autoaim_->overlay_;
+  const auto& points = fan->pts;
+  overlay.polylines.push_back({{points.begin(), points.end()}, kYellow, 1, true});
+  overlay.polylines.push_back({{fan->Center(), fan->center}, kYellow, 1, false});
+  overlay.circles.push_back({fan->center, 4, kYellow, 2});
 }
 
 void Drawer::DrawWorldPoint(coord::CTVec REF_IN ctv_w_origin_x) const {
+  if (!Enabled()) {
+    return;
+  }
   const auto& solver = autoaim_->coord_solver_;
   const auto& rm_self = autoaim_->rm_self_;
   const cv::Point2f point_p_target_x = solver->CamToPic(solver->WorldToCam(ctv_w_origin_x, rm_self));
-  circle(autoaim_->image_, point_p_target_x, 2, kGreen, 2);
+  autoaim_->overlay_.circles.push_back({point_p_target_x, 2, kGreen, 2});
 }
 
 }  // namespace srm::autoaim
@@ -0,0 +1,124 @@
+#include "srm/autoaim/fire-controller.h"
+
+#include <cmath>
+#include <numbers>
+
+namespace srm::autoaim {
+
+namespace {
+
+/// 将角度差规范到 [-pi, pi)
+double WrapAngle(const double angle) {
+  return std::remainder(angle, 2 * std::numbers::pi);
+}
+
+/**
+ * @brief 正态分布落入区间 [-half_width, half_width] 的概率
+ * @param mean 误差均值
+ * @param sigma 误差标准差
+ * @param half_width 区间半宽
+ */
+double IntervalProbability(const double mean, const double sigma, const double half_width) {
+  if (sigma <= 0) {
+    return std::abs(mean) < half_width ? 1 : 0;
+  }
+  const double k = 1 / (sigma * std::numbers::sqrt2);
+  return 0.5 * (std::erf((half_width - mean) * k) + std::erf((half_width + mean) * k));
+}
+
+}  // namespace
+
+FireController::~FireController() {
+  if (statistics_.decisions) {
+    LOG(INFO) << "Fire control: " << statistics_.shots << " shots in " << statistics_.decisions
+              << " decisions, expected hit rate " << statistics_.ExpectedHitRate() << ", "
+              << statistics_.heat_limited << " shots limited by heat.";
+  }
+}
+
+bool FireController::Initialize() {
+  const std::string prefix = "autoaim.fire";
+  min_probability_ = cfg.Get<double>({prefix, "min_probability"});
+  dispersion_ = cfg.Get<double>({prefix, "dispersion"});
+  const auto armor_size = cfg.Get<std::vector<double>>({prefix, "armor_size"});
+  if (armor_size.size() != 2) {
+    LOG(ERROR) << "The size of " << prefix << ".armor_size should be 2.";
+    return false;
+  }
+  armor_width_ = armor_size[0];
+  armor_height_ = armor_size[1];
+  facing_window_ = cfg.Get<double>({prefix, "facing_window"}) * std::numbers::pi / 180;
+  heat_limit_ = cfg.Get<double>({prefix, "heat_limit"});
+  heat_per_shot_ = cfg.Get<double>({prefix, "heat_per_shot"});
+  cooling_rate_ = cfg.Get<double>({prefix, "cooling_rate"});
+  shoot_interval_ = cfg.Get<double>({prefix, "shoot_interval"});
+  return true;
+}
+
+double FireController::HitProbability(FireInput REF_IN input) const {
+  const double facing = std::abs(input.facing_angle);
+  if (facing >= facing_window_) {
+    return 0;
+  }
+  const double distance = input.ctv_w_target.norm();
+  if (distance <= 0) {
+    return 0;
+  }
+  /// 预测位置处目标的角半径，转过的装甲板在水平方向上投影变窄
+  const double width = input.target_width > 0 ? input.target_width : armor_width_;
+  const double height = input.target_height > 0 ? input.target_height : armor_height_;
+  const double half_yaw = std::atan2(0.5 * width * std::cos(facing), distance);
+  const double half_pitch = std::atan2(0.5 * height, distance);
+
+  /// 预测位置在垂直视线方向上的不确定度，换算为角度方差
+  const coord::CTVec los = input.ctv_w_target / distance;
+  const double lateral_var = std::max(0.0, input.cov_target.trace() - los.dot(input.cov_target * los)) / 2;
+  const double sigma = std::sqrt(dispersion_ * dispersion_ + lateral_var / (distance * distance));
+
+  /// 云台当前指向与命中预测位置所需指向的偏差，同时包含跟随误差和指令相对预测位置的滞后，世界坐标系方向依次为右、下、前
+  const double yaw_target = std::atan2(input.ctv_w_target.x(), input.ctv_w_target.z());
+  const double pitch_target =
+      std::atan2(-input.ctv_w_target.y(), std::hypot(input.ctv_w_target.x(), input.ctv_w_target.z())) +
+      input.pitch_lift;
+  const double error_yaw = WrapAngle(yaw_target - input.yaw_gimbal);
+  const double error_pitch = WrapAngle(pitch_target - input.pitch_gimbal);
+
+  return IntervalProbability(error_yaw, sigma, half_yaw) * IntervalProbability(error_pitch, sigma, half_pitch);
+}
+
+bool FireController::Decide(FireInput REF_IN input) {
+  Cool(input.time_stamp);
+  ++statistics_.decisions;
+  const double probability = HitProbability(input);
+  if (probability < min_probability_) {
+    return false;
+  }
+  /// 时间戳回退（如回放循环、相机重连）时以当前时间重新开始计算开火间隔，不能用无符号差值
+  if (last_shot_ && input.time_stamp < last_shot_) {
+    last_shot_ = input.time_stamp;
+    return false;
+  }
+  if (last_shot_ && static_cast<double>(input.time_stamp - last_shot_) * 1e-9 < shoot_interval_) {
+    return false;
+  }
+  if (heat_ + heat_per_shot_ > heat_limit_) {
+    ++statistics_.heat_limited;
+    return false;
+  }
+  heat_ += heat_per_shot_;
+  last_shot_ = input.time_stamp;
+  ++statistics_.shots;
+  statistics_.expected_hits += probability;
+  return true;
+}
+
+void FireController::Idle(const uint64_t time_stamp) { Cool(time_stamp); }
+
+void FireController::Cool(const uint64_t time_stamp) {
+  if (last_time_stamp_ && time_stamp > last_time_stamp_) {
+    heat_ = std::max(0.0, heat_ - cooling_rate_ * static_cast<double>(time_stamp - last_time_stamp_) * 1e-9);
+  }
+  last_time_stamp_ = time_stamp;
+}
+
+}  // namespace srm::autoaim
@@ -0,0 +1,65 @@
+#include "srm/autoaim/predictor-armor.h"
+
+#include <Eigen/LU>
+
+namespace srm::autoaim {
+
+bool ArmorPredictor::Initialize() {
+  const std::string prefix = "autoaim.armor";
+  acceleration_noise_ = cfg.Get<double>({prefix, "acceleration_noise"});
+  initial_speed_ = cfg.Get<double>({prefix, "initial_speed"});
+  lost_time_ = cfg.Get<double>({prefix, "lost_time"});
+  if (acceleration_noise_ <= 0 || initial_speed_ <= 0 || lost_time_ <= 0) {
+    LOG(ERROR) << "Invalid parameters of armor predictor.";
+    return false;
+  }
+  Reset();
+  return true;
+}
+
+void ArmorPredictor::Reset() {
+  initialized_ = false;
+  x_.setZero();
+  p_.setZero();
+}
+
+void ArmorPredictor::Update(const double time, coord::CTVec REF_IN position, Eigen::Matrix3d REF_IN cov) {
+  if (!initialized_ || time <= time_ || time - time_ > lost_time_) {
+    x_ << position, coord::CTVec::Zero();
+    p_.setZero();
+    p_.topLeftCorner<3, 3>() = cov;
+    p_.bottomRightCorner<3, 3>() = initial_speed_ * initial_speed_ * Eigen::Matrix3d::Identity();
+    initialized_ = true;
+    time_ = time;
+    return;
+  }
+  Propagate(time - time_, x_, p_);
+  time_ = time;
+
+  /// 观测矩阵只取位置，增益只需 3x3 求逆
+  const Eigen::Matrix3d s = p_.topLeftCorner<3, 3>() + cov;
+  const Eigen::Matrix<double, 6, 3> k = p_.leftCols<3>() * s.inverse();
+  x_ += k * (position - x_.head<3>());
+  p_ -= k * p_.topRows<3>();
+}
+
+void ArmorPredictor::Predict(const double duration, coord::CTVec REF_OUT position, Eigen::Matrix3d REF_OUT cov) const {
+  State x = x_;
+  StateCov p = p_;
+  Propagate(duration, x, p);
+  position = x.head<3>();
+  cov = p.topLeftCorner<3, 3>();
+}
+
+void ArmorPredictor::Propagate(const double dt, State REF_OUT x, StateCov REF_OUT p) const {
+  StateCov f = StateCov::Identity();
+  f.topRightCorner<3, 3>() = dt * Eigen::Matrix3d::Identity();
+  const double q = acceleration_noise_ * acceleration_noise_;
+  StateCov noise;
+  noise << q * dt * dt * dt * dt / 4 * Eigen::Matrix3d::Identity(), q * dt * dt * dt / 2 * Eigen::Matrix3d::Identity(),
+      q * dt * dt * dt / 2 * Eigen::Matrix3d::Identity(), q * dt * dt * Eigen::Matrix3d::Identity();
+  x = f * x;
+  p = f * p * f.transpose() + noise;
+}
+
+}  // namespace srm::autoaim
@@ -0,0 +1,126 @@
+#include "srm/autoaim/predictor-rune.h"
+
+#include <Eigen/Cholesky>
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+namespace srm::autoaim {
+
+void CircleFitter::Reset() {
+  weight_ = 0;
+  ata_.setZero();
+  atb_.setZero();
+}
+
+void CircleFitter::Update(const double x, const double y) {
+  const Eigen::Vector3d a{x, y, 1};
+  const double b = -(x * x + y * y);
+  ata_ = forgetting_ * ata_ + a * a.transpose();
+  atb_ = forgetting_ * atb_ + a * b;
+  weight_ = forgetting_ * weight_ + 1;
+}
+
+bool CircleFitter::Solve(Eigen::Vector2d REF_OUT center, double REF_OUT radius) const {
+  if (weight_ < 3) {
+    return false;
+  }
+  const auto ldlt = ata_.ldlt();
+  if (ldlt.info() != Eigen::Success || !ldlt.isPositive()) {
+    return false;
+  }
+  const Eigen::Vector3d def = ldlt.solve(atb_);
+  center = -0.5 * def.head<2>();
+  const double r2 = center.squaredNorm() - def.z();
+  if (r2 <= 0) {
+    return false;
+  }
+  radius = std::sqrt(r2);
+  return true;
+}
+
+bool RunePredictor::Initialize() {
+  const std::string prefix = "autoaim.rune";
+  small_speed_ = cfg.Get<double>({prefix, "small_speed"});
+  forgetting_ = cfg.Get<double>({prefix, "forgetting"});
+  min_samples_ = cfg.Get<int>({prefix, "min_samples"});
+  const auto omega_range = cfg.Get<std::vector<double>>({prefix, "big_omega"});
+  const auto model_num = cfg.Get<int>({prefix, "big_models"});
+  if (omega_range.size() != 2 || model_num < 1) {
+    LOG(ERROR) << "Invalid omega range or model number of big rune.";
+    return false;
+  }
+  models_.resize(model_num);
+  for (int i = 0; i < model_num; ++i) {
+    models_[i].omega =
+        model_num == 1 ? omega_range[0] : omega_range[0] + (omega_range[1] - omega_range[0]) * i / (model_num - 1);
+  }
+  Reset();
+  return true;
+}
+
+void RunePredictor::Reset() {
+  for (auto &model : models_) {
+    model.p = Eigen::Matrix3d::Identity() * 1e3;
+    model.x.setZero();
+    model.residual = 0;
+  }
+  has_last_ = false;
+  mean_speed_ = 0;
+  samples_ = 0;
+}
+
+void RunePredictor::Update(const double time, const double angle) {
+  if (!has_last_) {
+    has_last_ = true;
+    time_origin_ = time;
+    last_time_ = time;
+    last_angle_ = angle;
+    return;
+  }
+  const double dt = time - last_time_;
+  if (dt <= 0) {
+    return;
+  }
+  /// 击中后会切换到其他扇叶，相邻扇叶相差 72 度，因此按 72 度展开角度差
+  const double delta = std::remainder(angle - last_angle_, 2 * std::numbers::pi / 5);
+  const double speed = delta / dt;
+  const double t = 0.5 * (time + last_time_) - time_origin_;
+  last_time_ = time;
+  last_angle_ = angle;
+
+  mean_speed_ = samples_ ? 0.95 * mean_speed_ + 0.05 * speed : speed;
+  ++samples_;
+  for (auto &model : models_) {
+    const Eigen::Vector3d phi{std::sin(model.omega * t), std::cos(model.omega * t), 1};
+    const double error = speed - phi.dot(model.x);
+    const Eigen::Vector3d p_phi = model.p * phi;
+    const Eigen::Vector3d gain = p_phi / (forgetting_ + phi.dot(p_phi));
+    model.x += gain * error;
+    model.p = (model.p - gain * p_phi.transpose()) / forgetting_;
+    model.residual = 0.95 * model.residual + 0.05 * error * error;
+  }
+}
+
+const RunePredictor::SpeedModel &RunePredictor::BestModel() const {
+  return *std::ranges::min_element(models_, {}, &SpeedModel::residual);
+}
+
+double RunePredictor::Predict(const double time, const double duration, const bool big_rune) const {
+  if (!samples_) {
+    return 0;
+  }
+  if (!big_rune) {
+    return std::copysign(small_speed_, mean_speed_) * duration;
+  }
+  if (samples_ < min_samples_) {
+    return mean_speed_ * duration;
+  }
+  /// 对转速模型积分
+  const auto &[omega, p, x, residual] = BestModel();
+  const double t0 = time - time_origin_, t1 = t0 + duration;
+  return x[0] / omega * (std::cos(omega * t0) - std::cos(omega * t1)) +
+         x[1] / omega * (std::sin(omega * t1) - std::sin(omega * t0)) + x[2] * duration;
+}
+
+}  // namespace srm::autoaim
@@ -0,0 +1,40 @@
+#include "srm/autoaim/yolo-input.h"
+
+namespace srm::autoaim {
+
+bool YoloInput::Initialize(std::string REF_IN prefix) {
+  const auto input_size = cfg.Get<std::vector<int>>({prefix, "input_size"});
+  if (input_size.size() != 2 || input_size[0] <= 0 || input_size[1] <= 0) {
+    LOG(ERROR) << prefix << ".input_size should be [width, height].";
+    return false;
+  }
+  input_size_ = {input_size[0], input_size[1]};
+  return true;
+}
+
+std::vector<nn::Objects> YoloInput::Run(nn::Yolo &yolo, cv::Mat REF_IN image, const PixelFormat pixel_format) {
+  if (pixel_format == PixelFormat::kBgr8) {
+    return yolo.Run(image);
+  }
+  if (!IsBayer(pixel_format)) {
+    ToBgr(image, pixel_format, input_);
+    return yolo.Run(input_);
+  }
+  /// 输入已是网络大小，网络内部的信箱缩放不再改变图像，输出坐标在网络输入坐标系下
+  const auto letterbox = DemosaicLetterbox(image, pixel_format, input_size_, input_);
+  auto objects = yolo.Run(input_);
+  for (auto &obj : objects) {
+    const auto p1 = letterbox.ToSource({obj.x1, obj.y1});
+    const auto p2 = letterbox.ToSource({obj.x2, obj.y2});
+    obj.x1 = p1.x;
+    obj.y1 = p1.y;
+    obj.x2 = p2.x;
+    obj.y2 = p2.y;
+    for (auto &pt : obj.pts) {
+      pt = letterbox.ToSource(pt);
+    }
+  }
+  return objects;
+}
+
+}  // namespace srm::autoaim
@@ -2,8 +2,10 @@
 #define SRM_COMMON_HPP_
 
 #include "srm/common/buffer.hpp"
+#include "srm/common/clock-sync.hpp"
 #include "srm/common/config.hpp"
 #include "srm/common/factory.hpp"
+#include "srm/common/image-format.hpp"
 #include "srm/common/tags.hpp"
 
 #endif  // SRM_COMMON_HPP_
\ No newline at end of file
@@ -0,0 +1,212 @@
+#ifndef SRM_COMMON_CLOCK_SYNC_HPP_
+#define SRM_COMMON_CLOCK_SYNC_HPP_
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <mutex>
+
+namespace srm {
+
+/**
+ * @brief 将外部时钟映射到本机单调时钟
+ * @details
+ * 每收到一个 (外部时间, 本机时间) 时间对就做一次带遗忘因子的在线线性回归 host = slope * remote + offset，
+ * slope 反映两个时钟的频率漂移，offset 包含时钟零点之差和平均传输延迟。
+ * 稳定后残差超过 gate 倍标准差的时间对视为异常（如取图或链路的偶发延迟）而丢弃，
+ * 外部时钟回退，或相邻两个时间对的外部时间差与本机时间差相差超过 jump 时，认为外部时钟已跳变（如下位机重启、
+ * 相机重新打开），立即以当前时间对重新开始估计；连续被拒绝的次数超过 warmup 时同样重新开始估计。
+ * 所有时间单位均为 ns，可在多个线程中同时使用。
+ */
+class ClockSync final {
+ public:
+  /**
+   * @param forgetting 遗忘因子，0 到 1，越接近 1 估计越平滑、跟踪漂移越慢
+   * @param gate 异常值门限，单位为残差标准差
+   * @param gate_floor 异常值门限的下限，单位 ns，防止残差很小时拒绝所有时间对
+   * @param warmup 开始拒绝异常值和对外提供转换前需要的时间对数量
+   * @param jump 判定外部时钟跳变的门限，单位 ns，应远大于传输延迟的抖动
+   */
+  explicit ClockSync(const double forgetting = 0.995, const double gate = 4, const double gate_floor = 1e6,
+                     const int warmup = 16, const double jump = 1e9)
+      : forgetting_(forgetting), gate_(gate), gate_floor_(gate_floor), warmup_(warmup), jump_(jump) {}
+
+  /**
+   * @brief 加入一个时间对
+   * @param remote 外部时钟时间
+   * @param host 同一时刻的本机单调时钟时间
+   * @return 是否被采纳
+   */
+  bool Update(const int64_t remote, const int64_t host) {
+    std::lock_guard lock{lock_};
+    const double step = static_cast<double>(remote - last_remote_) - static_cast<double>(host - last_host_);
+    if (count_ && (remote < last_remote_ || std::abs(step) > jump_)) {
+      Clear();
+    }
+    last_remote_ = remote;
+    last_host_ = host;
+    if (!count_) {
+      remote_origin_ = remote;
+      host_origin_ = host;
+    }
+    const double x = static_cast<double>(remote - remote_origin_);
+    const double y = static_cast<double>(host - host_origin_);
+    if (count_ >= warmup_) {
+      const double residual = y - Predict(x);
+      if (std::abs(residual) > std::max(gate_floor_, gate_ * std::sqrt(variance_))) {
+        if (++rejected_ > warmup_) {
+          Clear();
+        }
+        return false;
+      }
+      variance_ = forgetting_ * variance_ + (1 - forgetting_) * residual * residual;
+    }
+    rejected_ = 0;
+
+    /// 带遗忘因子的加权均值和协方差，以均值为中心计算，避免大数相减损失精度
+    weight_ = forgetting_ * weight_ + 1;
+    const double dx = x - mean_x_;
+    mean_x_ += dx / weight_;
+    mean_y_ += (y - mean_y_) / weight_;
+    cov_xx_ = forgetting_ * cov_xx_ + dx * (x - mean_x_);
+    cov_xy_ = forgetting_ * cov_xy_ + dx * (y - mean_y_);
+    if (cov_xx_ > 0) {
+      slope_ = cov_xy_ / cov_xx_;
+    }
+    ++count_;
+    return true;
+  }
+
+  /// 清空估计，外部时钟已知会跳变时（如重新打开设备）由调用者调用
+  void Reset() {
+    std::lock_guard lock{lock_};
+    Clear();
+  }
+
+  /// 是否已有足够的时间对，可以进行转换
+  [[nodiscard]] bool Ready() const {
+    std::lock_guard lock{lock_};
+    return count_ >= warmup_ && cov_xx_ > 0;
+  }
+
+  /// 外部时钟时间转换为本机单调时钟时间
+  [[nodiscard]] int64_t ToHost(const int64_t remote) const {
+    std::lock_guard lock{lock_};
+    return host_origin_ + std::llround(Predict(static_cast<double>(remote - remote_origin_)));
+  }
+
+  /// 本机单调时钟时间转换为外部时钟时间
+  [[nodiscard]] int64_t ToRemote(const int64_t host) const {
+    std::lock_guard lock{lock_};
+    const double y = static_cast<double>(host - host_origin_);
+    return remote_origin_ + std::llround(mean_x_ + (y - mean_y_) / slope_);
+  }
+
+  /// 外部时钟相对本机的频率漂移，单位 ppm
+  [[nodiscard]] double Drift() const {
+    std::lock_guard lock{lock_};
+    return (slope_ - 1) * 1e6;
+  }
+
+  /// 残差标准差，单位 ns
+  [[nodiscard]] double Jitter() const {
+    std::lock_guard lock{lock_};
+    return std::sqrt(variance_);
+  }
+
+ private:
+  /// 按当前估计计算相对原点的本机时间
+  [[nodiscard]] double Predict(const double x) const { return mean_y_ + slope_ * (x - mean_x_); }
+
+  /// 清空估计，调用时须持有 lock_
+  void Clear() {
+    count_ = rejected_ = 0;
+    weight_ = mean_x_ = mean_y_ = cov_xx_ = cov_xy_ = variance_ = 0;
+    slope_ = 1;
+  }
+
+  double forgetting_;  ///< 遗忘因子
+  double gate_;        ///< 异常值门限
+  double gate_floor_;  ///< 异常值门限下限
+  int warmup_;         ///< 预热所需的时间对数量
+  double jump_;        ///< 跳变门限
+
+  mutable std::mutex lock_;  ///< 估计的锁
+  int64_t remote_origin_{};  ///< 外部时钟原点
+  int64_t host_origin_{};    ///< 本机时钟原点
+  int64_t last_remote_{};    ///< 上一个时间对的外部时间
+  int64_t last_host_{};      ///< 上一个时间对的本机时间
+  int count_{};              ///< 已采纳的时间对数量
+  int rejected_{};           ///< 连续被拒绝的时间对数量
+  double weight_{};          ///< 总权重
+  double mean_x_{};          ///< 外部时间加权均值
+  double mean_y_{};          ///< 本机时间加权均值
+  double cov_xx_{};          ///< 外部时间加权方差
+  double cov_xy_{};          ///< 加权协方差
+  double slope_{1};          ///< 频率比
+  double variance_{};        ///< 残差方差
+};
+
+/**
+ * @brief 统一时间基准
+ * @details
+ * 以本机单调时钟为基准，相机时间戳和下位机时间戳分别由各自的 ClockSync 映射过来。
+ * IMU 插值、延迟补偿和录制都应先换算到本机时钟再比较。
+ */
+class TimeBase final {
+ public:
+  /**
+   * @brief 获取 TimeBase 类唯一实例
+   * @return 唯一实例的引用
+   */
+  static TimeBase &Instance() {
+    static TimeBase time_base;
+    return time_base;
+  }
+
+  /// 当前时间，本机单调时钟，单位 ns
+  static uint64_t Now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+
+  /**
+   * @brief 相机时间戳转换为本机时钟
+   * @param time_stamp 帧时间戳，即相机计数乘以 SetTimeStampNS 设定的单位
+   * @param fallback 尚未完成同步时返回的值
+   */
+  [[nodiscard]] uint64_t CameraToHost(const uint64_t time_stamp, const uint64_t fallback) const {
+    return camera.Ready() ? static_cast<uint64_t>(camera.ToHost(static_cast<int64_t>(time_stamp))) : fallback;
+  }
+
+  /**
+   * @brief 下位机时间戳转换为本机时钟
+   * @param time_stamp 下位机时间戳，单位 ns
+   * @param fallback 尚未完成同步时返回的值
+   */
+  [[nodiscard]] uint64_t McuToHost(const uint64_t time_stamp, const uint64_t fallback) const {
+    return mcu.Ready() ? static_cast<uint64_t>(mcu.ToHost(static_cast<int64_t>(time_stamp))) : fallback;
+  }
+
+  /**
+   * @brief 本机时钟转换为下位机时间戳
+   * @param time_stamp 本机时钟，单位 ns
+   * @param fallback 尚未完成同步时返回的值
+   */
+  [[nodiscard]] uint64_t HostToMcu(const uint64_t time_stamp, const uint64_t fallback) const {
+    return mcu.Ready() ? static_cast<uint64_t>(mcu.ToRemote(static_cast<int64_t>(time_stamp))) : fallback;
+  }
+
+  ClockSync camera;  ///< 主相机时钟，每帧以回调时刻更新
+  ClockSync mcu;     ///< 下位机时钟，每次收到带时间戳的数据时更新
+
+ private:
+  TimeBase() = default;
+};
+
+inline TimeBase &time_base = TimeBase::Instance();  ///< 统一时间基准的全局变量
+
+}  // namespace srm
+
+#endif  // SRM_COMMON_CLOCK_SYNC_HPP_
@@ -147,7 +147,7 @@ class Config final {
   Config() = default;
   ~Config() {
     stop_flag_ = true;
-    if (thread_->joinable()) {
+    if (thread_ && thread_->joinable()) {
       thread_->join();
     }
   }
@@ -3,5 +3,8 @@
 
 #include "srm/core/core-base.h"
 #include "srm/core/fps-controller.h"
+#include "srm/core/message-service.h"
+#include "srm/core/send-scheduler.h"
+#include "srm/core/shadow-autoaim.h"
 
 #endif  // SRM_CORE_HPP_
@@ -5,6 +5,9 @@
 #include "srm/common.hpp"
 #include "srm/coord.hpp"
 #include "srm/core/fps-controller.h"
+#include "srm/core/message-service.h"
+#include "srm/core/send-scheduler.h"
+#include "srm/core/shadow-autoaim.h"
 #include "srm/message.hpp"
 #include "srm/nn.hpp"
 #include "srm/video.hpp"
@@ -40,19 +43,117 @@ class BaseCore {
   virtual int Run() = 0;
 
  protected:
-  video::Frame frame_;                             ///< 帧数据
-  std::unique_ptr<video::Reader> reader_;          ///< 视频读入接口
-  std::unique_ptr<video::Writer> writer_;          ///< 视频写出接口
-  std::shared_ptr<message::BaseMessage> message_;  ///< 串口收发接口
-  std::shared_ptr<coord::Solver> solver_;          ///< 坐标求解接口
-  std::unique_ptr<FpsController> fps_controller_;  ///< 帧率控制器
-  std::shared_ptr<autoaim::BaseAutoaim> autoaim_;  ///< 自瞄接口
+  video::Frame frame_;                               ///< 帧数据
+  PixelFormat pixel_format_{};                       ///< 帧图像的像素格式，已考虑倒装翻转
+  std::unique_ptr<video::Reader> reader_;            ///< 视频读入接口
+  std::unique_ptr<video::AdaptiveWriter> writer_;    ///< 视频写出接口
+  std::unique_ptr<video::Recorder> recorder_;        ///< 会话录制接口，未启用时为空
+  std::unique_ptr<video::RawDumpWriter> raw_dump_;   ///< 原始帧转储接口，未启用时为空
+  std::shared_ptr<message::BaseMessage> message_;    ///< 串口收发接口
+  std::unique_ptr<MessageService> message_service_;  ///< 通信接收服务，未连接控制程序时为空
+  std::unique_ptr<SendScheduler> send_scheduler_;    ///< 设定值发送调度器，未启用时为空
+  std::shared_ptr<coord::Solver> solver_;            ///< 坐标求解接口
+  std::unique_ptr<FpsController> fps_controller_;    ///< 帧率控制器
+  std::shared_ptr<autoaim::BaseAutoaim> autoaim_;    ///< 自瞄接口
+  std::unique_ptr<ShadowAutoaim> shadow_;            ///< 后台影子自瞄，未启用时为空
 
-  std::unordered_map<autoaim::Mode, std::shared_ptr<autoaim::BaseAutoaim>> autoaim_registry_;  ///< 将模式与自瞄绑定
+  /// 模式到自瞄的映射
+  using AutoaimRegistry = std::unordered_map<autoaim::Mode, std::shared_ptr<autoaim::BaseAutoaim>>;
+  AutoaimRegistry autoaim_registry_;      ///< 将模式与自瞄绑定
+  std::atomic_bool has_sync_data_{true};  ///< 上一帧是否有同步数据，用于只在状态变化时打印警告
+
+  /**
+   * @brief 根据当前帧的同步数据选择自瞄并传入参数
+   * @return 当前帧是否有可用的同步数据
+   */
+  bool SetAutoaim();
+
+  /**
+   * @brief 将当前帧与自瞄输出一起录制到会话或原始帧转储中
+   * @param [in] image 通过 recorder_->Snapshot 得到的图像副本，为空时不写入会话（未启用或 Reserve 失败）
+   */
+  void RecordFrame(cv::Mat FWD_IN image) const;
+
+  /**
+   * @brief 等待视频源输出第一帧
+   * @param [in] reader 已初始化的视频源
+   * @param [out] frame 第一帧
+   * @param [in] name 视频源名称，用于日志
+   * @return 是否得到第一帧，等待期间收到退出信号时返回 false
+   */
+  static bool WaitFirstFrame(video::Reader &reader, video::Frame REF_OUT frame, std::string REF_IN name);
+
+  /**
+   * @brief 将帧的同步数据和图像传入自瞄
+   * @param [in] frame 带同步数据的帧
+   * @param [out] autoaim 目标自瞄
+   */
+  static void FeedAutoaim(video::Frame REF_IN frame, autoaim::BaseAutoaim &autoaim);
+
+  /**
+   * @brief 将自瞄识别到的目标交给视频源作为自动曝光的统计区域，只对 managed 视频源有效
+   * @param reader 视频源
+   * @param [in] targets 本帧识别到的目标，为空时自动曝光保持不变
+   */
+  static void UpdateExposureTargets(video::Reader *reader, autoaim::ArmorPtrList REF_IN targets);
+
+  /**
+   * @brief 发送云台指令，启用发送调度时只更新调度器的目标
+   * @param time_stamp 指令所依据的帧的时刻，本机单调时钟，单位 ns，见 HostTimeStamp
+   * @param yaw 目标 yaw 角度
+   * @param pitch 目标 pitch 角度
+   * @param fire 是否开火
+   */
+  void SendCommand(uint64_t time_stamp, float yaw, float pitch, bool fire) const;
+
+  /**
+   * @brief 将帧的相机时间戳换算为本机单调时钟，不受取图后处理耗时的影响
+   * @param [in] frame 帧数据
+   * @param [in] clock 该视频源的相机时钟
+   * @return 本机时间，单位 ns，时钟同步尚未就绪时为当前时刻
+   */
+  static uint64_t HostTimeStamp(video::Frame REF_IN frame, ClockSync REF_IN clock);
+
+  /**
+   * @brief 创建帧回调，在取图后立即按时间查询同步数据，未连接控制程序时使用模拟数据
+   * @param [in] clock 该视频源的相机时钟，每个相机的时钟相互独立，须在回调的整个生命周期内有效
+   * @return 帧回调，注册到各个视频源
+   */
+  video::FrameCallback CreateSyncCallback(ClockSync &clock);
+
+  /**
+   * @brief 视频源重新打开相机后重置其相机时钟的同步估计，只对 managed 视频源有效
+   * @param reader 视频源
+   * @param [in] clock 该视频源的相机时钟，须在视频源的整个生命周期内有效
+   */
+  static void ResetClockOnReopen(video::Reader *reader, ClockSync &clock);
+
+  /**
+   * @brief 为一个相机创建所有模式的自瞄并完成预热
+   * @param [in] solver 该相机的坐标求解器
+   * @param frame_size 该相机的图像大小
+   * @param pixel_format 该相机的像素格式
+   * @param viewer 是否启用图像显示接口，各自瞄的共享内存和端口由配置固定，多个相机不能同时启用
+   * @param [out] registry 模式到自瞄的映射
+   * @return 是否创建成功
+   */
+  static bool CreateAutoaimRegistry(std::shared_ptr<coord::Solver> REF_IN solver, cv::Size frame_size,
+                                    PixelFormat pixel_format, bool viewer, AutoaimRegistry REF_OUT registry);
+
+  /**
+   * @brief 读取视频源的像素格式，并检查第一帧与之相符
+   * @param [in] prefix 视频源配置路径，raw 视频源的像素格式取自转储文件头，不读取配置
+   * @param [in] reader 视频源
+   * @param [in] frame 视频源的第一帧
+   * @param [out] pixel_format 像素格式
+   * @return 是否读取成功
+   */
+  static bool ReadPixelFormat(std::string REF_IN prefix, video::Reader REF_IN reader, video::Frame REF_IN frame,
+                              PixelFormat REF_OUT pixel_format);
 
- private:
   virtual bool InitializeReader();
   virtual bool InitializeWriter();
+  virtual bool InitializeRecorder();
   virtual bool InitializeMessage();
   virtual bool InitializeSolver();
   virtual bool InitializeAutoaim();
@@ -0,0 +1,71 @@
+#ifndef SRM_CORE_MESSAGE_SERVICE_H_
+#define SRM_CORE_MESSAGE_SERVICE_H_
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "srm/message.hpp"
+
+namespace srm::core {
+
+/**
+ * @brief 通信接收服务
+ * @details
+ * 在独立线程中以链路速率持续接收下位机数据，保存带时间戳的最新值和一段姿态历史。
+ * 相机回调只按时间戳查询，不再直接读写链路，链路的延迟抖动不会影响取图。
+ * 时间戳均为本机单调时钟，单位 ns；ring 和 serial 使用收到数据时的时间戳，control 使用读出数据的时间。
+ * 下位机发送 McuTime 时，以其与接收时刻同步下位机时钟，并改用换算后的下位机采样时刻，消除链路延迟中变化的部分；
+ * 平均延迟无法与时钟零点之差区分，仍包含在换算结果中，可调整 frame_delay 一并补偿。
+ */
+class MessageService final {
+ public:
+  /// 一次接收到的数据
+  struct Sample {
+    uint64_t time_stamp;             ///< 接收时间
+    message::ReiceivePacket packet;  ///< 合并的接收数据
+  };
+
+  /**
+   * @param message 已初始化并注册好数据包的通信接口
+   * @param history_size 保存的历史数据条数
+   * @param period 链路不支持等待时的轮询间隔
+   * @param timed 下位机是否发送 McuTime
+   */
+  MessageService(std::shared_ptr<message::BaseMessage> message, size_t history_size, std::chrono::nanoseconds period,
+                 bool timed);
+  ~MessageService();
+
+  /**
+   * @brief 查询某一时刻的接收数据，不会阻塞
+   * @details 姿态在前后两次接收之间线性插值，yaw 按最短角距离插值，其余数据取该时刻之前最近的一次
+   * @param time_stamp 查询时刻，本机单调时钟，单位 ns
+   * @param [out] packet 查询结果
+   * @param max_age 最近一次数据距查询时刻的最大间隔，超过时视为链路中断；查询时刻早于全部历史时也以此判断
+   * @return 是否查询到有效数据
+   */
+  bool Lookup(uint64_t time_stamp, message::ReiceivePacket &packet, std::chrono::nanoseconds max_age) const;
+
+ private:
+  /// 接收线程
+  void Loop();
+
+  std::shared_ptr<message::BaseMessage> message_;  ///< 通信接口
+  message::LinkMessage *link_;                     ///< 通信接口支持等待时不为空
+  std::chrono::nanoseconds period_;                ///< 轮询间隔
+  bool timed_;                                     ///< 下位机是否发送 McuTime
+
+  mutable std::mutex lock_;       ///< 历史数据的锁
+  std::vector<Sample> history_;   ///< 历史数据，环形存放
+  size_t head_{};                 ///< 下一条数据写入的位置
+  size_t count_{};                ///< 历史数据条数
+  std::atomic_bool stop_flag_{};  ///< 线程停止信号
+  std::thread thread_;            ///< 接收线程
+};
+
+}  // namespace srm::core
+
+#endif  // SRM_CORE_MESSAGE_SERVICE_H_
@@ -0,0 +1,68 @@
+#ifndef SRM_CORE_SEND_SCHEDULER_H_
+#define SRM_CORE_SEND_SCHEDULER_H_
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "srm/message.hpp"
+
+namespace srm::core {
+
+/**
+ * @brief 云台设定值发送调度器
+ * @details
+ * 视觉主循环每处理完一帧只调用 Update 更新目标角度，由此估计角速度；
+ * 调度线程以固定的控制频率按角速度外推出当前时刻的设定值并发送，下位机收到的设定值不再随帧率阶跃。
+ * 外推时长不超过 horizon，视觉输出中断时设定值停在最后一次的外推位置，并停止开火。
+ * 目标丢失时自瞄输出的 0/0 不参与角速度估计，原样发送。yaw 按 ±pi 回绕计算角速度和外推。
+ * 设定值的时间戳换算为下位机时钟，下位机可据此补偿链路延迟。
+ */
+class SendScheduler final {
+ public:
+  /**
+   * @param message 已初始化并注册 GimbalSetpoint 和 ShootSend 的通信接口
+   * @param rate 发送频率，单位 Hz
+   * @param horizon 最长外推时长
+   * @param smoothing 角速度低通滤波系数，0 到 1，越大越平滑
+   */
+  SendScheduler(std::shared_ptr<message::BaseMessage> message, double rate, std::chrono::nanoseconds horizon,
+                float smoothing);
+  ~SendScheduler();
+
+  /**
+   * @brief 更新目标角度，不会阻塞
+   * @param time_stamp 目标角度所依据的帧的时刻，本机单调时钟，单位 ns，不应使用处理完成的时刻
+   * @param yaw 目标 yaw 角度
+   * @param pitch 目标 pitch 角度
+   * @param fire 是否开火
+   */
+  void Update(uint64_t time_stamp, float yaw, float pitch, bool fire);
+
+ private:
+  /// 调度线程
+  void Loop();
+
+  std::shared_ptr<message::BaseMessage> message_;  ///< 通信接口
+  std::chrono::nanoseconds period_;                ///< 发送周期
+  std::chrono::nanoseconds horizon_;               ///< 最长外推时长
+  float smoothing_;                                ///< 角速度滤波系数
+
+  std::mutex lock_;               ///< 目标模型的锁
+  bool valid_{};                  ///< 是否收到过目标角度
+  bool tracking_{};               ///< 最近一次是否有目标，目标丢失时不估计角速度
+  uint64_t time_stamp_{};         ///< 最近一次目标角度对应的时刻
+  float yaw_{};                   ///< 最近一次目标 yaw 角度
+  float pitch_{};                 ///< 最近一次目标 pitch 角度
+  float yaw_velocity_{};          ///< yaw 角速度估计
+  float pitch_velocity_{};        ///< pitch 角速度估计
+  bool fire_{};                   ///< 最近一次开火指令
+  std::atomic_bool stop_flag_{};  ///< 线程停止信号
+  std::thread thread_;            ///< 调度线程
+};
+
+}  // namespace srm::core
+
+#endif  // SRM_CORE_SEND_SCHEDULER_H_
@@ -0,0 +1,64 @@
+#ifndef SRM_CORE_SHADOW_AUTOAIM_H_
+#define SRM_CORE_SHADOW_AUTOAIM_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "srm/autoaim.hpp"
+#include "srm/video.hpp"
+
+namespace srm::core {
+
+/**
+ * @brief 后台影子自瞄
+ * @details
+ * 在独立线程中以较低频率用真实帧运行一个当前未启用的自瞄模式，使其跟踪、拟合等状态保持预热，
+ * 裁判系统切换模式时无需再等待若干帧建立状态。主循环只做非阻塞的提交，影子线程忙碌时直接丢帧。
+ */
+class ShadowAutoaim final {
+ public:
+  /**
+   * @param autoaim 需要保持预热的自瞄
+   * @param mode 运行该自瞄时使用的模式
+   * @param interval 每隔多少帧提交一次
+   */
+  ShadowAutoaim(std::shared_ptr<autoaim::BaseAutoaim> autoaim, autoaim::Mode mode, int interval);
+  ~ShadowAutoaim();
+
+  /**
+   * @brief 提交一帧，未到间隔、影子自瞄正在被主循环使用或线程忙碌时直接丢弃
+   * @param [in] frame 帧数据
+   * @param [in] active 主循环当前使用的自瞄
+   */
+  void Submit(video::Frame REF_IN frame, std::shared_ptr<autoaim::BaseAutoaim> REF_IN active);
+
+  /**
+   * @brief 主循环选定自瞄后、运行前调用，防止与影子线程同时运行同一个自瞄
+   * @details
+   * active 就是影子自瞄时暂停影子线程，只在切换后的第一帧等待影子线程正在进行的一次运行结束，
+   * 之后主循环不再与影子线程争用；切换到其他模式后恢复影子线程。
+   * @param [in] active 主循环当前使用的自瞄
+   */
+  void Activate(std::shared_ptr<autoaim::BaseAutoaim> REF_IN active);
+
+ private:
+  std::shared_ptr<autoaim::BaseAutoaim> autoaim_;  ///< 影子自瞄
+  autoaim::Mode mode_;                             ///< 影子自瞄的模式
+  int interval_;                                   ///< 提交间隔帧数
+  int counter_{};                                  ///< 提交计数
+
+  std::mutex autoaim_lock_;           ///< 影子自瞄的运行锁
+  std::mutex frame_lock_;             ///< 待处理帧的锁
+  std::condition_variable frame_cv_;  ///< 待处理帧的通知
+  video::Frame frame_;                ///< 待处理帧
+  bool pending_{};                    ///< 是否有待处理帧
+  std::atomic_bool suspended_{};      ///< 主循环正在使用影子自瞄，影子线程暂停
+  std::atomic_bool stop_flag_{};      ///< 线程停止信号
+  std::thread thread_;                ///< 影子线程
+};
+
+}  // namespace srm::core
+
+#endif  // SRM_CORE_SHADOW_AUTOAIM_H_
@@ -1,3 +1,4 @@
+#include <cstring>
 #include <memory>
 
 #include "srm/core.hpp"
@@ -12,13 +13,13 @@ bool BaseCore::InitializeReader() {
     LOG(ERROR) << "Failed to create " << reader_type << " reader.";
     return false;
   }
-  if (!reader_->Initialize("video." + type + "." + reader_type)) {
+  const auto prefix = "video." + type + "." + reader_type;
+  if (!reader_->Initialize(prefix)) {
     LOG(ERROR) << "Failed to initialize reader.";
     return false;
   }
-  while (!reader_->GetFrame(frame_)) {
-    LOG(WARNING) << "Waiting for the first frame frome video.";
-    sleep(1);
+  if (!WaitFirstFrame(*reader_, frame_, reader_type) || !ReadPixelFormat(prefix, *reader_, frame_, pixel_format_)) {
+    return false;
   }
   LOG(INFO) << "Reader is initialized successfully.";
   return true;
@@ -32,11 +33,14 @@ bool BaseCore::InitializeWriter() {
     LOG(INFO) << "Writer do not need initialization.";
     return true;
   }
-  writer_ = std::make_unique<video::Writer>();
+  writer_ = std::make_unique<video::AdaptiveWriter>();
   using std::chrono::system_clock;
   const auto t_str = std::format("{:%Y-%m-%d-%H.%M.%S}", system_clock::now());
+  const std::string prefix = "writer";
   if (!writer_->Open(std::format("../cache/{}-{}.avi", cfg.Get<std::string>({"type"}), t_str),
-                     {frame_.image.cols, frame_.image.rows})) {
+                     {frame_.image.cols, frame_.image.rows}, cfg.Get<double>({prefix, "fps"}),
+                     static_cast<size_t>(cfg.Get<int>({prefix, "memory_budget"})) << 20,
+                     cfg.Get<int>({prefix, "decimation"}))) {
     LOG(ERROR) << "Failed to open video file. Please check your disk space.";
     return false;
   }
@@ -44,39 +48,111 @@ bool BaseCore::InitializeWriter() {
   return true;
 }
 
+bool BaseCore::InitializeRecorder() {
+  if (!reader_) {
+    return false;
+  }
+  const std::string prefix = "recorder";
+  if (!cfg.Get<bool>({prefix, "enable"})) {
+    LOG(INFO) << "Recorder do not need initialization.";
+    return true;
+  }
+  const auto format_str = cfg.Get<std::string>({prefix, "format"});
+  if (format_str != "jpeg" && format_str != "raw" && format_str != "dump") {
+    LOG(ERROR) << "Unknown image format " << format_str << " for recorder.";
+    return false;
+  }
+  using std::chrono::system_clock;
+  const auto t_str = std::format("{:%Y-%m-%d-%H.%M.%S}", system_clock::now());
+  const auto file_prefix = std::format("../cache/{}-{}", cfg.Get<std::string>({"type"}), t_str);
+  if (format_str == "dump") {
+    raw_dump_ = std::make_unique<video::RawDumpWriter>();
+    const auto session_file = cfg.Get<bool>({prefix, "dump_compress"}) ? file_prefix + ".srms" : std::string{};
+    if (!raw_dump_->Open(file_prefix + ".srmd", frame_.image.size(), pixel_format_,
+                         static_cast<uint64_t>(cfg.Get<int>({prefix, "dump_budget"})) << 20, session_file,
+                         cfg.Get<int>({prefix, "quality"}))) {
+      LOG(ERROR) << "Failed to open raw dump file. Please check your disk space.";
+      return false;
+    }
+    LOG(INFO) << "Recorder is initialized successfully.";
+    return true;
+  }
+  const auto format = format_str == "jpeg" ? video::SessionImageFormat::kJpeg : video::SessionImageFormat::kRaw;
+  recorder_ = std::make_unique<video::Recorder>();
+  if (!recorder_->Open(file_prefix + ".srms",
+                       {frame_.image.cols, frame_.image.rows}, format, cfg.Get<int>({prefix, "quality"}),
+                       cfg.Get<int>({prefix, "workers"}), cfg.Get<int>({prefix, "queue_size"}),
+                       cfg.Get<int>({prefix, "chunk_size"}) << 20)) {
+    LOG(ERROR) << "Failed to open session file. Please check your disk space.";
+    return false;
+  }
+  LOG(INFO) << "Recorder is initialized successfully.";
+  return true;
+}
+
 bool BaseCore::InitializeMessage() {
   if (!reader_) {
     return false;
   }
   if (cfg.Get<bool>({"control"})) {
-    message_.reset(message::CreateMessage("control"));
-    if (!message_->Initialize()) {
-      LOG(ERROR) << "Failed to open shared memory communication.";
+    const auto message_type = cfg.Get<std::string>({"message.type"});
+    message_.reset(message::CreateMessage(message_type));
+    if (!message_ || !message_->Initialize()) {
+      LOG(ERROR) << "Failed to initialize " << message_type << " communication.";
       return false;
     }
     std::string prefix = "message.control";
     message_->ReceiveRegister<message::GimbalReceive>(cfg.Get<short>({prefix, "receive.gimbal"}));
     message_->ReceiveRegister<message::ShootReceive>(cfg.Get<short>({prefix, "receive.shoot"}));
-    message_->SendRegister<message::GimbalSend>(cfg.Get<short>({prefix, "send.gimbal"}));
+    const auto time_id = cfg.Get<short>({prefix, "receive.time"});
+    const bool timed = time_id != 0;
+    if (timed) {
+      message_->ReceiveRegister<message::McuTime>(time_id);
+    }
+    const auto send_rate = cfg.Get<double>({"message.scheduler", "rate"});
+    if (send_rate > 0) {
+      message_->SendRegister<message::GimbalSetpoint>(cfg.Get<short>({prefix, "send.setpoint"}));
+    } else {
+      message_->SendRegister<message::GimbalSend>(cfg.Get<short>({prefix, "send.gimbal"}));
+    }
     message_->SendRegister<message::ShootSend>(cfg.Get<short>({prefix, "send.shoot"}));
     message_->Connect(true);
+    if (send_rate > 0) {
+      send_scheduler_ = std::make_unique<SendScheduler>(
+          message_, send_rate, std::chrono::milliseconds(cfg.Get<int>({"message.scheduler", "horizon"})),
+          cfg.Get<float>({"message.scheduler", "smoothing"}));
+      LOG(INFO) << "Gimbal setpoints are sent at " << send_rate << " Hz.";
+    }
+    prefix = "message.service";
+    message_service_ = std::make_unique<MessageService>(
+        message_, cfg.Get<int>({prefix, "history_size"}), std::chrono::microseconds(cfg.Get<int>({prefix, "period"})),
+        timed);
+  }
+  reader_->RegisterFrameCallback(CreateSyncCallback(time_base.camera));
+  ResetClockOnReopen(reader_.get(), time_base.camera);
+  LOG(INFO) << "Serial is initialized successfully.";
+  return true;
+}
+
+video::FrameCallback BaseCore::CreateSyncCallback(ClockSync &clock) {
+  std::chrono::nanoseconds frame_delay{}, max_age{};
+  if (message_service_) {
+    const std::string prefix = "message.service";
+    frame_delay = std::chrono::microseconds(cfg.Get<int>({prefix, "frame_delay"}));
+    max_age = std::chrono::milliseconds(cfg.Get<int>({prefix, "max_age"}));
   }
-  auto func = std::make_unique<video::FrameCallback::function>([this](video::Frame &frame) {
+  auto callback = [this, &clock, frame_delay, max_age](video::Frame &frame) {
     auto *receive_packet = new message::ReiceivePacket();
-    if (message_) {
-      message_->Receive();
-      message::GimbalReceive gimbal_receive{};
-      message::ShootReceive shoot_receive{};
-      if (!message_->ReadData(gimbal_receive) || !message_->ReadData(shoot_receive)) {
-        LOG(WARNING) << "Failed to read data in frame callback function. Set this frame as invalid.";
+    if (message_service_) {
+      /// 以回调时刻同步相机时钟，换算后的帧时间戳不含取图和传输的抖动，再减去平均取图延迟即为曝光时刻
+      const uint64_t now = TimeBase::Now();
+      clock.Update(static_cast<int64_t>(frame.time_stamp), static_cast<int64_t>(now));
+      const uint64_t host_time_stamp = clock.Ready() ? clock.ToHost(static_cast<int64_t>(frame.time_stamp)) : now;
+      const auto time_stamp = host_time_stamp - static_cast<uint64_t>(frame_delay.count());
+      if (!message_service_->Lookup(time_stamp, *receive_packet, max_age)) {
+        LOG_EVERY_N(WARNING, 100) << "No fresh data from message service. Set this frame as invalid.";
         frame.valid = false;
       }
-      receive_packet->yaw = gimbal_receive.yaw;
-      receive_packet->pitch = gimbal_receive.pitch;
-      receive_packet->roll = gimbal_receive.roll;
-      receive_packet->mode = gimbal_receive.mode;
-      receive_packet->color = gimbal_receive.color;
-      receive_packet->bullet_speed = shoot_receive.bullet_speed;
     } else {
       const std::string prefix = "message.simulator";
       receive_packet->yaw = cfg.Get<float>({prefix, "yaw"});
@@ -87,10 +163,14 @@ bool BaseCore::InitializeMessage() {
       receive_packet->color = cfg.Get<int>({prefix, "color"});
     }
     frame.sync_data.reset(receive_packet);
-  });
-  reader_->RegisterFrameCallback({std::move(func)});
-  LOG(INFO) << "Serial is initialized successfully.";
-  return true;
+  };
+  return {std::make_unique<video::FrameCallback::function>(std::move(callback))};
+}
+
+void BaseCore::ResetClockOnReopen(video::Reader *reader, ClockSync &clock) {
+  if (auto *managed = dynamic_cast<video::ManagedCameraReader *>(reader)) {
+    managed->SetReopenCallback([&clock] { clock.Reset(); });
+  }
 }
 
 bool BaseCore::InitializeSolver() {
@@ -105,6 +185,7 @@ bool BaseCore::InitializeSolver() {
     return false;
   }
   if (cfg.Get<bool>({"coord", cfg.Get<std::string>({"type"}), "cam_flip"})) {
+    pixel_format_ = RotatePixelFormat(pixel_format_);
     auto func = std::make_unique<video::FrameCallback::function>([](video::Frame &frame) {
       flip(frame.image, frame.image, 0);
       flip(frame.image, frame.image, 1);
@@ -116,20 +197,60 @@ bool BaseCore::InitializeSolver() {
   return true;
 }
 
+bool BaseCore::CreateAutoaimRegistry(std::shared_ptr<coord::Solver> REF_IN solver, const cv::Size frame_size,
+                                     const PixelFormat pixel_format, const bool viewer,
+                                     AutoaimRegistry REF_OUT registry) {
+  /// 大小能量机关共用同一个自瞄对象，由模式区分
+  const std::vector<std::pair<autoaim::Mode, std::string>> mode_list = {
+      {autoaim::Mode::kArmor, "armor"}, {autoaim::Mode::kSmallRune, "rune"}, {autoaim::Mode::kBigRune, "rune"}};
+  std::unordered_map<std::string, std::shared_ptr<autoaim::BaseAutoaim>> created;
+  for (const auto &[mode, name] : mode_list) {
+    auto &autoaim = created[name];
+    if (!autoaim) {
+      autoaim.reset(autoaim::CreateAutoaim(name));
+      if (!autoaim) {
+        LOG(ERROR) << "Failed to create " << name << "-autoaim.";
+        return false;
+      }
+      autoaim->InitCoordSolver(solver);
+      autoaim->SetPixelFormat(pixel_format);
+      autoaim->EnableViewer(viewer);
+      if (!autoaim->Initialize()) {
+        LOG(ERROR) << "Failed to initialize " << name << "-autoaim.";
+        return false;
+      }
+      /// 启动时完成一次推理，切换模式时不再有冷启动
+      const auto start = std::chrono::steady_clock::now();
+      if (!autoaim->Warmup(frame_size)) {
+        LOG(ERROR) << "Failed to warm up " << name << "-autoaim.";
+        return false;
+      }
+      LOG(INFO) << name << "-autoaim is warmed up in "
+                << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count()
+                << " ms.";
+    }
+    registry[mode] = autoaim;
+  }
+  return true;
+}
+
 bool BaseCore::InitializeAutoaim() {
   if (!solver_) {
     return false;
   }
-  auto &autoaim = autoaim_registry_[autoaim::Mode::kArmor];
-  autoaim.reset(autoaim::CreateAutoaim("armor"));
-  if (!autoaim) {
-    LOG(ERROR) << "Failed to create armor-autoaim.";
+  if (!CreateAutoaimRegistry(solver_, frame_.image.size(), pixel_format_, true, autoaim_registry_)) {
     return false;
   }
-  autoaim->InitCoordSolver(solver_);
-  if (!autoaim->Initialize()) {
-    LOG(ERROR) << "Failed to initialize autoaim.";
-    return false;
+
+  if (const auto shadow_mode = cfg.Get<int>({"autoaim.shadow", "mode"}); shadow_mode >= 0) {
+    const auto mode = static_cast<autoaim::Mode>(shadow_mode);
+    if (!autoaim_registry_.contains(mode)) {
+      LOG(ERROR) << "Unknown mode " << shadow_mode << " for shadow autoaim.";
+      return false;
+    }
+    shadow_ = std::make_unique<ShadowAutoaim>(autoaim_registry_[mode], mode,
+                                              cfg.Get<int>({"autoaim.shadow", "interval"}));
+    LOG(INFO) << "Shadow autoaim is running for mode " << shadow_mode << ".";
   }
 
   LOG(INFO) << "Autoaim is initialized successfully.";
@@ -141,6 +262,137 @@ bool BaseCore::InitializeFpsController() {
   return true;
 }
 
+bool BaseCore::SetAutoaim() {
+  const bool ret = frame_.sync_data != nullptr;
+  const bool had_sync_data = has_sync_data_.exchange(ret);
+  if (!ret && had_sync_data) {
+    LOG(WARNING) << "No sync data found.";
+  } else if (ret && !had_sync_data) {
+    LOG(WARNING) << "The problem of no sync data found has been solved.";
+  }
+  if (!ret) {
+    return false;
+  }
+
+  const auto *receive_packet = static_cast<const message::ReiceivePacket *>(frame_.sync_data.get());
+  const auto mode = static_cast<autoaim::Mode>(receive_packet->mode);
+  if (!autoaim_registry_.contains(mode)) {
+    LOG(ERROR) << "Unknown mode for autoaim.";
+    return false;
+  }
+  autoaim_ = autoaim_registry_[mode];
+  if (shadow_) {
+    shadow_->Activate(autoaim_);
+  }
+  FeedAutoaim(frame_, *autoaim_);
+  return true;
+}
+
+bool BaseCore::WaitFirstFrame(video::Reader &reader, video::Frame REF_OUT frame, std::string REF_IN name) {
+  using std::chrono_literals::operator""ms;
+  /// 短间隔轮询，视频源一就绪就开始运行，不会白白多等一秒
+  while (!reader.GetFrame(frame)) {
+    if (exit_signal) {
+      return false;
+    }
+    LOG_EVERY_N(WARNING, 100) << "Waiting for the first frame from " << name << ".";
+    std::this_thread::sleep_for(10ms);
+  }
+  return true;
+}
+
+bool BaseCore::ReadPixelFormat(std::string REF_IN prefix, video::Reader REF_IN reader, video::Frame REF_IN frame,
+                               PixelFormat REF_OUT pixel_format) {
+  /// 转储文件自带像素格式，不读取配置
+  if (const auto *raw = dynamic_cast<const video::RawReader *>(&reader)) {
+    pixel_format = raw->Format();
+  } else if (!ParsePixelFormat(cfg.Get<std::string>({prefix, "pixel_format"}), pixel_format)) {
+    return false;
+  }
+  const auto format = FrameFormat::Of(frame.image, pixel_format);
+  const bool odd_size = (format.width | format.height) & 1;
+  if (frame.image.type() != PixelFormatType(pixel_format) || (IsBayer(pixel_format) && odd_size)) {
+    LOG(ERROR) << "Frames of " << prefix << " do not match the pixel format in config.";
+    return false;
+  }
+  LOG(INFO) << prefix << " delivers " << format.width << "x" << format.height << " frames in pixel format "
+            << static_cast<int>(format.pixel_format) << " with stride " << format.stride << ".";
+  return true;
+}
+
+void BaseCore::UpdateExposureTargets(video::Reader *reader, autoaim::ArmorPtrList REF_IN targets) {
+  auto *managed = dynamic_cast<video::ManagedCameraReader *>(reader);
+  if (!managed) {
+    return;
+  }
+  std::vector<cv::Rect> boxes;
+  boxes.reserve(targets.size());
+  for (const auto &target : targets) {
+    boxes.push_back(cv::boundingRect(std::vector<cv::Point2f>(target->pts.begin(), target->pts.end())));
+  }
+  managed->SetExposureTargets(boxes);
+}
+
+void BaseCore::FeedAutoaim(video::Frame REF_IN frame, autoaim::BaseAutoaim &autoaim) {
+  const auto receive_packet = std::static_pointer_cast<message::ReiceivePacket>(frame.sync_data);
+  const auto& [yaw, pitch, roll, mode_int, color_int, bullet_speed] = *receive_packet;
+  autoaim.SetMode(static_cast<autoaim::Mode>(mode_int));
+  autoaim.SetColor(static_cast<autoaim::Color>(color_int));
+  autoaim.SetBulletSpeed(bullet_speed);
+  autoaim.SetTimeStamp(frame.time_stamp);
+  autoaim.SetImageList(frame.image);
+
+  const coord::EAngle ea_self = {yaw, pitch, roll};
+  autoaim.SetRmSelf(coord::EAngleToRMat(ea_self));
+}
+
+uint64_t BaseCore::HostTimeStamp(video::Frame REF_IN frame, ClockSync REF_IN clock) {
+  return clock.Ready() ? static_cast<uint64_t>(clock.ToHost(static_cast<int64_t>(frame.time_stamp))) : TimeBase::Now();
+}
+
+void BaseCore::SendCommand(const uint64_t time_stamp, const float yaw, const float pitch, const bool fire) const {
+  /// 启用发送调度时只更新目标，由调度线程按控制频率发送
+  if (send_scheduler_) {
+    send_scheduler_->Update(time_stamp, yaw, pitch, fire);
+    return;
+  }
+  const message::GimbalSend gimbal_send{yaw, pitch};
+  const message::ShootSend shoot_send{fire};
+  message_->WritePacket<message::ControlSendLayout>(gimbal_send, shoot_send);
+  message_->Send();
+}
+
+void BaseCore::RecordFrame(cv::Mat FWD_IN image) const {
+  video::SessionRecord record;
+  record.time_stamp = frame_.time_stamp;
+  record.image = std::forward<cv::Mat>(image);
+  if (frame_.sync_data) {
+    const auto *receive_packet = static_cast<const char *>(frame_.sync_data.get());
+    record.receive.assign(receive_packet, receive_packet + sizeof(message::ReiceivePacket));
+  }
+  const message::GimbalSend gimbal_send{autoaim_->GetYaw(), autoaim_->GetPitch()};
+  const message::ShootSend shoot_send{autoaim_->IsFire()};
+  record.send.resize(sizeof(gimbal_send) + sizeof(shoot_send));
+  std::memcpy(record.send.data(), &gimbal_send, sizeof(gimbal_send));
+  std::memcpy(record.send.data() + sizeof(gimbal_send), &shoot_send, sizeof(shoot_send));
+  for (const auto &target : autoaim_->GetTargetList()) {
+    video::SessionDetection detection;
+    for (size_t i = 0; i < target->pts.size(); ++i) {
+      detection.pts[2 * i] = target->pts[i].x;
+      detection.pts[2 * i + 1] = target->pts[i].y;
+    }
+    detection.label = static_cast<int32_t>(target->color);
+    detection.prob = target->prob;
+    record.detections.push_back(detection);
+  }
+  if (raw_dump_) {
+    raw_dump_->Commit(record);
+  }
+  if (recorder_ && !record.image.empty()) {
+    recorder_->Write(std::move(record), pixel_format_);
+  }
+}
+
 bool BaseCore::Initialize() {
   bool ret = true;
 
@@ -153,9 +405,11 @@ bool BaseCore::Initialize() {
   ret &= InitializeWriter();
   ret &= InitializeMessage();
   ret &= InitializeSolver();
+  /// 录制在坐标求解器之后初始化，此时像素格式已考虑倒装翻转，转储文件头记录的是实际写入的格式
+  ret &= InitializeRecorder();
   ret &= InitializeFpsController();
   if (!ret) {
-    LOG(ERROR) << "Failed to initialize base core because of Writer | Message | Solver | FpsController part.";
+    LOG(ERROR) << "Failed to initialize base core because of Writer | Message | Solver | Recorder | FpsController part.";
     return false;
   }
 
@@ -16,7 +16,6 @@ class NormalCore final : public BaseCore {
 
  private:
   bool UpdateFrameList();
-  bool SetAutoaim();
   void SendData() const;
 };
 
@@ -30,10 +29,27 @@ int NormalCore::Run() {
     if (!SetAutoaim()) {
       continue;
     }
+    if (shadow_) {
+      shadow_->Submit(frame_, autoaim_);
+    }
     autoaim_->Run();
+    UpdateExposureTargets(reader_.get(), autoaim_->GetTargetList());
     if (message_) {
       SendData();
     }
+    /// 自瞄不再修改图像，录制放在发送之后，不增加控制延迟
+    if (raw_dump_) {
+      raw_dump_->Stage(frame_.image);
+    }
+    if (recorder_ || raw_dump_) {
+      /// 先决定是否接收再复制，只复制原始图像，去马赛克由录制的压缩线程完成
+      const bool record = recorder_ && recorder_->Reserve();
+      RecordFrame(record ? recorder_->Snapshot(frame_.image) : cv::Mat{});
+    }
+    if (writer_) {
+      /// 传入原始图像，录像接收后才在编码线程中去马赛克
+      writer_->Write(std::move(frame_.image), pixel_format_, frame_.time_stamp, !autoaim_->GetTargetList().empty());
+    }
   }
   return 0;
 }
@@ -57,46 +73,8 @@ bool NormalCore::UpdateFrameList() {
   return ret;
 }
 
-bool NormalCore::SetAutoaim() {
-  static bool show_warning = true;
-  const bool ret = frame_.sync_data != nullptr;
-  if (!ret && show_warning) {
-    LOG(WARNING) << "No sync data found.";
-  } else if (ret && !show_warning) {
-    LOG(WARNING) << "The problem of no sync data found has been solved.";
-  }
-  show_warning = ret;
-  if (!ret) {
-    return false;
-  }
-
-  const auto receive_packet = std::static_pointer_cast<message::ReiceivePacket>(frame_.sync_data);
-  const auto& [yaw, pitch, roll, mode_int, color_int, bullet_speed] = *receive_packet;
-  const auto mode = static_cast<autoaim::Mode>(mode_int);
-  const auto color = static_cast<autoaim::Color>(color_int);
-  if (!autoaim_registry_.contains(mode)) {
-    LOG(ERROR) << "Unknown mode for autoaim.";
-    return false;
-  }
-  autoaim_ = autoaim_registry_[mode];
-  autoaim_->SetMode(mode);
-  autoaim_->SetColor(color);
-  autoaim_->SetBulletSpeed(bullet_speed);
-  autoaim_->SetTimeStamp(frame_.time_stamp);
-  autoaim_->SetImageList(frame_.image);
-
-  const coord::EAngle ea_self = {yaw, pitch, roll};
-  autoaim_->SetRmSelf(coord::EAngleToRMat(ea_self));
-
-  return true;
-}
-
 void NormalCore::SendData() const {
-  const message::GimbalSend gimbal_send{autoaim_->GetYaw(), autoaim_->GetPitch()};
-  const message::ShootSend shoot_send{autoaim_->IsFire()};
-  message_->WriteData(gimbal_send);
-  message_->WriteData(shoot_send);
-  message_->Send();
+  SendCommand(HostTimeStamp(frame_, time_base.camera), autoaim_->GetYaw(), autoaim_->GetPitch(), autoaim_->IsFire());
 }
 
 }  // namespace srm::core
\ No newline at end of file
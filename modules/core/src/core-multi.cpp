@@ -0,0 +1,287 @@
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <numbers>
+#include <thread>
+
+#include "srm/core.hpp"
+
+namespace srm::core {
+
+/**
+ * @brief 多相机主控类
+ * @details
+ * 每个相机有独立的视频源、坐标求解器和自瞄，在各自的线程中取图并识别，互不等待。
+ * 主循环等到每个相机都有新结果或超时后，按配置顺序取第一个识别到目标的相机的输出作为云台指令，
+ * 因此取图到决策的延迟取决于最慢的相机，而不是所有相机之和。
+ * 各相机的自瞄各自完成预测和开火决策，不合并目标列表。
+ * 第一个相机同时作为 reader_，视频录制和图像显示只针对该相机。
+ * @warning 禁止直接构造此类，请使用 @code srm::core::CreateCore("multi") @endcode 获取该类的公共接口指针
+ */
+class MultiCore final : public BaseCore {
+  inline static auto registry = RegistrySub<BaseCore, MultiCore>("multi");  ///< 主控注册信息
+ public:
+  ~MultiCore() override;
+  int Run() override;
+
+ private:
+  /// 单个相机的最新结果
+  struct Result {
+    uint64_t seq{};         ///< 结果序号，从 1 开始
+    uint64_t time_stamp{};  ///< 结果所依据的帧的时刻，本机单调时钟
+    bool valid{};           ///< 是否识别到目标
+    float yaw{};            ///< 自瞄输出的 yaw 角
+    float pitch{};          ///< 自瞄输出的 pitch 角
+    bool fire{};            ///< 是否开火
+    bool commandable{};     ///< 该相机是否有相对第一个相机的外参，没有时输出的角度不可用于下发
+  };
+
+  /// 单个相机
+  struct Source {
+    std::unique_ptr<video::Reader> reader;  ///< 视频源，第一个相机的视频源交给 reader_ 持有
+    video::Reader *ptr{};                   ///< 视频源
+    video::Frame frame;                     ///< 帧数据
+    PixelFormat pixel_format{};             ///< 帧图像的像素格式，已考虑倒装翻转
+    std::shared_ptr<coord::Solver> solver;  ///< 坐标求解器
+    AutoaimRegistry autoaim_registry;       ///< 该相机的自瞄
+    Result result;                          ///< 最新结果，由 result_lock_ 保护
+    std::thread thread;                     ///< 取图和识别线程
+    ClockSync clock;                        ///< 相机时钟，第一个相机使用 time_base.camera
+    bool commandable{};                     ///< 是否可以下发指令，即是否为第一个相机或配置了外参
+  };
+
+  bool InitializeReader() override;
+  bool InitializeRecorder() override;
+  bool InitializeMessage() override;
+  bool InitializeSolver() override;
+  bool InitializeAutoaim() override;
+
+  /// 单个相机的取图和识别循环
+  void Capture(size_t index);
+
+  /**
+   * @brief 按配置顺序取第一个识别到目标且可以下发指令的相机的输出并发送
+   * @param [in] results 本轮有新结果的相机
+   * @return 识别到目标的相机数
+   */
+  size_t Command(std::vector<Result> REF_IN results);
+
+  std::vector<std::unique_ptr<Source>> sources_;  ///< 所有相机，顺序即优先级
+  std::chrono::milliseconds timeout_{};           ///< 等待所有相机出结果的最长时间
+
+  std::mutex result_lock_;             ///< 结果的锁
+  std::condition_variable result_cv_;  ///< 新结果通知
+  std::atomic_bool stop_flag_{};       ///< 线程停止信号
+};
+
+MultiCore::~MultiCore() {
+  stop_flag_ = true;
+  for (const auto &source : sources_) {
+    if (source->thread.joinable()) {
+      source->thread.join();
+    }
+  }
+}
+
+bool MultiCore::InitializeReader() {
+  const std::string prefix = "multi";
+  const auto reader_types = cfg.Get<std::vector<std::string>>({prefix, "readers"});
+  const auto reader_prefixes = cfg.Get<std::vector<std::string>>({prefix, "prefixes"});
+  if (reader_types.empty() || reader_types.size() != reader_prefixes.size()) {
+    LOG(ERROR) << "Readers and prefixes of multi core must be non-empty and of the same size.";
+    return false;
+  }
+  for (size_t i = 0; i < reader_types.size(); ++i) {
+    auto source = std::make_unique<Source>();
+    source->reader.reset(video::CreateReader(reader_types[i]));
+    if (!source->reader) {
+      LOG(ERROR) << "Failed to create " << reader_types[i] << " reader.";
+      return false;
+    }
+    if (!source->reader->Initialize(reader_prefixes[i])) {
+      LOG(ERROR) << "Failed to initialize reader " << reader_prefixes[i] << ".";
+      return false;
+    }
+    if (!WaitFirstFrame(*source->reader, source->frame, reader_prefixes[i]) ||
+        !ReadPixelFormat(reader_prefixes[i], *source->reader, source->frame, source->pixel_format)) {
+      return false;
+    }
+    source->ptr = source->reader.get();
+    sources_.push_back(std::move(source));
+  }
+  reader_ = std::move(sources_.front()->reader);
+  frame_ = sources_.front()->frame;
+  timeout_ = std::chrono::milliseconds(cfg.Get<int>({prefix, "timeout"}));
+  LOG(INFO) << sources_.size() << " readers are initialized successfully.";
+  return true;
+}
+
+bool MultiCore::InitializeRecorder() {
+  LOG(INFO) << "Recorder is disabled in multi mode.";
+  return true;
+}
+
+bool MultiCore::InitializeMessage() {
+  if (!BaseCore::InitializeMessage()) {
+    return false;
+  }
+  for (size_t i = 1; i < sources_.size(); ++i) {
+    sources_[i]->ptr->RegisterFrameCallback(CreateSyncCallback(sources_[i]->clock));
+    ResetClockOnReopen(sources_[i]->ptr, sources_[i]->clock);
+  }
+  return true;
+}
+
+bool MultiCore::InitializeSolver() {
+  const auto cam_flip = cfg.Get<std::vector<bool>>({"multi", "cam_flip"});
+  for (size_t i = 0; i < sources_.size(); ++i) {
+    auto &source = *sources_[i];
+    source.solver = std::make_shared<coord::Solver>();
+    source.solver->InitIntrinsicMat(source.ptr->IntrinsicMat());
+    source.solver->InitDistortionMat(source.ptr->DistortionMat());
+    if (!source.solver->Initialize()) {
+      LOG(ERROR) << "Failed to initialize coordinate solver of camera " << i << ".";
+      return false;
+    }
+    if (i < cam_flip.size() && cam_flip[i]) {
+      source.pixel_format = RotatePixelFormat(source.pixel_format);
+      auto func = std::make_unique<video::FrameCallback::function>([](video::Frame &frame) {
+        flip(frame.image, frame.image, 0);
+        flip(frame.image, frame.image, 1);
+      });
+      source.ptr->RegisterFrameCallback({std::move(func)});
+    }
+  }
+  solver_ = sources_.front()->solver;
+  pixel_format_ = sources_.front()->pixel_format;
+  LOG(INFO) << "Solvers are initialized successfully.";
+  return true;
+}
+
+bool MultiCore::InitializeAutoaim() {
+  /// 坐标求解器只读取 coord.<type> 中一套云台外参，即第一个相机的外参，其余相机须给出相对第一个相机的外参
+  const auto extrinsics = cfg.Get<std::vector<std::vector<double>>>({"multi", "extrinsics"});
+  for (size_t i = 0; i < sources_.size(); ++i) {
+    auto &source = *sources_[i];
+    if (!CreateAutoaimRegistry(source.solver, source.frame.image.size(), source.pixel_format, i == 0,
+                               source.autoaim_registry)) {
+      LOG(ERROR) << "Failed to initialize autoaim of camera " << i << ".";
+      return false;
+    }
+    source.commandable = i == 0;
+    if (i == 0) {
+      continue;
+    }
+    if (i > extrinsics.size() || extrinsics[i - 1].size() != 6) {
+      LOG(WARNING) << "No extrinsic relative to camera 0 for camera " << i << ", its results will not be sent.";
+      continue;
+    }
+    const auto &extrinsic = extrinsics[i - 1];
+    const coord::RMat rm_cam_ref =
+        coord::EAngleToRMat(coord::EAngle{extrinsic[0], extrinsic[1], extrinsic[2]} * std::numbers::pi / 180);
+    const coord::CTVec ctv_cam_ref{extrinsic[3], extrinsic[4], extrinsic[5]};
+    for (const auto &[mode, autoaim] : source.autoaim_registry) {
+      autoaim->SetCameraExtrinsic(rm_cam_ref, ctv_cam_ref);
+    }
+    source.commandable = true;
+  }
+  autoaim_registry_ = sources_.front()->autoaim_registry;
+  LOG(INFO) << "Autoaim is initialized successfully. Shadow autoaim is disabled in multi mode.";
+  return true;
+}
+
+void MultiCore::Capture(const size_t index) {
+  using std::chrono_literals::operator""ms;
+  auto &source = *sources_[index];
+  while (!stop_flag_ && !exit_signal) {
+    if (!source.ptr->GetFrame(source.frame)) {
+      std::this_thread::sleep_for(1ms);
+      continue;
+    }
+    if (!source.frame.valid || !source.frame.sync_data) {
+      continue;
+    }
+    const auto *receive_packet = static_cast<const message::ReiceivePacket *>(source.frame.sync_data.get());
+    const auto mode = static_cast<autoaim::Mode>(receive_packet->mode);
+    const auto it = source.autoaim_registry.find(mode);
+    if (it == source.autoaim_registry.end()) {
+      LOG_EVERY_N(ERROR, 100) << "Unknown mode for autoaim of camera " << index << ".";
+      continue;
+    }
+    auto &autoaim = *it->second;
+    FeedAutoaim(source.frame, autoaim);
+    const bool valid = autoaim.Run();
+    UpdateExposureTargets(source.ptr, autoaim.GetTargetList());
+    const uint64_t time_stamp = HostTimeStamp(source.frame, index == 0 ? time_base.camera : source.clock);
+    {
+      std::lock_guard lock{result_lock_};
+      auto &result = source.result;
+      result = {result.seq + 1, time_stamp, valid, autoaim.GetYaw(), autoaim.GetPitch(), autoaim.IsFire(),
+                source.commandable};
+    }
+    result_cv_.notify_one();
+    if (index == 0 && writer_) {
+      writer_->Write(std::move(source.frame.image), source.pixel_format, source.frame.time_stamp, valid);
+    }
+  }
+}
+
+int MultiCore::Run() {
+  for (size_t i = 0; i < sources_.size(); ++i) {
+    sources_[i]->thread = std::thread([this, i] { Capture(i); });
+  }
+  std::vector<uint64_t> last_seq(sources_.size());
+  std::vector<Result> results;
+  const auto fresh = [&](const size_t i) { return sources_[i]->result.seq != last_seq[i]; };
+  while (!exit_signal) {
+    results.clear();
+    {
+      /// 等到每个相机都有新结果，超时则只使用已有的新结果
+      std::unique_lock lock{result_lock_};
+      result_cv_.wait_for(lock, timeout_, [&] {
+        for (size_t i = 0; i < sources_.size(); ++i) {
+          if (!fresh(i)) {
+            return false;
+          }
+        }
+        return true;
+      });
+      for (size_t i = 0; i < sources_.size(); ++i) {
+        if (fresh(i)) {
+          last_seq[i] = sources_[i]->result.seq;
+          results.push_back(sources_[i]->result);
+        }
+      }
+    }
+    if (results.empty()) {
+      continue;
+    }
+    const size_t found = Command(results);
+    LOG_EVERY_N(INFO, 100) << results.size() << " of " << sources_.size() << " cameras updated, " << found
+                           << " with target.";
+  }
+  stop_flag_ = true;
+  for (const auto &source : sources_) {
+    if (source->thread.joinable()) {
+      source->thread.join();
+    }
+  }
+  return 0;
+}
+
+size_t MultiCore::Command(std::vector<Result> REF_IN results) {
+  const auto found = static_cast<size_t>(std::ranges::count_if(results, &Result::valid));
+  if (!message_) {
+    return found;
+  }
+  const auto it =
+      std::ranges::find_if(results, [](Result REF_IN result) { return result.valid && result.commandable; });
+  if (it == results.end()) {
+    SendCommand(results.front().time_stamp, 0, 0, false);
+  } else {
+    SendCommand(it->time_stamp, it->yaw, it->pitch, it->fire);
+  }
+  return found;
+}
+
+}  // namespace srm::core
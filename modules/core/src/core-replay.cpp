@@ -0,0 +1,200 @@
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <unordered_set>
+
+#include "srm/core.hpp"
+
+namespace srm::core {
+
+namespace {
+
+constexpr std::array<char, 4> kReplayMagic = {'S', 'R', 'M', 'R'};  ///< 回放输出文件标识
+
+/**
+ * @brief 回放输出文件中的每帧记录
+ * @details
+ * 文件以 kReplayMagic 开头，之后按帧顺序连续存放该结构体，每个结构体后紧跟 target_count 个 ReplayTarget，
+ * 可直接与其他版本的输出逐帧比较识别结果和自瞄输出
+ */
+struct ReplayOutput {
+  uint64_t index{};         ///< 帧在会话中的序号
+  uint64_t time_stamp{};    ///< 帧时间戳，单位 ns
+  float yaw{};              ///< 自瞄输出的 yaw 角
+  float pitch{};            ///< 自瞄输出的 pitch 角
+  uint32_t fire{};          ///< 是否开火
+  uint32_t target_count{};  ///< 识别到的目标数量
+};
+
+/// 回放输出文件中的每个目标
+struct ReplayTarget {
+  std::array<float, 8> pts{};      ///< 四个角点的 x, y 坐标
+  uint32_t color{};                ///< 目标颜色
+  std::array<float, 3> ctv_w_x{};  ///< 目标位移向量
+};
+
+/// 计算已排序序列的分位数
+double Percentile(const std::vector<double> &sorted, const double p) {
+  if (sorted.empty()) {
+    return 0;
+  }
+  return sorted[std::min(sorted.size() - 1, static_cast<size_t>(p * static_cast<double>(sorted.size())))];
+}
+
+}  // namespace
+
+/**
+ * @brief 离线回放主控类
+ * @details
+ * 逐帧读取会话文件，用会话中保存的接收数据包代替串口数据，不丢帧地运行完整的自瞄流程，
+ * 记录每帧输出和处理时延，用于在不同版本之间比较识别、预测和开火策略的效果。
+ * @warning 禁止直接构造此类，请使用 @code srm::core::CreateCore("replay") @endcode 获取该类的公共接口指针
+ */
+class ReplayCore final : public BaseCore {
+  inline static auto registry = RegistrySub<BaseCore, ReplayCore>("replay");  ///< 主控注册信息
+ public:
+  int Run() override;
+
+ private:
+  bool InitializeReader() override;
+  bool InitializeWriter() override;
+  bool InitializeRecorder() override;
+  bool InitializeMessage() override;
+
+  /// 将会话中保存的接收数据包作为当前帧的同步数据
+  bool UpdateSyncData();
+
+  /// 将当前帧的自瞄输出和识别到的目标写入回放输出文件
+  void WriteOutput(std::ofstream &output) const;
+
+  /**
+   * @brief 打印回放统计结果
+   * @param [in] latency 每帧从取得同步数据到写完输出的处理时延，单位 ms
+   * @param [in] read_latency 每帧等待视频源的时延，单位 ms
+   * @param total 回放总时长，单位 s
+   */
+  void Report(std::vector<double> &latency, std::vector<double> &read_latency, double total) const;
+
+  video::ReplayReader *replay_{};  ///< 回放视频源，与 reader_ 指向同一对象
+};
+
+bool ReplayCore::InitializeReader() {
+  auto reader = std::make_unique<video::ReplayReader>();
+  if (!reader->Initialize("replay")) {
+    LOG(ERROR) << "Failed to initialize replay reader.";
+    return false;
+  }
+  replay_ = reader.get();
+  reader_ = std::move(reader);
+  if (!reader_->GetFrame(frame_)) {
+    LOG(ERROR) << "No frame found in session.";
+    return false;
+  }
+  LOG(INFO) << "Replay reader is initialized successfully.";
+  return true;
+}
+
+bool ReplayCore::InitializeWriter() {
+  LOG(INFO) << "Writer is disabled in replay mode.";
+  return true;
+}
+
+bool ReplayCore::InitializeRecorder() {
+  LOG(INFO) << "Recorder is disabled in replay mode.";
+  return true;
+}
+
+bool ReplayCore::InitializeMessage() {
+  LOG(INFO) << "Message is replaced by the packets recorded in session.";
+  return true;
+}
+
+int ReplayCore::Run() {
+  const auto output_file = cfg.Get<std::string>({"replay.output"});
+  std::ofstream output(output_file, std::ios::binary);
+  if (!output.is_open()) {
+    LOG(ERROR) << "Failed to open replay output " << output_file << ".";
+    return 1;
+  }
+  output.write(kReplayMagic.data(), kReplayMagic.size());
+
+  std::vector<double> latency, read_latency;
+  latency.reserve(replay_->FrameCount());
+  read_latency.reserve(replay_->FrameCount());
+  const auto elapsed = [](const std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  };
+  const auto begin = std::chrono::steady_clock::now();
+  auto read_start = begin;
+  do {
+    read_latency.push_back(elapsed(read_start));
+    /// 计入主循环中每帧的全部处理：同步数据、选择自瞄、识别预测和写出结果
+    const auto start = std::chrono::steady_clock::now();
+    if (frame_.valid && UpdateSyncData() && SetAutoaim()) {
+      autoaim_->Run();
+      WriteOutput(output);
+      latency.push_back(elapsed(start));
+    }
+    read_start = std::chrono::steady_clock::now();
+  } while (!exit_signal && reader_->GetFrame(frame_));
+  const double total = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+  Report(latency, read_latency, total);
+  LOG(INFO) << "Replay output is saved to " << output_file << ".";
+  return 0;
+}
+
+bool ReplayCore::UpdateSyncData() {
+  const auto &receive = replay_->CurrentRecord().receive;
+  if (receive.size() != sizeof(message::ReiceivePacket)) {
+    LOG_EVERY_N(WARNING, 100) << "Size of recorded receive packet " << receive.size() << " does not match "
+                              << sizeof(message::ReiceivePacket) << ", skip this frame.";
+    return false;
+  }
+  auto receive_packet = std::make_shared<message::ReiceivePacket>();
+  std::memcpy(receive_packet.get(), receive.data(), sizeof(message::ReiceivePacket));
+  frame_.sync_data = receive_packet;
+  return true;
+}
+
+void ReplayCore::WriteOutput(std::ofstream &output) const {
+  const auto &target_list = autoaim_->GetTargetList();
+  const ReplayOutput record{replay_->CurrentRecord().index, frame_.time_stamp, autoaim_->GetYaw(), autoaim_->GetPitch(),
+                            autoaim_->IsFire(), static_cast<uint32_t>(target_list.size())};
+  output.write(reinterpret_cast<const char *>(&record), sizeof(record));
+  for (const auto &armor : target_list) {
+    ReplayTarget target;
+    for (size_t i = 0; i < armor->pts.size(); ++i) {
+      target.pts[2 * i] = armor->pts[i].x;
+      target.pts[2 * i + 1] = armor->pts[i].y;
+    }
+    target.color = static_cast<uint32_t>(armor->color);
+    for (int i = 0; i < 3; ++i) {
+      target.ctv_w_x[i] = static_cast<float>(armor->ctv_w_x[i]);
+    }
+    output.write(reinterpret_cast<const char *>(&target), sizeof(target));
+  }
+}
+
+void ReplayCore::Report(std::vector<double> &latency, std::vector<double> &read_latency, const double total) const {
+  std::ranges::sort(latency);
+  std::ranges::sort(read_latency);
+  LOG(INFO) << "Replayed " << latency.size() << " of " << replay_->FrameCount() << " frames in " << total
+            << " s, throughput " << (total > 0 ? static_cast<double>(latency.size()) / total : 0) << " fps.";
+  LOG(INFO) << "Latency (ms): p50 " << Percentile(latency, 0.5) << ", p90 " << Percentile(latency, 0.9) << ", p99 "
+            << Percentile(latency, 0.99) << ", max " << (latency.empty() ? 0 : latency.back()) << ".";
+  LOG(INFO) << "Read latency (ms): p50 " << Percentile(read_latency, 0.5) << ", p99 " << Percentile(read_latency, 0.99)
+            << ", max " << (read_latency.empty() ? 0 : read_latency.back()) << ".";
+  std::unordered_set<autoaim::BaseAutoaim *> reported;
+  for (const auto &[mode, autoaim] : autoaim_registry_) {
+    if (!reported.insert(autoaim.get()).second) {
+      continue;
+    }
+    const auto &statistics = autoaim->GetFireController()->Statistics();
+    LOG(INFO) << "Autoaim of mode " << static_cast<int>(mode) << ": " << statistics.shots << " shots in "
+              << statistics.decisions << " decisions, expected hit rate " << statistics.ExpectedHitRate() << ".";
+  }
+}
+
+}  // namespace srm::core
@@ -0,0 +1,121 @@
+#include "srm/core/message-service.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+namespace srm::core {
+
+MessageService::MessageService(std::shared_ptr<message::BaseMessage> message, const size_t history_size,
+                               const std::chrono::nanoseconds period, const bool timed)
+    : message_(std::move(message)),
+      link_(dynamic_cast<message::LinkMessage *>(message_.get())),
+      period_(period),
+      timed_(timed),
+      history_(std::max<size_t>(2, history_size)) {
+  thread_ = std::thread([this] { Loop(); });
+}
+
+MessageService::~MessageService() {
+  stop_flag_ = true;
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+void MessageService::Loop() {
+  uint64_t last_time_stamp = 0;
+  uint64_t mcu_wrap = 0;
+  uint32_t last_mcu_time = 0;
+  bool has_mcu_time = false;
+  while (!stop_flag_) {
+    if (link_) {
+      if (!link_->Wait(period_) && !stop_flag_) {
+        continue;
+      }
+    } else {
+      std::this_thread::sleep_for(period_);
+    }
+    if (!message_->Receive()) {
+      continue;
+    }
+    const uint64_t receive_time_stamp = link_ ? link_->ReceiveTimeStamp() : TimeBase::Now();
+    if (receive_time_stamp == last_time_stamp) {
+      continue;
+    }
+    last_time_stamp = receive_time_stamp;
+    message::GimbalReceive gimbal_receive{};
+    message::ShootReceive shoot_receive{};
+    message::McuTime mcu_time{};
+    if (!(timed_ ? message_->ReadPacket<message::ControlTimedReceiveLayout>(gimbal_receive, shoot_receive, mcu_time)
+                 : message_->ReadPacket<message::ControlReceiveLayout>(gimbal_receive, shoot_receive))) {
+      LOG_EVERY_N(WARNING, 100) << "Failed to read data in message service.";
+      continue;
+    }
+    uint64_t time_stamp = receive_time_stamp;
+    if (timed_) {
+      /// 下位机时间没有变化说明是同一次采样被重复发送，再次加入会使时钟同步把接收延迟当成时钟偏差
+      if (has_mcu_time && mcu_time.time_stamp == last_mcu_time) {
+        continue;
+      }
+      /// 32 位微秒计数约 71 分钟溢出一次，展开为连续的纳秒时间；下位机重启时 ClockSync 会检测到跳变并重新估计
+      if (has_mcu_time && mcu_time.time_stamp < last_mcu_time) {
+        mcu_wrap += 1ull << 32;
+      }
+      has_mcu_time = true;
+      last_mcu_time = mcu_time.time_stamp;
+      const uint64_t mcu_ns = (mcu_wrap + mcu_time.time_stamp) * 1000;
+      time_base.mcu.Update(static_cast<int64_t>(mcu_ns), static_cast<int64_t>(receive_time_stamp));
+      time_stamp = time_base.McuToHost(mcu_ns, receive_time_stamp);
+    }
+    const message::ReiceivePacket packet{gimbal_receive.yaw,  gimbal_receive.pitch, gimbal_receive.roll,
+                                         gimbal_receive.mode, gimbal_receive.color, shoot_receive.bullet_speed};
+    std::lock_guard lock{lock_};
+    history_[head_] = {time_stamp, packet};
+    head_ = (head_ + 1) % history_.size();
+    count_ = std::min(count_ + 1, history_.size());
+  }
+}
+
+bool MessageService::Lookup(const uint64_t time_stamp, message::ReiceivePacket &packet,
+                            const std::chrono::nanoseconds max_age) const {
+  std::lock_guard lock{lock_};
+  if (!count_) {
+    return false;
+  }
+  const auto at = [this](const size_t i) -> const Sample & {
+    return history_[(head_ + history_.size() - 1 - i) % history_.size()];
+  };
+
+  /// 比查询时刻新的数据都没有时取最新一次，不外推
+  const Sample &latest = at(0);
+  if (latest.time_stamp <= time_stamp) {
+    packet = latest.packet;
+    return time_stamp - latest.time_stamp <= static_cast<uint64_t>(max_age.count());
+  }
+
+  /// 从新到旧找到查询时刻前后的两次数据，查询时刻比历史更早时只接受与最早一次相差不超过 max_age 的情况
+  size_t i = 1;
+  while (i < count_ && at(i).time_stamp > time_stamp) {
+    ++i;
+  }
+  if (i == count_) {
+    const Sample &oldest = at(count_ - 1);
+    packet = oldest.packet;
+    return oldest.time_stamp - time_stamp <= static_cast<uint64_t>(max_age.count());
+  }
+  const Sample &before = at(i);
+  const Sample &after = at(i - 1);
+  const float ratio = static_cast<float>(time_stamp - before.time_stamp) /
+                      static_cast<float>(after.time_stamp - before.time_stamp);
+  packet = before.packet;
+  /// yaw 在 ±π 处跳变，按最短角距离插值
+  packet.yaw += static_cast<float>(std::remainder(after.packet.yaw - before.packet.yaw, 2 * std::numbers::pi)) * ratio;
+  packet.pitch += (after.packet.pitch - before.packet.pitch) * ratio;
+  packet.roll += (after.packet.roll - before.packet.roll) * ratio;
+  return true;
+}
+
+}  // namespace srm::core
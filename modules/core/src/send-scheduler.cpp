@@ -0,0 +1,86 @@
+#include "srm/core/send-scheduler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+#include "srm/common/clock-sync.hpp"
+
+namespace srm::core {
+
+namespace {
+
+/// 将角度规范到 [-pi, pi]，自瞄的 yaw 由 atan2 得到，越过 ±pi 时不能直接相减
+float WrapAngle(const float angle) { return std::remainder(angle, 2 * std::numbers::pi_v<float>); }
+
+}  // namespace
+
+SendScheduler::SendScheduler(std::shared_ptr<message::BaseMessage> message, const double rate,
+                             const std::chrono::nanoseconds horizon, const float smoothing)
+    : message_(std::move(message)),
+      period_(static_cast<int64_t>(1e9 / std::max(1.0, rate))),
+      horizon_(horizon),
+      smoothing_(std::clamp(smoothing, 0.f, 1.f)) {
+  thread_ = std::thread([this] { Loop(); });
+}
+
+SendScheduler::~SendScheduler() {
+  stop_flag_ = true;
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+void SendScheduler::Update(const uint64_t time_stamp, const float yaw, const float pitch, const bool fire) {
+  std::lock_guard lock{lock_};
+  /// 目标丢失时自瞄输出 0/0 且不开火，这不是真实角度，前后都不能参与角速度估计，原样发送
+  const bool tracking = yaw != 0 || pitch != 0 || fire;
+  /// 间隔过长或时间倒退时不估计角速度，避免用陈旧数据外推
+  if (tracking && tracking_ && time_stamp > time_stamp_ &&
+      time_stamp - time_stamp_ <= static_cast<uint64_t>(horizon_.count())) {
+    const float dt = static_cast<float>(time_stamp - time_stamp_) * 1e-9f;
+    yaw_velocity_ = smoothing_ * yaw_velocity_ + (1 - smoothing_) * WrapAngle(yaw - yaw_) / dt;
+    pitch_velocity_ = smoothing_ * pitch_velocity_ + (1 - smoothing_) * (pitch - pitch_) / dt;
+  } else {
+    yaw_velocity_ = pitch_velocity_ = 0;
+  }
+  valid_ = true;
+  tracking_ = tracking;
+  time_stamp_ = time_stamp;
+  yaw_ = yaw;
+  pitch_ = pitch;
+  fire_ = fire;
+}
+
+void SendScheduler::Loop() {
+  auto next = std::chrono::steady_clock::now();
+  while (!stop_flag_) {
+    next += period_;
+    std::this_thread::sleep_until(next);
+    const uint64_t now = TimeBase::Now();
+    message::GimbalSetpoint setpoint{};
+    message::ShootSend shoot_send{};
+    {
+      std::lock_guard lock{lock_};
+      if (!valid_) {
+        continue;
+      }
+      /// 超过最长外推时长后设定值停住，前馈角速度也随之置零，不再开火
+      const uint64_t elapsed = now - std::min(now, time_stamp_);
+      const bool expired = elapsed >= static_cast<uint64_t>(horizon_.count());
+      const float dt = static_cast<float>(expired ? horizon_.count() : elapsed) * 1e-9f;
+      setpoint = {WrapAngle(yaw_ + yaw_velocity_ * dt), pitch_ + pitch_velocity_ * dt, expired ? 0 : yaw_velocity_,
+                  expired ? 0 : pitch_velocity_, static_cast<uint32_t>(time_base.HostToMcu(now, now) / 1000)};
+      shoot_send = {fire_ && !expired};
+    }
+    if (message_->WritePacket<message::ControlSetpointLayout>(setpoint, shoot_send)) {
+      message_->Send();
+    }
+    /// 落后超过一个周期时不补发，直接从当前时刻重新计时
+    if (const auto current = std::chrono::steady_clock::now(); current - next > period_) {
+      next = current;
+    }
+  }
+}
+
+}  // namespace srm::core
@@ -0,0 +1,81 @@
+#include "srm/core/shadow-autoaim.h"
+
+#include "srm/message.hpp"
+
+namespace srm::core {
+
+ShadowAutoaim::ShadowAutoaim(std::shared_ptr<autoaim::BaseAutoaim> autoaim, const autoaim::Mode mode,
+                             const int interval)
+    : autoaim_(std::move(autoaim)), mode_(mode), interval_(std::max(1, interval)) {
+  thread_ = std::thread([this] {
+    while (true) {
+      video::Frame frame;
+      {
+        std::unique_lock lock{frame_lock_};
+        frame_cv_.wait(lock, [this] { return pending_ || stop_flag_; });
+        if (stop_flag_) {
+          return;
+        }
+        frame = std::move(frame_);
+        pending_ = false;
+      }
+      const auto receive_packet = std::static_pointer_cast<message::ReiceivePacket>(frame.sync_data);
+      std::lock_guard lock{autoaim_lock_};
+      if (suspended_) {
+        continue;
+      }
+      autoaim_->SetMode(mode_);
+      autoaim_->SetColor(static_cast<autoaim::Color>(receive_packet->color));
+      autoaim_->SetBulletSpeed(receive_packet->bullet_speed);
+      autoaim_->SetTimeStamp(frame.time_stamp);
+      autoaim_->SetImageList(frame.image);
+      autoaim_->SetRmSelf(coord::EAngleToRMat({receive_packet->yaw, receive_packet->pitch, receive_packet->roll}));
+      autoaim_->Run();
+    }
+  });
+}
+
+ShadowAutoaim::~ShadowAutoaim() {
+  {
+    std::lock_guard lock{frame_lock_};
+    stop_flag_ = true;
+  }
+  frame_cv_.notify_one();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+void ShadowAutoaim::Submit(video::Frame REF_IN frame, std::shared_ptr<autoaim::BaseAutoaim> REF_IN active) {
+  if (active == autoaim_ || !frame.sync_data || ++counter_ < interval_) {
+    return;
+  }
+  {
+    std::unique_lock lock{frame_lock_, std::try_to_lock};
+    if (!lock.owns_lock() || pending_) {
+      return;
+    }
+    counter_ = 0;
+    /// 自瞄只读取图像，绘制结果在单独的叠加层上，因此与主循环共享图像数据，不必复制
+    frame_.valid = frame.valid;
+    frame_.image = frame.image;
+    frame_.sync_data = frame.sync_data;
+    frame_.time_stamp = frame.time_stamp;
+    pending_ = true;
+  }
+  frame_cv_.notify_one();
+}
+
+void ShadowAutoaim::Activate(std::shared_ptr<autoaim::BaseAutoaim> REF_IN active) {
+  if (active != autoaim_) {
+    suspended_ = false;
+    return;
+  }
+  if (!suspended_) {
+    /// 刚切换到影子自瞄的模式，暂停影子线程，只等待切换前已开始的那一次运行结束，之后不再争用
+    suspended_ = true;
+    std::lock_guard wait{autoaim_lock_};
+  }
+}
+
+}  // namespace srm::core
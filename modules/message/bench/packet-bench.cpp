@@ -0,0 +1,112 @@
+/**
+ * @file packet-bench.cpp
+ * @brief 数据包收发的微基准测试
+ * @details
+ * 用进程内的回环通信类代替共享内存，完整执行一次 写入、Send()、Receive()、读出 的循环，
+ * 比较逐个按编号读写（WriteData/ReadData）和按定长布局读写（WritePacket/ReadPacket）的耗时。
+ * 用法：message-packet-bench [循环次数]
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include "srm/message/message-base.hpp"
+
+namespace {
+
+using namespace srm::message;
+
+/// 回环通信类，发送的数据包写入本地帧，接收时返回预先构造好的对端数据包，拆包方式与控制程序通信相同
+class LoopbackMessage final : public BaseMessage {
+ public:
+  bool Initialize() override {
+    if (!SendRegister<GimbalSend>(1) || !SendRegister<ShootSend>(2) || !ReceiveRegister<GimbalReceive>(3) ||
+        !ReceiveRegister<ShootReceive>(4)) {
+      return false;
+    }
+    /// 对端发来的数据包
+    peer_.resize(ControlReceiveLayout::kSize);
+    ControlReceiveLayout::Stamp(peer_.data(), {3, 4});
+    ControlReceiveLayout::Put(peer_.data(), GimbalReceive{0.1f, 0.2f, 0.f, 0, 1});
+    ControlReceiveLayout::Put(peer_.data(), ShootReceive{15.f});
+    frame_.resize(kLinkMtu);
+    return true;
+  }
+
+  bool Send() override {
+    std::copy_n(send_buffer_.Ptr(), std::min(send_buffer_.Size(), frame_.size()), frame_.begin());
+    send_buffer_.Clear();
+    return true;
+  }
+
+  bool Receive() override {
+    receive_buffer_.Resize(peer_.size());
+    std::copy(peer_.begin(), peer_.end(), receive_buffer_.Ptr());
+    /// 与控制程序通信相同，逐个拆分到 packet_received_ 中，供 ReadData 使用
+    for (size_t offset = 0; offset + sizeof(short) <= peer_.size();) {
+      short id;
+      std::memcpy(&id, peer_.data() + offset, sizeof(id));
+      offset += sizeof(id);
+      auto &packet = packet_received_[id];
+      std::memcpy(packet.Ptr(), peer_.data() + offset, packet.Size());
+      offset += packet.Size();
+    }
+    return true;
+  }
+
+ private:
+  std::vector<char> peer_;   ///< 对端发来的数据包
+  std::vector<char> frame_;  ///< 发送的数据包
+};
+
+/// 执行 iterations 次循环，返回每次循环的平均耗时，单位 ns
+template <typename Cycle>
+double Measure(const size_t iterations, Cycle cycle) {
+  for (size_t i = 0; i < iterations / 10; ++i) {
+    cycle();
+  }
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < iterations; ++i) {
+    cycle();
+  }
+  const std::chrono::duration<double, std::nano> duration = std::chrono::steady_clock::now() - start;
+  return duration.count() / static_cast<double>(iterations);
+}
+
+}  // namespace
+
+int main(const int argc, char **argv) {
+  const size_t iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+  LoopbackMessage message;
+  if (!message.Initialize()) {
+    std::cerr << "Failed to initialize loopback message." << std::endl;
+    return 1;
+  }
+  GimbalSend gimbal_send{0.1f, 0.2f};
+  const ShootSend shoot_send{1};
+  GimbalReceive gimbal_receive{};
+  ShootReceive shoot_receive{};
+  bool ok = true;
+
+  const double legacy = Measure(iterations, [&] {
+    gimbal_send.yaw += 1e-6f;
+    ok &= message.WriteData(gimbal_send) && message.WriteData(shoot_send) && message.Send();
+    ok &= message.Receive() && message.ReadData(gimbal_receive) && message.ReadData(shoot_receive);
+  });
+  const double layout = Measure(iterations, [&] {
+    gimbal_send.yaw += 1e-6f;
+    ok &= message.WritePacket<ControlSendLayout>(gimbal_send, shoot_send) && message.Send();
+    ok &= message.Receive() && message.ReadPacket<ControlReceiveLayout>(gimbal_receive, shoot_receive);
+  });
+  if (!ok || shoot_receive.bullet_speed != 15.f) {
+    std::cerr << "Loopback data mismatch." << std::endl;
+    return 1;
+  }
+  std::cout << "Send()/Receive() cycle over " << iterations << " iterations:\n"
+            << "  WriteData/ReadData:     " << legacy << " ns\n"
+            << "  WritePacket/ReadPacket: " << layout << " ns" << std::endl;
+  return 0;
+}
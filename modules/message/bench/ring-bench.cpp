@@ -0,0 +1,110 @@
+/**
+ * @file ring-bench.cpp
+ * @brief ring 通信的时延基准测试
+ * @details
+ * 创建 ring 共享内存后启动一个子进程作为对端（见 ring-peer.hpp），每次发送一帧后等待对端回复，统计：
+ * Send() 和 Receive() 本身的耗时、往返时延，以及对端发布到本进程读到回复的单向时延。
+ * 用法：message-ring-bench [循环次数] [发送间隔，单位 us]
+ */
+#include <sys/wait.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "ring-peer.hpp"
+
+namespace {
+
+using namespace srm::message;
+using Clock = std::chrono::steady_clock;
+
+/// 打印排序后的时延分位数，单位 us
+void Report(const char *name, std::vector<double> &samples) {
+  std::ranges::sort(samples);
+  const auto at = [&](const double p) {
+    return samples[std::min(samples.size() - 1, static_cast<size_t>(p * static_cast<double>(samples.size())))];
+  };
+  std::cout << "  " << name << ": p50 " << at(0.5) << " us, p99 " << at(0.99) << " us, max " << samples.back()
+            << " us" << std::endl;
+}
+
+double Microseconds(const Clock::duration duration) {
+  return std::chrono::duration<double, std::micro>(duration).count();
+}
+
+}  // namespace
+
+int main(const int argc, char **argv) {
+  const size_t iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000;
+  const auto period = std::chrono::microseconds(argc > 2 ? std::strtoll(argv[2], nullptr, 10) : 1000);
+  const std::string name = "srm_ring_bench_" + std::to_string(getpid());
+  const std::string config_file = "/tmp/" + name + ".toml";
+  {
+    std::ofstream config(config_file);
+    config << "[message.ring]\nshm_name = \"" << name << "\"\nslot_count = 4\n";
+  }
+  srm::cfg.Parse(std::string{config_file});
+  std::remove(config_file.c_str());
+
+  shm_unlink(name.c_str());
+  const std::unique_ptr<BaseMessage> message(CreateMessage("ring"));
+  auto *link = dynamic_cast<LinkMessage *>(message.get());
+  if (!link || !message->Initialize() || !message->SendRegister<GimbalSend>(1) ||
+      !message->SendRegister<ShootSend>(2) || !message->ReceiveRegister<GimbalReceive>(1) ||
+      !message->ReceiveRegister<ShootReceive>(2)) {
+    std::cerr << "Failed to initialize ring message." << std::endl;
+    shm_unlink(name.c_str());
+    return 1;
+  }
+  const pid_t peer = fork();
+  if (peer == 0) {
+    _exit(bench::RunRingPeer(name));
+  }
+
+  std::vector<double> send, receive, round_trip, one_way;
+  GimbalReceive gimbal_receive{};
+  ShootReceive shoot_receive{};
+  bool ok = true;
+  auto next = Clock::now();
+  for (size_t i = 0; i < iterations && ok; ++i) {
+    std::this_thread::sleep_until(next += period);
+    message->WritePacket<ControlSendLayout>(GimbalSend{0.f, static_cast<float>(i)}, ShootSend{0});
+    const auto start = Clock::now();
+    ok &= message->Send();
+    const auto sent = Clock::now();
+    const uint64_t last = link->ReceiveTimeStamp();
+    while (ok && link->ReceiveTimeStamp() == last) {
+      ok &= link->Wait(std::chrono::seconds(1));
+      const auto before = Clock::now();
+      message->Receive();
+      receive.push_back(Microseconds(Clock::now() - before));
+    }
+    const auto now = Clock::now();
+    send.push_back(Microseconds(sent - start));
+    round_trip.push_back(Microseconds(now - start));
+    one_way.push_back(static_cast<double>(RingChannel::Now() - link->ReceiveTimeStamp()) / 1e3);
+  }
+  ok &= message->ReadPacket<ControlReceiveLayout>(gimbal_receive, shoot_receive) && shoot_receive.bullet_speed == 15.f;
+
+  /// 空帧通知对端退出
+  message->Send();
+  int status = 0;
+  waitpid(peer, &status, 0);
+  shm_unlink(name.c_str());
+  if (!ok || round_trip.empty()) {
+    std::cerr << "Peer did not reply." << std::endl;
+    return 1;
+  }
+  std::cout << "Ring message over " << round_trip.size() << " round trips, period " << period.count() << " us:"
+            << std::endl;
+  Report("Send()", send);
+  Report("Receive()", receive);
+  Report("round trip", round_trip);
+  Report("peer to vision", one_way);
+  return 0;
+}
@@ -0,0 +1,10 @@
+/**
+ * @file ring-peer.cpp
+ * @brief 代替控制程序的 ring 通信对端，调试视觉程序时不需要启动控制程序
+ * @details 用法：message-ring-peer [共享内存名字]，须在视觉程序创建共享内存之后启动
+ */
+#include "ring-peer.hpp"
+
+int main(const int argc, char **argv) {
+  return srm::message::bench::RunRingPeer(argc > 1 ? argv[1] : "srm_vision_ring");
+}
@@ -0,0 +1,72 @@
+#ifndef SRM_MESSAGE_BENCH_RING_PEER_HPP_
+#define SRM_MESSAGE_BENCH_RING_PEER_HPP_
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#include "srm/message/message-ring.hpp"
+
+namespace srm::message::bench {
+
+/**
+ * @brief 代替控制程序的 ring 通信对端
+ * @details
+ * 映射视觉一方创建的共享内存，每收到一帧视觉发送的数据就回复一帧接收数据包（云台和弹速，编号为 1 和 2），
+ * 回复的时间戳即为收到的时刻，可用于测量往返时延。收到空帧时退出。
+ * @param [in] name 共享内存名字
+ * @return 进程返回值
+ */
+inline int RunRingPeer(std::string REF_IN name) {
+  const int fd = shm_open(name.c_str(), O_RDWR, 0666);
+  struct stat st {};
+  if (fd < 0 || fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(RingLinkHeader)) {
+    std::cerr << "Shared memory " << name << " is not created by vision yet." << std::endl;
+    return 1;
+  }
+  void *ptr = mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (ptr == MAP_FAILED) {
+    std::cerr << "Failed to map shared memory " << name << "." << std::endl;
+    return 1;
+  }
+  auto *base = static_cast<char *>(ptr);
+  const auto *header = reinterpret_cast<const RingLinkHeader *>(base);
+  if (header->magic != ring_link::kMagic || !header->slot_count) {
+    std::cerr << "Shared memory " << name << " is not a ring link." << std::endl;
+    munmap(ptr, st.st_size);
+    return 1;
+  }
+  /// 视觉的发送通道是对端的接收通道，反之亦然
+  const RingChannel rx{base + sizeof(RingLinkHeader), header->slot_count};
+  RingChannel tx{base + sizeof(RingLinkHeader) + RingChannel::Bytes(header->slot_count), header->slot_count};
+
+  std::array<char, ControlReceiveLayout::kSize> reply{};
+  ControlReceiveLayout::Stamp(reply.data(), {1, 2});
+  ControlReceiveLayout::Put(reply.data(), GimbalReceive{0.f, 0.f, 0.f, 0, 0});
+  ControlReceiveLayout::Put(reply.data(), ShootReceive{15.f});
+  std::array<char, ring_link::kSlotSize> data{};
+  uint32_t size = 0;
+  uint64_t time_stamp = 0, last = 0;
+  while (true) {
+    if (!rx.Latest(data.data(), size, time_stamp, last)) {
+      rx.Wait(last, std::chrono::milliseconds(100));
+      continue;
+    }
+    if (!size) {
+      break;
+    }
+    tx.Publish(reply.data(), static_cast<uint32_t>(reply.size()));
+  }
+  munmap(ptr, st.st_size);
+  return 0;
+}
+
+}  // namespace srm::message::bench
+
+#endif  // SRM_MESSAGE_BENCH_RING_PEER_HPP_
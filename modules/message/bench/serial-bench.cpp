@@ -0,0 +1,233 @@
+/**
+ * @file serial-bench.cpp
+ * @brief 串口通信的回环测试和时延基准测试
+ * @details
+ * 用伪终端代替真实串口，视觉一侧打开指向从设备的符号链接，主设备一侧由 SerialPeer 代替下位机。依次执行：
+ * 1. 回环测试：往返数据一致，CRC 错误的帧和中途接入的残帧被丢弃并计数，之后的帧正常接收；
+ * 2. 按固定周期（默认 1 kHz）发送并等待回复，统计 Send() 耗时和往返时延；
+ * 3. 不等待回复连续发送 1 s，统计对端收到的帧率和被合并的帧数；
+ * 4. 关闭伪终端模拟拔出，检查接收线程不会空转，再把符号链接指向新的伪终端模拟插回，检查自动重新打开。
+ * 任何一项失败时返回非 0。用法：message-serial-bench [循环次数] [发送间隔，单位 us]
+ */
+#include <pty.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "serial-peer.hpp"
+
+namespace {
+
+using namespace srm::message;
+using Clock = std::chrono::steady_clock;
+
+/// 伪终端和运行在其主设备一侧的对端
+struct Pty {
+  int master{-1};                           ///< 主设备
+  int slave{-1};                            ///< 从设备，保持打开以免视觉一侧打开前主设备一直挂断
+  std::string path;                         ///< 从设备路径
+  std::unique_ptr<bench::SerialPeer> peer;  ///< 对端
+  std::thread thread;                       ///< 对端线程
+
+  bool Open() {
+    if (openpty(&master, &slave, nullptr, nullptr, nullptr) != 0) {
+      return false;
+    }
+    path = ttyname(slave);
+    peer = std::make_unique<bench::SerialPeer>(master);
+    thread = std::thread([this] { peer->Run(); });
+    return true;
+  }
+
+  /// 停止对端并关闭伪终端，视觉一侧随之挂断
+  void Close() {
+    if (peer) {
+      peer->Stop();
+      thread.join();
+      peer.reset();
+    }
+    close(master);
+    close(slave);
+    master = slave = -1;
+  }
+};
+
+/// 打印排序后的时延分位数，单位 us
+void Report(const char *name, std::vector<double> &samples) {
+  std::ranges::sort(samples);
+  const auto at = [&](const double p) {
+    return samples[std::min(samples.size() - 1, static_cast<size_t>(p * static_cast<double>(samples.size())))];
+  };
+  std::cout << "  " << name << ": p50 " << at(0.5) << " us, p99 " << at(0.99) << " us, max " << samples.back()
+            << " us" << std::endl;
+}
+
+double Microseconds(const Clock::duration duration) {
+  return std::chrono::duration<double, std::micro>(duration).count();
+}
+
+/// 本进程已使用的 CPU 时间，单位 ms
+double CpuTime() {
+  timespec ts{};
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+  return static_cast<double>(ts.tv_sec) * 1e3 + static_cast<double>(ts.tv_nsec) / 1e6;
+}
+
+/// 发送一帧 yaw 并等待对端回复同样的 yaw
+bool RoundTrip(BaseMessage &message, LinkMessage &link, const float yaw) {
+  GimbalReceive gimbal_receive{};
+  ShootReceive shoot_receive{};
+  if (!message.WritePacket<ControlSendLayout>(GimbalSend{yaw, 0.f}, ShootSend{0}) || !message.Send()) {
+    return false;
+  }
+  while (link.Wait(std::chrono::seconds(1))) {
+    message.Receive();
+    if (message.ReadPacket<ControlReceiveLayout>(gimbal_receive, shoot_receive) && gimbal_receive.yaw == yaw) {
+      return shoot_receive.bullet_speed == 15.f;
+    }
+  }
+  return false;
+}
+
+/// 从主设备一侧直接写入原始字节，模拟下位机发送
+void WriteRaw(const int fd, const uint8_t *data, const size_t size) {
+  for (size_t written = 0; written < size;) {
+    const auto ret = write(fd, data + written, size - written);
+    if (ret < 0) {
+      return;
+    }
+    written += ret;
+  }
+}
+
+#define CHECK_OR_FAIL(condition, what)                  \
+  do {                                                  \
+    if (!(condition)) {                                 \
+      std::cerr << "FAILED: " << (what) << std::endl;   \
+      pty.Close();                                      \
+      unlink(link_path.c_str());                        \
+      return 1;                                         \
+    }                                                   \
+    std::cout << "passed: " << (what) << std::endl;     \
+  } while (false)
+
+}  // namespace
+
+int main(const int argc, char **argv) {
+  const size_t iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 5000;
+  const auto period = std::chrono::microseconds(argc > 2 ? std::strtoll(argv[2], nullptr, 10) : 1000);
+  const std::string name = "srm_serial_bench_" + std::to_string(getpid());
+  const std::string link_path = "/tmp/" + name;
+  const std::string config_file = "/tmp/" + name + ".toml";
+  Pty pty;
+  if (!pty.Open() || symlink(pty.path.c_str(), link_path.c_str()) != 0) {
+    std::cerr << "Failed to create pseudo terminal." << std::endl;
+    return 1;
+  }
+  {
+    std::ofstream config(config_file);
+    config << "[message.serial]\ndevice = \"" << link_path << "\"\nbaud_rate = 921600\n";
+  }
+  srm::cfg.Parse(std::string{config_file});
+  std::remove(config_file.c_str());
+
+  const std::unique_ptr<BaseMessage> message(CreateMessage("serial"));
+  auto *serial = dynamic_cast<SerialMessage *>(message.get());
+  CHECK_OR_FAIL(serial && message->Initialize() && message->SendRegister<GimbalSend>(1) &&
+                    message->SendRegister<ShootSend>(2) && message->ReceiveRegister<GimbalReceive>(1) &&
+                    message->ReceiveRegister<ShootReceive>(2),
+                "initialize serial message");
+
+  /// 1. 回环测试
+  CHECK_OR_FAIL(RoundTrip(*message, *serial, 1.5f), "loopback round trip");
+  std::array<char, ControlReceiveLayout::kSize> packet{};
+  ControlReceiveLayout::Stamp(packet.data(), {1, 2});
+  ControlReceiveLayout::Put(packet.data(), GimbalReceive{2.5f, 0.f, 0.f, 0, 0});
+  ControlReceiveLayout::Put(packet.data(), ShootReceive{15.f});
+  std::array<uint8_t, serial_link::kMaxEncoded> frame{};
+  const size_t frame_size = bench::EncodeSerialFrame(packet.data(), packet.size(), frame.data());
+  const uint64_t corrupted = serial->Corrupted();
+  const uint64_t time_stamp = serial->ReceiveTimeStamp();
+  auto bad_frame = frame;
+  bad_frame[frame_size / 2] ^= 0x10;
+  const std::array<uint8_t, 5> garbage{0x13, 0x37, 0x42, 0x42, 0x00};
+  WriteRaw(pty.master, bad_frame.data(), frame_size);
+  WriteRaw(pty.master, garbage.data(), garbage.size());
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  message->Receive();
+  CHECK_OR_FAIL(serial->Corrupted() == corrupted + 2 && serial->ReceiveTimeStamp() == time_stamp,
+                "drop corrupted and partial frames");
+  WriteRaw(pty.master, frame.data(), frame_size);
+  GimbalReceive gimbal_receive{};
+  ShootReceive shoot_receive{};
+  CHECK_OR_FAIL(serial->Wait(std::chrono::seconds(1)) && message->Receive() &&
+                    message->ReadPacket<ControlReceiveLayout>(gimbal_receive, shoot_receive) &&
+                    gimbal_receive.yaw == 2.5f,
+                "resynchronize after corrupted frames");
+
+  /// 2. 固定周期往返
+  std::vector<double> send, round_trip;
+  bool ok = true;
+  auto next = Clock::now();
+  for (size_t i = 0; i < iterations && ok; ++i) {
+    std::this_thread::sleep_until(next += period);
+    const auto yaw = static_cast<float>(i);
+    const auto start = Clock::now();
+    ok &= message->WritePacket<ControlSendLayout>(GimbalSend{yaw, 0.f}, ShootSend{0}) && message->Send();
+    send.push_back(Microseconds(Clock::now() - start));
+    while (ok && !(message->ReadPacket<ControlReceiveLayout>(gimbal_receive, shoot_receive) &&
+                   gimbal_receive.yaw == yaw)) {
+      ok &= serial->Wait(std::chrono::seconds(1)) && message->Receive();
+    }
+    round_trip.push_back(Microseconds(Clock::now() - start));
+  }
+  CHECK_OR_FAIL(ok, "periodic round trips");
+  std::cout << "Serial message over " << round_trip.size() << " round trips, period " << period.count() << " us:"
+            << std::endl;
+  Report("Send()", send);
+  Report("round trip", round_trip);
+
+  /// 3. 连续发送
+  const uint64_t received = pty.peer->Received();
+  const uint64_t coalesced = serial->Coalesced();
+  uint64_t sent = 0;
+  const auto start = Clock::now();
+  while (Clock::now() - start < std::chrono::seconds(1)) {
+    message->WritePacket<ControlSendLayout>(GimbalSend{0.f, 0.f}, ShootSend{0});
+    sent += message->Send() ? 1 : 0;
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  std::cout << "Flood for 1 s: " << sent << " sent, " << pty.peer->Received() - received << " received by peer, "
+            << serial->Coalesced() - coalesced << " coalesced, " << pty.peer->Corrupted() << " corrupted at peer"
+            << std::endl;
+  CHECK_OR_FAIL(pty.peer->Corrupted() == 0, "no corrupted frames at peer");
+
+  /// 4. 拔出和插回
+  pty.Close();
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  const double cpu_start = CpuTime();
+  std::this_thread::sleep_for(std::chrono::seconds(1));
+  const double cpu = CpuTime() - cpu_start;
+  std::cout << "CPU time while unplugged: " << cpu << " ms/s" << std::endl;
+  CHECK_OR_FAIL(!serial->Connect(false) && cpu < 50, "no busy loop after unplug");
+  CHECK_OR_FAIL(pty.Open(), "create new pseudo terminal");
+  unlink(link_path.c_str());
+  CHECK_OR_FAIL(symlink(pty.path.c_str(), link_path.c_str()) == 0, "replug serial link");
+  const auto replug = Clock::now();
+  while (!serial->Connect(false) && Clock::now() - replug < std::chrono::seconds(3)) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  CHECK_OR_FAIL(serial->Connect(false) && RoundTrip(*message, *serial, 3.5f), "reopen after replug");
+
+  pty.Close();
+  unlink(link_path.c_str());
+  return 0;
+}
@@ -0,0 +1,109 @@
+#ifndef SRM_MESSAGE_BENCH_SERIAL_PEER_HPP_
+#define SRM_MESSAGE_BENCH_SERIAL_PEER_HPP_
+
+#include <poll.h>
+#include <unistd.h>
+
+#include <array>
+#include <atomic>
+#include <cstring>
+
+#include "srm/message/message-serial.hpp"
+
+namespace srm::message::bench {
+
+/**
+ * @brief 将一帧数据按串口帧格式编码，即 COBS([数据][CRC16]) 加结尾的 0x00
+ * @param [in] data 数据
+ * @param size 数据长度，不超过 serial_link::kMaxPayload
+ * @param [out] out 编码结果，至少 serial_link::kMaxEncoded 字节
+ * @return 编码结果长度
+ */
+inline size_t EncodeSerialFrame(const void *data, const size_t size, uint8_t *out) {
+  std::array<uint8_t, serial_link::kMaxDecoded> decoded;
+  std::memcpy(decoded.data(), data, size);
+  const uint16_t crc = serial_link::Crc16(decoded.data(), size);
+  std::memcpy(decoded.data() + size, &crc, sizeof(crc));
+  size_t encoded_size = serial_link::CobsEncode(decoded.data(), size + sizeof(crc), out);
+  out[encoded_size++] = 0;
+  return encoded_size;
+}
+
+/**
+ * @brief 代替下位机的串口对端
+ * @details
+ * 在伪终端的主设备一侧读取视觉发送的帧，每收到一帧校验通过的 ControlSendLayout 就回复一帧 ControlReceiveLayout
+ * （编号为 1 和 2），回复的 yaw 为收到的 yaw，弹速为 15，可用于检查数据和测量往返时延。
+ */
+class SerialPeer {
+ public:
+  /// @param fd 伪终端主设备的文件描述符，由调用者关闭
+  explicit SerialPeer(const int fd) : fd_(fd) {}
+
+  /// 运行直到 Stop，通常在单独的线程中调用
+  void Run() {
+    std::array<uint8_t, 256> buffer;
+    std::array<uint8_t, serial_link::kMaxEncoded> encoded, decoded, reply;
+    size_t encoded_size = 0;
+    while (!stop_flag_) {
+      pollfd pfd{fd_, POLLIN, 0};
+      if (poll(&pfd, 1, serial_link::kPollTimeout) <= 0 || !(pfd.revents & POLLIN)) {
+        continue;
+      }
+      const auto n = read(fd_, buffer.data(), buffer.size());
+      for (ssize_t i = 0; i < n; ++i) {
+        if (buffer[i]) {
+          encoded_size = std::min(encoded_size + 1, encoded.size());
+          encoded[encoded_size - 1] = buffer[i];
+          continue;
+        }
+        const size_t size = serial_link::CobsDecode(encoded.data(), encoded_size, decoded.data());
+        encoded_size = 0;
+        uint16_t crc;
+        if (size != ControlSendLayout::kSize + sizeof(crc)) {
+          corrupted_.fetch_add(1, std::memory_order_relaxed);
+          continue;
+        }
+        std::memcpy(&crc, decoded.data() + size - sizeof(crc), sizeof(crc));
+        const auto *frame = reinterpret_cast<const char *>(decoded.data());
+        if (crc != serial_link::Crc16(decoded.data(), size - sizeof(crc)) || !ControlSendLayout::Match(frame, {1, 2})) {
+          corrupted_.fetch_add(1, std::memory_order_relaxed);
+          continue;
+        }
+        GimbalSend gimbal_send{};
+        ControlSendLayout::Get(frame, gimbal_send);
+        std::array<char, ControlReceiveLayout::kSize> packet{};
+        ControlReceiveLayout::Stamp(packet.data(), {1, 2});
+        ControlReceiveLayout::Put(packet.data(), GimbalReceive{gimbal_send.yaw, 0.f, 0.f, 0, 0});
+        ControlReceiveLayout::Put(packet.data(), ShootReceive{15.f});
+        const size_t reply_size = EncodeSerialFrame(packet.data(), packet.size(), reply.data());
+        for (size_t written = 0; written < reply_size;) {
+          const auto ret = write(fd_, reply.data() + written, reply_size - written);
+          if (ret < 0) {
+            break;
+          }
+          written += ret;
+        }
+        received_.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+  }
+
+  void Stop() { stop_flag_ = true; }
+
+  /// 收到的有效帧数
+  [[nodiscard]] uint64_t Received() const { return received_.load(std::memory_order_relaxed); }
+
+  /// 校验失败或格式不符的帧数
+  [[nodiscard]] uint64_t Corrupted() const { return corrupted_.load(std::memory_order_relaxed); }
+
+ private:
+  int fd_;                            ///< 伪终端主设备
+  std::atomic_bool stop_flag_{};      ///< 停止信号
+  std::atomic_uint64_t received_{};   ///< 收到的有效帧数
+  std::atomic_uint64_t corrupted_{};  ///< 校验失败的帧数
+};
+
+}  // namespace srm::message::bench
+
+#endif  // SRM_MESSAGE_BENCH_SERIAL_PEER_HPP_
@@ -3,6 +3,9 @@
 
 #include "srm/message/info.hpp"
 #include "srm/message/message-base.hpp"
+#include "srm/message/message-ring.hpp"
+#include "srm/message/message-serial.hpp"
+#include "srm/message/packet-layout.hpp"
 #include "srm/message/packet.hpp"
 
 #endif  // SRM_MESSAGE_HPP_
\ No newline at end of file
@@ -1,13 +1,31 @@
 #ifndef SRM_MESSAGE_INFO_H_
 #define SRM_MESSAGE_INFO_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "srm/message/packet-layout.hpp"
+
 namespace srm::message {
 
+/// 链路单帧最大字节数，按 USB 全速批量传输的包长计算
+constexpr size_t kLinkMtu = 64;
+
 /// 发送的云台数据
 struct GimbalSend {
   float yaw;    ///< 绝对yaw角度
   float pitch;  ///< 绝对pitch角度
 };
 
+/// 按控制频率发送的云台设定值，带前馈角速度和时间戳
+struct GimbalSetpoint {
+  float yaw;             ///< 绝对yaw角度
+  float pitch;           ///< 绝对pitch角度
+  float yaw_velocity;    ///< yaw角速度前馈，单位为弧度每秒
+  float pitch_velocity;  ///< pitch角速度前馈，单位为弧度每秒
+  uint32_t time_stamp;   ///< 设定值对应的时刻，下位机时钟的低 32 位，尚未完成时钟同步时为本机单调时钟，单位 us
+};
+
 /// 接收的云台数据
 struct GimbalReceive {
   float yaw;
@@ -27,6 +45,11 @@ struct ShootReceive {
   float bullet_speed;  ///< 弹速
 };
 
+/// 接收的下位机时间，用于时钟同步，下位机应在采样陀螺仪时记录
+struct McuTime {
+  uint32_t time_stamp;  ///< 下位机时钟，单位 us，溢出后从 0 开始
+};
+
 /// 合并的接收数据
 struct ReiceivePacket {
   float yaw;
@@ -37,6 +60,30 @@ struct ReiceivePacket {
   float bullet_speed;
 };
 
+/// 所有可以注册的数据包类型，新增数据包类型须加入此列表
+using PacketTypes = PacketTypeList<kLinkMtu, GimbalSend, GimbalReceive, ShootSend, ShootReceive, GimbalSetpoint,
+                                   McuTime>;
+
+/// 数据包类型的类型序号，注册表以此直接索引
+template <typename T>
+constexpr size_t kPacketIndex = PacketTypes::kIndex<T>;
+
+/// 主控发送的数据包布局，顺序与注册顺序一致
+using ControlSendLayout = PacketLayout<GimbalSend, ShootSend>;
+
+/// 启用发送调度时主控发送的数据包布局，顺序与注册顺序一致
+using ControlSetpointLayout = PacketLayout<GimbalSetpoint, ShootSend>;
+
+/// 主控接收的数据包布局，顺序与注册顺序一致
+using ControlReceiveLayout = PacketLayout<GimbalReceive, ShootReceive>;
+
+/// 下位机发送时间戳时主控接收的数据包布局，顺序与注册顺序一致
+using ControlTimedReceiveLayout = PacketLayout<GimbalReceive, ShootReceive, McuTime>;
+
+static_assert(ControlSendLayout::kSize <= kLinkMtu && ControlSetpointLayout::kSize <= kLinkMtu &&
+                  ControlReceiveLayout::kSize <= kLinkMtu && ControlTimedReceiveLayout::kSize <= kLinkMtu,
+              "Control packets do not fit the link MTU.");
+
 }  // namespace srm::message
 
 #endif
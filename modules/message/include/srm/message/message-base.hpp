@@ -3,19 +3,32 @@
 
 #include <glog/logging.h>
 
+#include <algorithm>
+#include <cstring>
 #include <memory>
-#include <ranges>
+#include <string>
+#include <typeinfo>
 #include <unordered_map>
 #include <vector>
 
 #include "srm/common.hpp"
+#include "srm/message/info.hpp"
+#include "srm/message/packet-layout.hpp"
 #include "srm/message/packet.hpp"
 
 enable_factory(srm::message, BaseMessage, CreateMessage);
 
 namespace srm::message {
 
-/// 数据包通信类
+/**
+ * @brief 数据包通信类
+ * @details
+ * 注册表由每个通信实例各自持有，同一进程中的多条链路可以使用不同的编号。
+ * 查找编号仍是一次哈希表查找，而不是以类型序号直接索引数组：预编译的 libsrm_message 中的 ControlMessage
+ * 继承本类并内联了构造和析构函数，本类不能增加成员，注册表只能沿用原来的 unordered_map 成员。
+ * 键改为编译期类型序号 kPacketIndex 构成的单字节字符串，查找不分配内存，只对一个字节做哈希；
+ * 进程内共用的静态数组更快，但不同链路无法使用不同的编号，因此没有采用。
+ */
 class BaseMessage {
  public:
   BaseMessage() = default;
@@ -83,17 +96,42 @@ class BaseMessage {
   template <typename T>
   bool WriteData(T REF_IN data);
 
+  /**
+   * @brief 按定长布局一次写入所有发送数据，直接复制到发送缓冲区中的固定位置
+   * @tparam Layout 数据包布局，类型顺序须与注册顺序一致
+   * @param [in] data 布局中的全部数据，顺序任意
+   * @return 是否写入成功
+   */
+  template <typename Layout, typename... Ts>
+  bool WritePacket(Ts REF_IN... data);
+
+  /**
+   * @brief 按定长布局一次读出所有接收数据
+   * @details 接收缓冲区与布局一致时直接从固定位置复制，否则退回逐个按编号读取
+   * @tparam Layout 数据包布局
+   * @param [out] data 布局中的全部数据，顺序任意
+   * @return 是否读取成功
+   */
+  template <typename Layout, typename... Ts>
+  bool ReadPacket(Ts REF_OUT... data);
+
  protected:
-  using Registry = std::unordered_map<std::string, std::pair<short, short>>;  //(typename,(id,size))，类型有唯一id
+  using Registry = std::unordered_map<std::string, std::pair<short, short>>;  ///< 类型键到 (编号, 大小) 的注册表
 
+  /// 类型 T 在注册表中的键，为类型序号构成的单字节字符串
   template <typename T>
-  bool Register(Registry REF_OUT registry, short id);
+  static const std::string &Key();
 
   template <typename T>
-  short GetId(Registry REF_IN registry) const;
+  static bool Register(Registry REF_OUT registry, short id);
+
+  /// 类型 T 的编号，未注册时为 0
+  template <typename T>
+  static short GetId(Registry REF_IN registry);
+
+  Registry receive_registry_{};  ///< 接收数据包注册表
+  Registry send_registry_{};     ///< 发送数据包注册表
 
-  Registry receive_registry_{};                        ///< 接收数据包注册表
-  Registry send_registry_{};                           ///< 发送数据包注册表
   short receive_size_{};                               ///< 接收大小
   Packet receive_buffer_{};                            ///< 接收缓冲区
   short send_size_{};                                  ///< 发送大小
@@ -125,12 +163,12 @@ bool BaseMessage::SendRegister(const short id) {
 template <typename T>
 bool BaseMessage::ReadData(T REF_OUT data) {
   const auto id = GetId<T>(receive_registry_);
-  if (!packet_received_.contains(id)) {
+  const auto it = packet_received_.find(id);
+  if (it == packet_received_.end() || it->second.Size() < sizeof(T)) {
     LOG(ERROR) << "Can not find packet in received data.";
     return false;
   }
-  Packet packet = packet_received_[id];
-  packet.Read(data);  /// 解小包
+  std::memcpy(&data, it->second.Ptr(), sizeof(T));  /// 解小包，直接从拆分好的数据中复制
   return true;
 }
 
@@ -147,34 +185,75 @@ bool BaseMessage::WriteData(T REF_IN data) {
   return true;
 }
 
+template <typename Layout, typename... Ts>
+bool BaseMessage::WritePacket(Ts REF_IN... data) {
+  static_assert(sizeof...(Ts) == Layout::kCount, "All data of the layout must be written at once.");
+  static_assert(((Layout::template kIndex<Ts> < Layout::kCount) && ...), "Type is not part of this packet layout.");
+  if (Layout::kSize != static_cast<size_t>(send_size_)) {
+    LOG(ERROR) << "Packet layout does not match registered send packets.";
+    return false;
+  }
+  typename Layout::Ids ids{};
+  ((ids[Layout::template kIndex<Ts>] = GetId<Ts>(send_registry_)), ...);
+  if (std::ranges::find(ids, 0) != ids.end()) {
+    LOG(ERROR) << "Unregistered packet";
+    return false;
+  }
+  /// 清空后缓冲区容量保留，这里不会重新分配内存
+  send_buffer_.Resize(Layout::kSize);
+  char *frame = send_buffer_.Ptr();
+  Layout::Stamp(frame, ids);
+  (Layout::Put(frame, data), ...);
+  return true;
+}
+
+template <typename Layout, typename... Ts>
+bool BaseMessage::ReadPacket(Ts REF_OUT... data) {
+  static_assert(sizeof...(Ts) == Layout::kCount, "All data of the layout must be read at once.");
+  static_assert(((Layout::template kIndex<Ts> < Layout::kCount) && ...), "Type is not part of this packet layout.");
+  typename Layout::Ids ids{};
+  ((ids[Layout::template kIndex<Ts>] = GetId<Ts>(receive_registry_)), ...);
+  if (receive_buffer_.Size() == Layout::kSize && Layout::Match(receive_buffer_.Ptr(), ids)) {
+    const char *frame = receive_buffer_.Ptr();
+    (Layout::Get(frame, data), ...);
+    return true;
+  }
+  return (ReadData(data) && ...);
+}
+
 template <typename T>
-bool BaseMessage::Register(Registry REF_OUT registry, short id) {
+const std::string& BaseMessage::Key() {
+  static_assert(kPacketIndex<T> < PacketTypes::kCount, "Packet type is not listed in PacketTypes.");
+  static const std::string key(1, static_cast<char>(kPacketIndex<T>));
+  return key;
+}
+
+template <typename T>
+bool BaseMessage::Register(Registry REF_OUT registry, const short id) {
   /// 检查id和类型是否都没注册
-  const std::string name = typeid(T).name();
-  for (const auto& [id_, size_] : registry | std::views::values) {
-    if (id_ == id) {
+  if (!id) {
+    LOG(ERROR) << "ID 0 is reserved for unregistered packets.";
+    return false;
+  }
+  for (const auto& [key, slot] : registry) {
+    if (slot.first == id) {
       LOG(ERROR) << "ID " << id << " is already in use.";
       return false;
     }
   }
-  if (registry.contains(name)) {
-    LOG(ERROR) << "Type " << name << " is already registered.";
+  if (registry.contains(Key<T>())) {
+    LOG(ERROR) << "Type " << typeid(T).name() << " is already registered.";
     return false;
   }
   /// 注册
-  registry[name] = {id, sizeof(T)};
+  registry.emplace(Key<T>(), std::make_pair(id, static_cast<short>(sizeof(T))));
   return true;
 }
 
 template <typename T>
-short BaseMessage::GetId(Registry REF_IN registry) const {
-  /// 获取对应id
-  const std::string name = typeid(T).name();
-  if (registry.contains(name)) {
-    return registry.at(name).first;
-  }
-  LOG(ERROR) << "Packet is not registered.";
-  return 0;
+short BaseMessage::GetId(Registry REF_IN registry) {
+  const auto it = registry.find(Key<T>());
+  return it == registry.end() ? 0 : it->second.first;
 }
 
 }  // namespace srm::message
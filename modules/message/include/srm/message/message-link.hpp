@@ -0,0 +1,58 @@
+#ifndef SRM_MESSAGE_MESSAGE_LINK_HPP_
+#define SRM_MESSAGE_MESSAGE_LINK_HPP_
+
+#include <glog/logging.h>
+
+#include <chrono>
+#include <cstring>
+
+#include "srm/message/message-base.hpp"
+
+namespace srm::message {
+
+/**
+ * @brief 直接与对方交换数据帧的通信类基类
+ * @details
+ * 数据帧格式与 ControlMessage 相同，即若干个 [short 编号][数据]。
+ * Receive 为非阻塞的最新值读取，Wait 等待对方的新数据，每帧数据带有单调时钟时间戳。
+ */
+class LinkMessage : public BaseMessage {
+ public:
+  LinkMessage() = default;
+  ~LinkMessage() override = default;
+
+  /**
+   * @brief 等待对方发送新数据
+   * @param timeout 最长等待时间
+   * @return 是否有新数据
+   */
+  virtual bool Wait(std::chrono::nanoseconds timeout) = 0;
+
+  /// 最近一次收到的数据的时间戳，CLOCK_MONOTONIC，单位 ns
+  [[nodiscard]] uint64_t ReceiveTimeStamp() const { return receive_time_stamp_; }
+
+ protected:
+  /// 将一帧数据复制到接收缓冲区，并按编号拆分到 packet_received_，遇到未注册的编号时停止
+  void Split(const char *data, const size_t size) {
+    receive_buffer_.Resize(size);
+    std::memcpy(receive_buffer_.Ptr(), data, size);
+    for (size_t offset = 0; offset + sizeof(short) <= size;) {
+      short id;
+      std::memcpy(&id, data + offset, sizeof(short));
+      offset += sizeof(short);
+      const auto it = packet_received_.find(id);
+      if (it == packet_received_.end() || offset + it->second.Size() > size) {
+        LOG_EVERY_N(WARNING, 100) << "Unknown or truncated packet " << id << " in received frame.";
+        return;
+      }
+      std::memcpy(it->second.Ptr(), data + offset, it->second.Size());
+      offset += it->second.Size();
+    }
+  }
+
+  uint64_t receive_time_stamp_{};  ///< 最近一次收到的数据的时间戳
+};
+
+}  // namespace srm::message
+
+#endif  // SRM_MESSAGE_MESSAGE_LINK_HPP_
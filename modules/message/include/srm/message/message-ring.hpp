@@ -0,0 +1,294 @@
+#ifndef SRM_MESSAGE_MESSAGE_RING_HPP_
+#define SRM_MESSAGE_MESSAGE_RING_HPP_
+
+#include <fcntl.h>
+#include <glog/logging.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+#include "srm/common/config.hpp"
+#include "srm/message/message-link.hpp"
+
+namespace srm::message {
+
+/**
+ * @brief 共享内存收发通道格式
+ * @details
+ * 两个方向各一个单写单读的环形缓冲区，布局固定，控制程序按偏移直接读写，所有整数均为小端：
+ * @code
+ * RingLinkHeader（64 字节）
+ * 发送通道（视觉写，控制程序读）：RingChannelHeader（64 字节）| RingSlot * slot_count
+ * 接收通道（控制程序写，视觉读）：RingChannelHeader（64 字节）| RingSlot * slot_count
+ * @endcode
+ * 每个槽位使用顺序锁：写入前 seq 变为奇数，写完后变为下一个偶数，读者前后两次读到相同的偶数才说明数据完整。
+ * 写者写完后更新 latest 并将 futex 加一，只有 waiters 不为零时才调用 FUTEX_WAKE，因此发布不会阻塞。
+ * 读者只读取 latest 对应的槽位，即“最新值”语义，不保证读到每一帧。
+ * 槽位中的数据与 ControlMessage 的数据包格式相同，即若干个 [short 编号][数据]。
+ */
+namespace ring_link {
+
+constexpr std::array<char, 4> kMagic = {'S', 'R', 'M', 'Q'};  ///< 共享内存标识
+constexpr uint32_t kVersion = 1;                              ///< 格式版本
+constexpr uint32_t kSlotSize = kLinkMtu;                      ///< 槽位数据区大小
+constexpr int kReadRetry = 4;                                 ///< 读到正在写入的槽位时的重试次数
+
+}  // namespace ring_link
+
+/// 共享内存头
+struct alignas(64) RingLinkHeader {
+  std::array<char, 4> magic = ring_link::kMagic;  ///< 共享内存标识
+  uint32_t version = ring_link::kVersion;         ///< 格式版本
+  uint32_t slot_count{};                          ///< 每个通道的槽位数量
+  uint32_t slot_size{};                           ///< 每个槽位数据区的大小
+};
+
+/// 通道头
+struct alignas(64) RingChannelHeader {
+  uint64_t latest{};   ///< 最新一帧的序号，从 1 开始，0 表示还没有数据
+  uint32_t futex{};    ///< 每发布一帧加一，读者在此等待
+  uint32_t waiters{};  ///< 正在等待的读者数量，为零时写者不调用 FUTEX_WAKE
+};
+
+/// 槽位
+struct RingSlot {
+  uint64_t seq{};                                 ///< 顺序锁计数，奇数表示正在写入
+  uint64_t time_stamp{};                          ///< 发布时间，CLOCK_MONOTONIC，单位 ns
+  uint32_t size{};                                ///< 数据大小
+  uint32_t reserved[3]{};                         ///< 保留
+  std::array<char, ring_link::kSlotSize> data{};  ///< 数据
+};
+
+static_assert(sizeof(RingLinkHeader) == 64 && sizeof(RingChannelHeader) == 64);
+static_assert(sizeof(RingSlot) == 32 + ring_link::kSlotSize);
+
+/// 单写单读的共享内存通道
+class RingChannel final {
+ public:
+  RingChannel() = default;
+
+  /**
+   * @param [in] ptr 通道起始地址
+   * @param slot_count 槽位数量，必须大于零
+   */
+  RingChannel(char *ptr, const uint32_t slot_count)
+      : header_(reinterpret_cast<RingChannelHeader *>(ptr)),
+        slots_(reinterpret_cast<RingSlot *>(ptr + sizeof(RingChannelHeader))),
+        slot_count_(slot_count) {}
+
+  /// 通道占用的字节数
+  static size_t Bytes(const uint32_t slot_count) { return sizeof(RingChannelHeader) + slot_count * sizeof(RingSlot); }
+
+  /**
+   * @brief 发布一帧，不会阻塞
+   * @param [in] data 数据
+   * @param size 数据大小，不能超过槽位大小
+   */
+  void Publish(const char *data, const uint32_t size) {
+    const uint64_t index = std::atomic_ref(header_->latest).load(std::memory_order_relaxed) + 1;
+    RingSlot &slot = slots_[index % slot_count_];
+    std::atomic_ref seq(slot.seq);
+    const uint64_t begin = seq.load(std::memory_order_relaxed) + 1;
+    seq.store(begin, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.time_stamp = Now();
+    slot.size = size;
+    std::memcpy(slot.data.data(), data, size);
+    seq.store(begin + 1, std::memory_order_release);
+
+    std::atomic_ref(header_->latest).store(index, std::memory_order_seq_cst);
+    std::atomic_ref(header_->futex).fetch_add(1, std::memory_order_seq_cst);
+    if (std::atomic_ref(header_->waiters).load(std::memory_order_seq_cst)) {
+#if defined(__linux__)
+      syscall(SYS_futex, &header_->futex, FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+#endif
+    }
+  }
+
+  /**
+   * @brief 读取最新一帧，不会阻塞
+   * @param [out] data 数据，至少为槽位大小
+   * @param [out] size 数据大小
+   * @param [out] time_stamp 发布时间
+   * @param [in,out] last 上一次读到的序号，读到新帧时更新
+   * @return 是否读到比 last 新的完整帧
+   */
+  bool Latest(char *data, uint32_t &size, uint64_t &time_stamp, uint64_t &last) const {
+    for (int i = 0; i < ring_link::kReadRetry; ++i) {
+      const uint64_t index = std::atomic_ref(header_->latest).load(std::memory_order_acquire);
+      if (index == last) {
+        return false;
+      }
+      const RingSlot &slot = slots_[index % slot_count_];
+      std::atomic_ref seq(const_cast<uint64_t &>(slot.seq));
+      const uint64_t begin = seq.load(std::memory_order_acquire);
+      if (begin & 1) {
+        continue;
+      }
+      size = std::min<uint32_t>(slot.size, ring_link::kSlotSize);
+      time_stamp = slot.time_stamp;
+      std::memcpy(data, slot.data.data(), size);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (seq.load(std::memory_order_relaxed) == begin) {
+        last = index;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * @brief 等待比 last 新的帧
+   * @param last 上一次读到的序号
+   * @param timeout 最长等待时间
+   * @return 是否有新帧
+   */
+  bool Wait(const uint64_t last, const std::chrono::nanoseconds timeout) const {
+    std::atomic_ref futex(header_->futex);
+    std::atomic_ref waiters(header_->waiters);
+    const uint32_t value = futex.load(std::memory_order_seq_cst);
+    waiters.fetch_add(1, std::memory_order_seq_cst);
+    if (std::atomic_ref(header_->latest).load(std::memory_order_seq_cst) == last) {
+#if defined(__linux__)
+      const timespec ts{static_cast<time_t>(timeout.count() / 1'000'000'000),
+                        static_cast<long>(timeout.count() % 1'000'000'000)};
+      syscall(SYS_futex, &header_->futex, FUTEX_WAIT, value, &ts, nullptr, 0);
+#endif
+    }
+    waiters.fetch_sub(1, std::memory_order_seq_cst);
+    return std::atomic_ref(header_->latest).load(std::memory_order_acquire) != last;
+  }
+
+  /// 当前时间，CLOCK_MONOTONIC，单位 ns
+  static uint64_t Now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+
+ private:
+  RingChannelHeader *header_{};  ///< 通道头
+  RingSlot *slots_{};            ///< 槽位
+  uint32_t slot_count_{};        ///< 槽位数量
+};
+
+/**
+ * @brief 基于共享内存环形缓冲区的通信类
+ * @details
+ * 不使用信号量，Send 是无等待的发布，Receive 是非阻塞的最新值读取，格式见 ring_link。
+ * 共享内存由先启动的一方创建，另一方直接映射，不随进程退出删除。
+ */
+class RingMessage final : public LinkMessage {
+  inline static auto registry = RegistrySub<BaseMessage, RingMessage>("ring");
+
+ public:
+  RingMessage() = default;
+  ~RingMessage() override {
+    if (ptr_) {
+      munmap(ptr_, size_);
+    }
+  }
+
+  bool Initialize() override {
+    const std::string prefix = "message.ring";
+    const auto name = cfg.Get<std::string>({prefix, "shm_name"});
+    const auto slot_count_value = cfg.Get<int>({prefix, "slot_count"});
+    /// 槽位按序号取模定位，不要求 2 的幂，但至少要有一个槽位
+    if (slot_count_value <= 0) {
+      LOG(ERROR) << "Invalid slot count " << slot_count_value << " of ring message.";
+      return false;
+    }
+    const auto slot_count = static_cast<uint32_t>(slot_count_value);
+    size_ = sizeof(RingLinkHeader) + 2 * RingChannel::Bytes(slot_count);
+    const int fd = shm_open(name.c_str(), O_CREAT | O_RDWR, 0666);
+    if (fd < 0) {
+      LOG(ERROR) << "Failed to open shared memory " << name << ".";
+      return false;
+    }
+    struct stat st {};
+    if (fstat(fd, &st) != 0 || (static_cast<size_t>(st.st_size) < size_ && ftruncate(fd, static_cast<off_t>(size_)))) {
+      LOG(ERROR) << "Failed to resize shared memory " << name << ".";
+      close(fd);
+      return false;
+    }
+    void *ptr = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (ptr == MAP_FAILED) {
+      LOG(ERROR) << "Failed to map shared memory " << name << ".";
+      return false;
+    }
+    ptr_ = static_cast<char *>(ptr);
+
+    /// 新创建的共享内存全为零，由本方写入共享内存头
+    auto *header = reinterpret_cast<RingLinkHeader *>(ptr_);
+    if (header->magic != ring_link::kMagic) {
+      header->slot_count = slot_count;
+      header->slot_size = ring_link::kSlotSize;
+      header->version = ring_link::kVersion;
+      std::atomic_thread_fence(std::memory_order_release);
+      header->magic = ring_link::kMagic;
+    } else if (header->version != ring_link::kVersion || header->slot_count != slot_count ||
+               header->slot_size != ring_link::kSlotSize) {
+      LOG(ERROR) << "Layout of shared memory " << name << " does not match the config.";
+      return false;
+    }
+    tx_ = {ptr_ + sizeof(RingLinkHeader), slot_count};
+    rx_ = {ptr_ + sizeof(RingLinkHeader) + RingChannel::Bytes(slot_count), slot_count};
+    return true;
+  }
+
+  bool Connect(bool flag) override { return ptr_ != nullptr; }
+
+  bool Send() override {
+    if (!ptr_ || send_buffer_.Size() > ring_link::kSlotSize) {
+      LOG_EVERY_N(ERROR, 100) << "Failed to send " << send_buffer_.Size() << " bytes through ring message.";
+      send_buffer_.Clear();
+      return false;
+    }
+    tx_.Publish(send_buffer_.Ptr(), static_cast<uint32_t>(send_buffer_.Size()));
+    send_buffer_.Clear();
+    return true;
+  }
+
+  /**
+   * @brief 读取对方最新发布的数据，不会阻塞
+   * @return 是否有可用数据，没有新数据时保留上一次的数据
+   */
+  bool Receive() override {
+    if (!ptr_) {
+      return false;
+    }
+    std::array<char, ring_link::kSlotSize> data;
+    uint32_t size = 0;
+    if (rx_.Latest(data.data(), size, receive_time_stamp_, last_)) {
+      Split(data.data(), size);
+    }
+    return last_ != 0;
+  }
+
+  bool Wait(const std::chrono::nanoseconds timeout) override { return ptr_ && rx_.Wait(last_, timeout); }
+
+ private:
+  char *ptr_{};      ///< 共享内存起始地址
+  size_t size_{};    ///< 共享内存大小
+  RingChannel tx_;   ///< 发送通道
+  RingChannel rx_;   ///< 接收通道
+  uint64_t last_{};  ///< 最近一次读到的接收序号
+};
+
+}  // namespace srm::message
+
+#endif  // SRM_MESSAGE_MESSAGE_RING_HPP_
@@ -0,0 +1,413 @@
+#ifndef SRM_MESSAGE_MESSAGE_SERIAL_HPP_
+#define SRM_MESSAGE_MESSAGE_SERIAL_HPP_
+
+#include <fcntl.h>
+#include <glog/logging.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include "srm/common/config.hpp"
+#include "srm/message/message-link.hpp"
+
+namespace srm::message {
+
+/**
+ * @brief 串口帧格式
+ * @details
+ * 每帧为 COBS 编码后的 [数据][CRC16]，以 0x00 结尾，数据格式与 ControlMessage 相同，即若干个 [short 编号][数据]。
+ * CRC16 为 CRC-16/CCITT-FALSE（多项式 0x1021，初值 0xFFFF），小端存放。
+ * COBS 编码后帧内不含 0x00，接收端丢失字节或中途接入时在下一个 0x00 处即可重新同步。
+ */
+namespace serial_link {
+
+constexpr size_t kMaxPayload = kLinkMtu;                             ///< 单帧数据最大长度
+constexpr size_t kMaxDecoded = kMaxPayload + sizeof(uint16_t);       ///< 解码后的最大长度
+constexpr size_t kMaxEncoded = kMaxDecoded + kMaxDecoded / 254 + 2;  ///< 编码后含结尾 0x00 的最大长度
+constexpr int kPollTimeout = 100;                                    ///< 接收线程检查停止信号的间隔，单位 ms
+constexpr int kReopenInterval = 500;                                 ///< 串口断开后重新打开的间隔，单位 ms
+
+/// CRC-16/CCITT-FALSE 查找表
+constexpr std::array<uint16_t, 256> kCrcTable = [] {
+  std::array<uint16_t, 256> table{};
+  for (uint16_t i = 0; i < 256; ++i) {
+    uint16_t crc = i << 8;
+    for (int j = 0; j < 8; ++j) {
+      crc = crc & 0x8000 ? static_cast<uint16_t>((crc << 1) ^ 0x1021) : static_cast<uint16_t>(crc << 1);
+    }
+    table[i] = crc;
+  }
+  return table;
+}();
+
+/// 计算 CRC-16/CCITT-FALSE
+inline uint16_t Crc16(const uint8_t *data, const size_t size) {
+  uint16_t crc = 0xFFFF;
+  for (size_t i = 0; i < size; ++i) {
+    crc = static_cast<uint16_t>((crc << 8) ^ kCrcTable[(crc >> 8) ^ data[i]]);
+  }
+  return crc;
+}
+
+/**
+ * @brief COBS 编码
+ * @param [in] in 原始数据
+ * @param size 原始数据长度
+ * @param [out] out 编码结果，至少 size + size / 254 + 1 字节，不含结尾的 0x00
+ * @return 编码结果长度
+ */
+inline size_t CobsEncode(const uint8_t *in, const size_t size, uint8_t *out) {
+  size_t code_index = 0;
+  size_t out_index = 1;
+  uint8_t code = 1;
+  for (size_t i = 0; i < size; ++i) {
+    if (in[i]) {
+      out[out_index++] = in[i];
+      ++code;
+    }
+    if (!in[i] || code == 0xFF) {
+      out[code_index] = code;
+      code_index = out_index++;
+      code = 1;
+    }
+  }
+  out[code_index] = code;
+  return out_index;
+}
+
+/**
+ * @brief COBS 解码
+ * @param [in] in 编码数据，不含结尾的 0x00
+ * @param size 编码数据长度
+ * @param [out] out 解码结果，至少 size 字节
+ * @return 解码结果长度，数据非法时返回 0
+ */
+inline size_t CobsDecode(const uint8_t *in, const size_t size, uint8_t *out) {
+  size_t out_index = 0;
+  for (size_t i = 0; i < size;) {
+    const uint8_t code = in[i++];
+    if (!code || i + code - 1 > size) {
+      return 0;
+    }
+    for (uint8_t j = 1; j < code; ++j) {
+      out[out_index++] = in[i++];
+    }
+    if (code != 0xFF && i < size) {
+      out[out_index++] = 0;
+    }
+  }
+  return out_index;
+}
+
+/// 将波特率数值转为 termios 常量，不支持时返回 B0
+inline speed_t BaudRate(const int baud_rate) {
+  switch (baud_rate) {
+    case 115200:
+      return B115200;
+    case 230400:
+      return B230400;
+    case 460800:
+      return B460800;
+    case 921600:
+      return B921600;
+#if defined(B1000000)
+    case 1000000:
+      return B1000000;
+    case 2000000:
+      return B2000000;
+    case 3000000:
+      return B3000000;
+    case 4000000:
+      return B4000000;
+#endif
+    default:
+      return B0;
+  }
+}
+
+}  // namespace serial_link
+
+/**
+ * @brief 串口通信类，直接与下位机通信，不经过控制程序转发
+ * @details
+ * 接收线程持续读取串口并解析帧，校验通过的最新一帧保存下来，Receive 只复制最新一帧，不会阻塞。
+ * 发送使用非阻塞写：串口缓冲区满时未写出的部分留待下次发送，期间新的帧只保留最新一帧，旧帧被合并丢弃。
+ * USB 虚拟串口（USB-CDC）同样适用，此时波特率设置不起作用。
+ * 串口断开（如 USB 拔出）时接收线程关闭串口，之后每隔 kReopenInterval 重新打开一次，断开期间 Send 直接丢弃数据。
+ */
+class SerialMessage final : public LinkMessage {
+  inline static auto registry = RegistrySub<BaseMessage, SerialMessage>("serial");
+
+ public:
+  SerialMessage() = default;
+  ~SerialMessage() override {
+    stop_flag_ = true;
+    if (thread_.joinable()) {
+      thread_.join();
+    }
+    if (fd_ >= 0) {
+      close(fd_);
+    }
+  }
+
+  bool Initialize() override {
+    const std::string prefix = "message.serial";
+    device_ = cfg.Get<std::string>({prefix, "device"});
+    baud_rate_ = serial_link::BaudRate(cfg.Get<int>({prefix, "baud_rate"}));
+    if (baud_rate_ == B0) {
+      LOG(ERROR) << "Unsupported baud rate for serial " << device_ << ".";
+      return false;
+    }
+    const int fd = Open();
+    if (fd < 0) {
+      return false;
+    }
+    fd_ = fd;
+    thread_ = std::thread([this] { ReceiveLoop(); });
+    return true;
+  }
+
+  /// 串口当前是否打开，断开后由接收线程自动重新打开
+  bool Connect(bool flag) override { return fd_ >= 0; }
+
+  bool Send() override {
+    const size_t size = send_buffer_.Size();
+    std::lock_guard lock{tx_lock_};
+    if (fd_ < 0 || size > serial_link::kMaxPayload) {
+      LOG_EVERY_N(ERROR, 100) << "Failed to send " << size << " bytes through serial"
+                              << (fd_ < 0 ? ", serial is disconnected." : ".");
+      send_buffer_.Clear();
+      return false;
+    }
+    std::array<uint8_t, serial_link::kMaxDecoded> decoded;
+    std::memcpy(decoded.data(), send_buffer_.Ptr(), size);
+    const uint16_t crc = serial_link::Crc16(decoded.data(), size);
+    std::memcpy(decoded.data() + size, &crc, sizeof(crc));
+    send_buffer_.Clear();
+
+    /// 上一帧还没写完时先写完上一帧，写不完则本帧替换排队中的帧
+    const bool idle = Flush();
+    queued_size_ = serial_link::CobsEncode(decoded.data(), size + sizeof(crc), queued_.data());
+    queued_[queued_size_++] = 0;
+    if (!idle) {
+      ++coalesced_;
+      return true;
+    }
+    return Flush();
+  }
+
+  /**
+   * @brief 读取最新收到的一帧，不会阻塞
+   * @return 是否有可用数据，没有新数据时保留上一次的数据
+   */
+  bool Receive() override {
+    std::lock_guard lock{rx_lock_};
+    if (rx_seq_ != last_) {
+      last_ = rx_seq_;
+      receive_time_stamp_ = rx_time_stamp_;
+      Split(reinterpret_cast<const char *>(rx_frame_.data()), rx_size_);
+    }
+    return last_ != 0;
+  }
+
+  bool Wait(const std::chrono::nanoseconds timeout) override {
+    std::unique_lock lock{rx_lock_};
+    return rx_cv_.wait_for(lock, timeout, [this] { return rx_seq_ != last_; });
+  }
+
+  /// 因发送繁忙被合并丢弃的帧数
+  [[nodiscard]] uint64_t Coalesced() const { return coalesced_; }
+
+  /// 校验失败的帧数
+  [[nodiscard]] uint64_t Corrupted() const { return corrupted_.load(std::memory_order_relaxed); }
+
+ private:
+  /**
+   * @brief 打开串口并设置为原始模式
+   * @return 文件描述符，失败时为 -1
+   */
+  [[nodiscard]] int Open() const {
+    const int fd = open(device_.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (fd < 0) {
+      LOG_EVERY_N(ERROR, 20) << "Failed to open serial " << device_ << ": " << std::strerror(errno);
+      return -1;
+    }
+    termios tty{};
+    if (tcgetattr(fd, &tty) != 0) {
+      LOG(ERROR) << "Failed to get attributes of serial " << device_ << ".";
+      close(fd);
+      return -1;
+    }
+    cfmakeraw(&tty);
+    tty.c_cflag |= CLOCAL | CREAD;
+    tty.c_cflag &= ~CRTSCTS;
+    tty.c_cc[VMIN] = 0;
+    tty.c_cc[VTIME] = 0;
+    cfsetispeed(&tty, baud_rate_);
+    cfsetospeed(&tty, baud_rate_);
+    if (tcsetattr(fd, TCSANOW, &tty) != 0) {
+      LOG(ERROR) << "Failed to set attributes of serial " << device_ << ".";
+      close(fd);
+      return -1;
+    }
+    tcflush(fd, TCIOFLUSH);
+    return fd;
+  }
+
+  /**
+   * @brief 关闭已断开的串口，丢弃未写出的数据
+   * @param [in] reason 断开原因，用于日志
+   */
+  void Disconnect(std::string REF_IN reason) {
+    std::lock_guard lock{tx_lock_};
+    LOG(WARNING) << "Serial " << device_ << " is disconnected (" << reason << "), reopening every "
+                 << serial_link::kReopenInterval << " ms.";
+    close(fd_);
+    fd_ = -1;
+    sending_offset_ = sending_size_ = queued_size_ = 0;
+  }
+
+  /**
+   * @brief 尽可能写出发送中和排队中的数据，不会阻塞，调用时须持有 tx_lock_
+   * @return 是否全部写出
+   */
+  bool Flush() {
+    while (sending_offset_ < sending_size_ || queued_size_) {
+      if (sending_offset_ == sending_size_) {
+        std::swap(sending_, queued_);
+        sending_size_ = std::exchange(queued_size_, 0);
+        sending_offset_ = 0;
+      }
+      const auto written = write(fd_, sending_.data() + sending_offset_, sending_size_ - sending_offset_);
+      if (written < 0) {
+        if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+          LOG_EVERY_N(ERROR, 100) << "Failed to write serial: " << std::strerror(errno);
+          sending_offset_ = sending_size_;
+        }
+        return false;
+      }
+      sending_offset_ += written;
+    }
+    return true;
+  }
+
+  /// 接收线程，按 0x00 分帧，解码并校验后保存为最新一帧，串口断开时关闭并定期重新打开
+  void ReceiveLoop() {
+    std::array<uint8_t, 256> buffer;
+    std::array<uint8_t, serial_link::kMaxEncoded> encoded;
+    std::array<uint8_t, serial_link::kMaxEncoded> decoded;
+    size_t encoded_size = 0;
+    bool overflow = false;
+    while (!stop_flag_) {
+      if (fd_ < 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(serial_link::kReopenInterval));
+        if (const int fd = Open(); fd >= 0) {
+          std::lock_guard lock{tx_lock_};
+          fd_ = fd;
+          encoded_size = 0;
+          overflow = false;
+          LOG(INFO) << "Serial " << device_ << " is reopened.";
+        }
+        continue;
+      }
+      pollfd pfd{fd_, POLLIN, 0};
+      const int ready = poll(&pfd, 1, serial_link::kPollTimeout);
+      if (ready < 0 && errno != EINTR) {
+        Disconnect(std::strerror(errno));
+        continue;
+      }
+      if (ready <= 0) {
+        continue;
+      }
+      /// 拔出 USB 时 poll 持续返回 POLLHUP 或 POLLERR，不关闭就会空转
+      if (!(pfd.revents & POLLIN) && (pfd.revents & (POLLHUP | POLLERR | POLLNVAL))) {
+        Disconnect(pfd.revents & POLLNVAL ? "invalid descriptor" : pfd.revents & POLLHUP ? "hang up" : "error");
+        continue;
+      }
+      const auto n = read(fd_, buffer.data(), buffer.size());
+      if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+        continue;
+      }
+      if (n <= 0) {
+        Disconnect(n ? std::strerror(errno) : "end of file");
+        continue;
+      }
+      for (ssize_t i = 0; i < n; ++i) {
+        if (buffer[i]) {
+          if (encoded_size < encoded.size()) {
+            encoded[encoded_size++] = buffer[i];
+          } else {
+            overflow = true;
+          }
+          continue;
+        }
+        /// 一帧结束
+        const size_t size = overflow ? 0 : serial_link::CobsDecode(encoded.data(), encoded_size, decoded.data());
+        const bool empty = !encoded_size;
+        encoded_size = 0;
+        overflow = false;
+        uint16_t crc;
+        if (size <= sizeof(crc)) {
+          /// 连续的 0x00 是空帧，不算校验失败
+          corrupted_.fetch_add(empty ? 0 : 1, std::memory_order_relaxed);
+          continue;
+        }
+        std::memcpy(&crc, decoded.data() + size - sizeof(crc), sizeof(crc));
+        if (crc != serial_link::Crc16(decoded.data(), size - sizeof(crc))) {
+          corrupted_.fetch_add(1, std::memory_order_relaxed);
+          continue;
+        }
+        {
+          std::lock_guard lock{rx_lock_};
+          rx_size_ = std::min(size - sizeof(crc), serial_link::kMaxPayload);
+          std::memcpy(rx_frame_.data(), decoded.data(), rx_size_);
+          rx_time_stamp_ = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                               std::chrono::steady_clock::now().time_since_epoch())
+                               .count();
+          ++rx_seq_;
+        }
+        rx_cv_.notify_all();
+      }
+    }
+  }
+
+  std::string device_;      ///< 串口设备
+  speed_t baud_rate_{};     ///< 波特率
+  std::atomic_int fd_{-1};  ///< 串口文件描述符，断开时为 -1，只由接收线程修改
+  std::mutex tx_lock_;      ///< 发送锁，防止接收线程重新打开串口时与发送同时进行
+
+  std::array<uint8_t, serial_link::kMaxEncoded> sending_{};  ///< 正在发送的帧
+  size_t sending_size_{};                                    ///< 正在发送的帧长度
+  size_t sending_offset_{};                                  ///< 正在发送的帧已写出的长度
+  std::array<uint8_t, serial_link::kMaxEncoded> queued_{};   ///< 排队中的帧，只保留最新一帧
+  size_t queued_size_{};                                     ///< 排队中的帧长度
+  uint64_t coalesced_{};                                     ///< 被合并丢弃的帧数
+
+  std::array<uint8_t, serial_link::kMaxPayload> rx_frame_{};  ///< 最新收到的一帧
+  size_t rx_size_{};                                          ///< 最新收到的一帧的长度
+  uint64_t rx_time_stamp_{};                                  ///< 最新收到的一帧的时间戳
+  uint64_t rx_seq_{};                                         ///< 收到的帧数
+  uint64_t last_{};                                           ///< Receive 最近一次读到的帧序号
+  std::atomic<uint64_t> corrupted_{};                         ///< 校验失败的帧数
+  std::mutex rx_lock_;                                        ///< 最新一帧的锁
+  std::condition_variable rx_cv_;                             ///< 新帧通知
+  std::atomic<bool> stop_flag_{};                             ///< 接收线程停止信号
+  std::thread thread_;                                        ///< 接收线程
+};
+
+}  // namespace srm::message
+
+#endif  // SRM_MESSAGE_MESSAGE_SERIAL_HPP_
@@ -0,0 +1,122 @@
+#ifndef SRM_MESSAGE_PACKET_LAYOUT_HPP_
+#define SRM_MESSAGE_PACKET_LAYOUT_HPP_
+
+#include <array>
+#include <cstring>
+#include <type_traits>
+
+namespace srm::message {
+
+/// 类型 T 在 Ts 中的序号，T 不在 Ts 中时为 sizeof...(Ts)
+template <typename T, typename... Ts>
+constexpr size_t kTypeIndex = [] {
+  constexpr std::array<bool, sizeof...(Ts)> match = {std::is_same_v<T, Ts>...};
+  for (size_t i = 0; i < match.size(); ++i) {
+    if (match[i]) {
+      return i;
+    }
+  }
+  return match.size();
+}();
+
+/**
+ * @brief 编译期类型列表，为每个数据包类型分配固定的类型序号
+ * @tparam kMtu 链路单帧最大字节数，每个类型连同编号都不能超过
+ * @tparam Ts 所有数据包类型
+ */
+template <size_t kMtu, typename... Ts>
+struct PacketTypeList {
+  static_assert((std::is_trivially_copyable_v<Ts> && ...), "Packet types must be trivially copyable.");
+  static_assert(((sizeof(short) + sizeof(Ts) <= kMtu) && ...), "Packet type does not fit the link MTU.");
+
+  static constexpr size_t kCount = sizeof...(Ts);  ///< 类型个数
+
+  /// 类型 T 的类型序号，T 不在列表中时为 kCount
+  template <typename T>
+  static constexpr size_t kIndex = kTypeIndex<T, Ts...>;
+};
+
+/**
+ * @brief 编译期确定的定长数据包布局
+ * @tparam Ts 数据包中依次排列的数据类型，顺序必须与注册顺序一致
+ * @details
+ * 字节流格式与 Packet 逐个写入时相同，每个数据前带 short 类型的编号：
+ * @code
+ * | id0 | Ts[0] | id1 | Ts[1] | ...
+ * @endcode
+ * 所有偏移和大小在编译期计算，读写时直接 memcpy 到对应位置，不需要中间容器和查表。
+ */
+template <typename... Ts>
+class PacketLayout {
+  static_assert(sizeof...(Ts) > 0, "Packet layout must not be empty.");
+  static_assert((std::is_trivially_copyable_v<Ts> && ...), "Packet types must be trivially copyable.");
+
+ public:
+  using Id = short;                                                      ///< 编号类型
+  static constexpr size_t kCount = sizeof...(Ts);                        ///< 数据个数
+  static constexpr std::array<size_t, kCount> kSizes = {sizeof(Ts)...};  ///< 各数据大小
+
+  /// 各数据编号所在的偏移，数据紧随编号之后
+  static constexpr std::array<size_t, kCount> kOffsets = [] {
+    std::array<size_t, kCount> offsets{};
+    size_t offset = 0;
+    for (size_t i = 0; i < kCount; ++i) {
+      offsets[i] = offset;
+      offset += sizeof(Id) + kSizes[i];
+    }
+    return offsets;
+  }();
+
+  static constexpr size_t kSize = kOffsets.back() + sizeof(Id) + kSizes.back();  ///< 数据包总大小
+
+  using Ids = std::array<Id, kCount>;  ///< 按布局顺序排列的编号
+
+  /// 类型 T 在布局中的序号，T 不在布局中时为 kCount
+  template <typename T>
+  static constexpr size_t kIndex = kTypeIndex<T, Ts...>;
+
+  /**
+   * @brief 在数据包中写入编号
+   * @param [out] frame 数据包首地址，至少 kSize 字节
+   * @param [in] ids 按布局顺序排列的编号
+   */
+  static void Stamp(char *frame, const Ids &ids) {
+    for (size_t i = 0; i < kCount; ++i) {
+      std::memcpy(frame + kOffsets[i], &ids[i], sizeof(Id));
+    }
+  }
+
+  /**
+   * @brief 检查数据包中的编号是否与布局一致
+   * @param [in] frame 数据包首地址，至少 kSize 字节
+   * @param [in] ids 按布局顺序排列的编号
+   */
+  static bool Match(const char *frame, const Ids &ids) {
+    for (size_t i = 0; i < kCount; ++i) {
+      Id id;
+      std::memcpy(&id, frame + kOffsets[i], sizeof(Id));
+      if (id != ids[i]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /// 写入数据到其在数据包中的位置
+  template <typename T>
+  static void Put(char *frame, const T &data) {
+    static_assert(kIndex<T> < kCount, "Type is not part of this packet layout.");
+    std::memcpy(frame + kOffsets[kIndex<T>] + sizeof(Id), &data, sizeof(T));
+  }
+
+  /// 从数据在数据包中的位置读出数据
+  template <typename T>
+  static void Get(const char *frame, T &data) {
+    static_assert(kIndex<T> < kCount, "Type is not part of this packet layout.");
+    std::memcpy(&data, frame + kOffsets[kIndex<T>] + sizeof(Id), sizeof(T));
+  }
+};
+
+}  // namespace srm::message
+
+#endif  // SRM_MESSAGE_PACKET_LAYOUT_HPP_
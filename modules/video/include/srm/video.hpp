@@ -2,8 +2,19 @@
 #define SRM_VIDEO_HPP_
 
 #include "srm/video/camera.h"
+#include "srm/video/exposure-controller.hpp"
 #include "srm/video/frame.hpp"
+#include "srm/video/raw-dump.hpp"
+#include "srm/video/reader-directory.hpp"
+#include "srm/video/reader-managed.hpp"
+#include "srm/video/reader-parallel.hpp"
+#include "srm/video/reader-prefetch.hpp"
+#include "srm/video/reader-raw.hpp"
+#include "srm/video/reader-replay.hpp"
+#include "srm/video/reader-synthetic.hpp"
 #include "srm/video/reader.h"
-#include "srm/video/writer.h"
+#include "srm/video/recorder.hpp"
+#include "srm/video/session.hpp"
+#include "srm/video/writer-adaptive.hpp"
 
 #endif  // SRM_VIDEO_HPP_
\ No newline at end of file
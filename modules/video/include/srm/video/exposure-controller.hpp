@@ -0,0 +1,270 @@
+#ifndef SRM_VIDEO_EXPOSURE_CONTROLLER_HPP_
+#define SRM_VIDEO_EXPOSURE_CONTROLLER_HPP_
+
+#if defined(__linux__)
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "srm/common/config.hpp"
+#include "srm/video/frame.hpp"
+
+namespace srm::video {
+
+/**
+ * @brief 自动曝光控制器
+ * @details
+ * 统计区域为自瞄当前识别到的目标：每个目标的外接矩形向四周扩展 margin 倍后，控制器在后台低优先级线程中对其稀疏采样
+ * （行列每隔 sample_step 取一个像素，彩色图像取三个通道中的最大值；单通道图像可能是 Bayer 原始数据，
+ * 按 2×2 的 CFA 单元采样并取单元内的最大值，采样间隔向上取偶数，保证每次采样都覆盖全部颜色）。灯条是目标附近最亮的部分，
+ * 统计直方图中最亮的 bright_ratio 比例像素的下限作为灯条亮度，使其接近 target_level，
+ * 同时限制饱和像素的比例，避免灯条过曝后与底板粘连。没有目标时保持当前曝光，不会被背景中的灯光带偏，
+ * 因此初始曝光应保证能识别到目标。
+ * 调节量为曝光时间与增益的乘积：变亮时先延长曝光，达到运动模糊限制 max_exposure 后再提高增益；变暗时先降低增益。
+ * Feed 只在后台线程空闲且到达控制间隔时取走图像的引用，不复制也不等待，因此不会阻塞取图线程。
+ */
+class ExposureController final {
+  static constexpr int kSaturation = 250;  ///< 视为饱和的像素值
+
+ public:
+  /// 设置曝光时间（单位 us）和增益（单位 dB）的函数，返回是否设置成功
+  using Apply = std::function<bool(uint32_t, float)>;
+
+  ExposureController() = default;
+  ~ExposureController() { Stop(); }
+
+  /// 停止后台线程，之后不再调用设置相机参数的函数
+  void Stop() {
+    {
+      std::lock_guard lock{lock_};
+      stop_flag_ = true;
+    }
+    cv_.notify_all();
+    if (thread_.joinable()) {
+      thread_.join();
+    }
+  }
+
+  /**
+   * @brief 读取配置并启动后台线程
+   * @param [in] prefix 前置路径
+   * @param exposure 初始曝光时间，单位 us
+   * @param gain 初始增益，单位 dB
+   * @param apply 设置相机参数的函数，在后台线程中调用
+   * @return 是否启用，未启用时不需要调用 Feed
+   */
+  bool Initialize(std::string REF_IN prefix, const uint32_t exposure, const float gain, Apply apply) {
+    exposure_ = exposure;
+    gain_ = gain;
+    if (!cfg.Get<bool>({prefix, "enable"})) {
+      return false;
+    }
+    apply_ = std::move(apply);
+    interval_ = std::chrono::milliseconds(cfg.Get<int>({prefix, "interval"}));
+    sample_step_ = std::max(1, cfg.Get<int>({prefix, "sample_step"}));
+    margin_ = std::max(0.0, cfg.Get<double>({prefix, "margin"}));
+    target_level_ = cfg.Get<double>({prefix, "target_level"});
+    bright_ratio_ = cfg.Get<double>({prefix, "bright_ratio"});
+    max_saturation_ = cfg.Get<double>({prefix, "max_saturation"});
+    deadband_ = cfg.Get<double>({prefix, "deadband"});
+    max_step_ = std::max(1.0, cfg.Get<double>({prefix, "max_step"}));
+    min_exposure_ = cfg.Get<int>({prefix, "min_exposure"});
+    max_exposure_ = cfg.Get<int>({prefix, "max_exposure"});
+    min_gain_ = cfg.Get<double>({prefix, "min_gain"});
+    max_gain_ = cfg.Get<double>({prefix, "max_gain"});
+    if (target_level_ <= 0 || target_level_ >= 255 || min_exposure_ <= 0 || max_exposure_ < min_exposure_ ||
+        max_gain_ < min_gain_) {
+      LOG(ERROR) << "Invalid exposure control parameters in " << prefix << ".";
+      return false;
+    }
+    thread_ = std::thread([this] { Work(); });
+    LOG(INFO) << "Exposure control is enabled, exposure " << exposure_ << " us, gain " << gain_ << " dB.";
+    return true;
+  }
+
+  /**
+   * @brief 更新统计区域为当前识别到的目标，每帧识别后调用，没有目标时传入空列表
+   * @param [in] boxes 目标的外接矩形，单位像素，与 Feed 的图像坐标一致
+   */
+  void SetTargets(std::vector<cv::Rect> REF_IN boxes) {
+    std::lock_guard lock{lock_};
+    targets_ = boxes;
+  }
+
+  /**
+   * @brief 提交一帧用于统计，后台线程忙、未到控制间隔或没有目标时直接返回
+   * @param [in] frame 帧数据
+   */
+  void Feed(Frame REF_IN frame) {
+    const auto now = std::chrono::steady_clock::now();
+    if (!thread_.joinable() || now < next_time_) {
+      return;
+    }
+    std::unique_lock lock{lock_, std::try_to_lock};
+    if (!lock.owns_lock() || !image_.empty() || targets_.empty()) {
+      return;
+    }
+    next_time_ = now + interval_;
+    image_ = frame.image;
+    rois_ = targets_;
+    lock.unlock();
+    cv_.notify_one();
+  }
+
+  /// 当前曝光时间，单位 us
+  [[nodiscard]] uint32_t Exposure() const { return exposure_; }
+
+  /// 当前增益，单位 dB
+  [[nodiscard]] float Gain() const { return gain_; }
+
+ private:
+  /// 后台线程
+  void Work() {
+#if defined(__linux__)
+    /// 降低本线程的调度优先级，计算资源紧张时让位于取图和识别
+    setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), 10);
+#endif
+    std::vector<cv::Rect> rois;
+    while (true) {
+      cv::Mat image;
+      {
+        std::unique_lock lock{lock_};
+        cv_.wait(lock, [this] { return stop_flag_ || !image_.empty(); });
+        if (stop_flag_) {
+          return;
+        }
+        image = image_;
+        rois.swap(rois_);
+      }
+      Update(image, rois);
+      std::lock_guard lock{lock_};
+      image_.release();
+    }
+  }
+
+  /// 稀疏采样一个目标区域的亮度直方图，累加到 histogram_ 中
+  void Sample(cv::Mat REF_IN image, cv::Rect REF_IN box) {
+    const int dx = static_cast<int>(margin_ * box.width);
+    const int dy = static_cast<int>(margin_ * box.height);
+    const cv::Rect expanded(box.x - dx, box.y - dy, box.width + 2 * dx, box.height + 2 * dy);
+    const cv::Rect roi = expanded & cv::Rect(0, 0, image.cols, image.rows);
+    if (image.channels() == 3) {
+      for (int y = roi.y; y < roi.y + roi.height; y += sample_step_) {
+        const uint8_t *row = image.ptr<uint8_t>(y) + roi.x * 3;
+        const uint8_t *end = row + roi.width * 3;
+        for (; row < end; row += sample_step_ * 3) {
+          ++histogram_[std::max({row[0], row[1], row[2]})];
+        }
+      }
+      return;
+    }
+    /// 单通道图像按 2×2 单元采样，起点对齐到偶数坐标，不论 Bayer 排列如何，每个单元都包含全部颜色
+    const int step = (sample_step_ + 1) & ~1;
+    const int x_end = std::min(roi.x + roi.width, image.cols - 1);
+    const int y_end = std::min(roi.y + roi.height, image.rows - 1);
+    for (int y = roi.y & ~1; y < y_end; y += step) {
+      const uint8_t *row0 = image.ptr<uint8_t>(y);
+      const uint8_t *row1 = image.ptr<uint8_t>(y + 1);
+      for (int x = roi.x & ~1; x < x_end; x += step) {
+        ++histogram_[std::max({row0[x], row0[x + 1], row1[x], row1[x + 1]})];
+      }
+    }
+  }
+
+  /// 根据一帧中各目标区域的统计结果调节曝光和增益，区域重叠时重复计数，不影响亮度的分位数估计
+  void Update(cv::Mat REF_IN image, std::vector<cv::Rect> REF_IN rois) {
+    if (image.depth() != CV_8U || (image.channels() != 1 && image.channels() != 3)) {
+      return;
+    }
+    histogram_.fill(0);
+    for (const auto &box : rois) {
+      Sample(image, box);
+    }
+    uint64_t total = 0, saturated = 0;
+    for (int i = 0; i < 256; ++i) {
+      total += histogram_[i];
+      saturated += i >= kSaturation ? histogram_[i] : 0;
+    }
+    if (!total) {
+      return;
+    }
+    /// 灯条亮度：最亮的 bright_ratio 比例像素中的最小值
+    const auto bright_count = static_cast<uint64_t>(std::ceil(bright_ratio_ * static_cast<double>(total)));
+    int level = 255;
+    uint64_t count = histogram_[level];
+    while (level > 0 && count < bright_count) {
+      count += histogram_[--level];
+    }
+    const double saturation = static_cast<double>(saturated) / static_cast<double>(total);
+
+    /// 所需的亮度倍数，饱和时像素值不再反映真实亮度，按比例压暗
+    double scale = target_level_ / std::max(level, 1);
+    if (saturation > max_saturation_) {
+      scale = std::min(scale, 1 / std::sqrt(max_step_));
+    } else if (std::abs(std::log(scale)) < deadband_) {
+      return;
+    }
+    scale = std::clamp(scale, 1 / max_step_, max_step_);
+
+    /// 曝光时间与增益的乘积为总亮度，优先使用曝光时间，超过运动模糊限制的部分由增益补足
+    const double brightness = exposure_ * std::pow(10.0, gain_ / 20.0) * scale;
+    const double exposure = std::clamp(brightness / std::pow(10.0, min_gain_ / 20.0),
+                                       static_cast<double>(min_exposure_), static_cast<double>(max_exposure_));
+    const auto gain = static_cast<float>(std::clamp(20 * std::log10(brightness / exposure), min_gain_, max_gain_));
+    const auto exposure_us = static_cast<uint32_t>(std::lround(exposure));
+    if (exposure_us == exposure_ && std::abs(gain - gain_) < 0.1f) {
+      return;
+    }
+    if (!apply_(exposure_us, gain)) {
+      LOG_EVERY_N(WARNING, 10) << "Failed to apply exposure " << exposure_us << " us, gain " << gain << " dB.";
+      return;
+    }
+    DLOG(INFO) << "Exposure " << exposure_ << " -> " << exposure_us << " us, gain " << gain_ << " -> " << gain
+               << " dB, level " << level << ", saturation " << saturation << ".";
+    exposure_ = exposure_us;
+    gain_ = gain;
+  }
+
+  Apply apply_;                                      ///< 设置相机参数的函数
+  std::chrono::milliseconds interval_{};             ///< 控制间隔
+  std::chrono::steady_clock::time_point next_time_;  ///< 下一次接受图像的时间，只在取图线程中使用
+  int sample_step_{1};                               ///< 采样间隔，单位像素，单通道图像向上取偶数
+  double margin_{};                                  ///< 目标外接矩形向四周扩展的比例
+  double target_level_{};                            ///< 灯条亮度的目标值
+  double bright_ratio_{};                            ///< 灯条像素占采样像素的比例
+  double max_saturation_{};                          ///< 饱和像素比例的上限
+  double deadband_{};                                ///< 亮度对数误差的死区
+  double max_step_{};                                ///< 单次调节的最大倍数
+  int min_exposure_{};                               ///< 最短曝光时间，单位 us
+  int max_exposure_{};                               ///< 最长曝光时间，即运动模糊限制，单位 us
+  double min_gain_{};                                ///< 最小增益，单位 dB
+  double max_gain_{};                                ///< 最大增益，单位 dB
+  std::atomic_uint32_t exposure_{};                  ///< 当前曝光时间，单位 us
+  std::atomic<float> gain_{};                        ///< 当前增益，单位 dB
+  std::array<uint32_t, 256> histogram_{};            ///< 亮度直方图
+
+  std::vector<cv::Rect> targets_;  ///< 最近一帧识别到的目标
+  cv::Mat image_;                  ///< 待统计的图像，为空表示后台线程空闲
+  std::vector<cv::Rect> rois_;     ///< 待统计图像对应的目标区域
+  std::mutex lock_;                ///< 图像和目标的锁
+  std::condition_variable cv_;     ///< 图像通知
+  bool stop_flag_{};               ///< 停止信号
+  std::thread thread_;             ///< 后台线程
+};
+
+}  // namespace srm::video
+
+#endif  // SRM_VIDEO_EXPOSURE_CONTROLLER_HPP_
@@ -0,0 +1,407 @@
+#ifndef SRM_VIDEO_RAW_DUMP_HPP_
+#define SRM_VIDEO_RAW_DUMP_HPP_
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+#include <condition_variable>
+#include <cstring>
+#include <cstdlib>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include "srm/common/image-format.hpp"
+#include "srm/video/session.hpp"
+
+namespace srm::video {
+
+/**
+ * @brief 原始帧转储文件格式
+ * @details
+ * 比赛中只把未压缩的图像按固定大小的槽位顺序写入预先分配好的文件，几乎不占用 CPU：
+ * @code
+ * RawDumpHeader（填充到 kAlignment）
+ * 槽位 0：RawDumpSlotHeader | 接收数据包 | 发送数据包 | SessionDetection * n（填充到 kAlignment）| 图像（填充到 kAlignment）
+ * 槽位 1：...
+ * @endcode
+ * 所有槽位大小相同，可按序号直接定位；RawDumpHeader::count 在关闭时写入，未正常关闭时为 0，
+ * 此时以槽位头中的标识判断槽位是否有效。
+ */
+namespace raw_dump {
+
+constexpr std::array<char, 4> kFileMagic = {'S', 'R', 'M', 'D'};  ///< 文件头标识
+constexpr std::array<char, 4> kSlotMagic = {'S', 'L', 'O', 'T'};  ///< 槽位标识
+constexpr uint32_t kVersion = 2;                                  ///< 文件格式版本，2 起文件头记录像素格式
+constexpr size_t kAlignment = 4096;                               ///< 直接 IO 的对齐大小
+constexpr size_t kMetaSize = kAlignment;                          ///< 每个槽位中元数据区的大小
+
+/// 向上对齐到 kAlignment
+constexpr size_t Align(const size_t size) { return (size + kAlignment - 1) / kAlignment * kAlignment; }
+
+}  // namespace raw_dump
+
+/// 原始帧转储文件头
+struct RawDumpHeader {
+  std::array<char, 4> magic = raw_dump::kFileMagic;  ///< 文件头标识
+  uint32_t version = raw_dump::kVersion;             ///< 文件格式版本
+  uint32_t cols{};                                   ///< 图像宽度
+  uint32_t rows{};                                   ///< 图像高度
+  uint32_t image_type{};                             ///< 图像的 OpenCV 类型
+  uint32_t pixel_format{};                           ///< 图像的像素格式 PixelFormat
+  uint64_t image_size{};                             ///< 每帧图像数据大小
+  uint64_t slot_size{};                              ///< 每个槽位大小
+  uint64_t capacity{};                               ///< 预分配的槽位数量
+  uint64_t count{};                                  ///< 实际写入的帧数量，未正常关闭时为 0
+};
+
+/// 槽位头
+struct RawDumpSlotHeader {
+  std::array<char, 4> magic = raw_dump::kSlotMagic;  ///< 槽位标识
+  uint32_t receive_size{};                           ///< 接收数据包大小
+  uint64_t index{};                                  ///< 帧序号
+  uint64_t time_stamp{};                             ///< 帧时间戳，单位 ns
+  uint32_t send_size{};                              ///< 发送数据包大小
+  uint32_t detection_count{};                        ///< 识别结果数量
+};
+
+/**
+ * @brief 原始帧转储类
+ * @details
+ * 打开时用 fallocate 一次性分配整个文件，避免写入过程中文件系统分配块；
+ * 写入使用 O_DIRECT 绕过页缓存，数据从对齐的槽位缓冲区直接提交给磁盘，调用线程只做一次内存复制。
+ * 可选地在最低调度优先级（SCHED_IDLE）的线程中，跟在写入进度之后把已写入的帧转换为 BGR 并压缩为会话文件，
+ * 只使用空闲的 CPU 时间。关闭时默认取消尚未完成的压缩，不阻塞退出，未压缩的帧仍可由 raw 视频源从转储文件回放。
+ */
+class RawDumpWriter final {
+  static constexpr size_t kSlotCount = 16;  ///< 槽位缓冲区数量
+
+ public:
+  RawDumpWriter() = default;
+  ~RawDumpWriter() { Close(); }
+
+  /**
+   * @brief 创建并预分配转储文件
+   * @param [in] file 文件路径
+   * @param frame_size 图像长宽大小
+   * @param pixel_format 图像的像素格式，决定图像的 OpenCV 类型
+   * @param budget 预分配的文件大小上限，单位字节，槽位数量由此和单帧大小算出，写满后丢弃新帧
+   * @param [in] session_file 后台压缩的输出会话文件，为空时不压缩
+   * @param quality 后台压缩的 JPEG 质量
+   * @return 是否创建成功
+   */
+  bool Open(std::string REF_IN file, const cv::Size frame_size, const PixelFormat pixel_format, const uint64_t budget,
+            std::string REF_IN session_file, const int quality) {
+    const int image_type = PixelFormatType(pixel_format);
+    header_.cols = frame_size.width;
+    header_.rows = frame_size.height;
+    header_.image_type = image_type;
+    header_.pixel_format = static_cast<uint32_t>(pixel_format);
+    header_.image_size = frame_size.area() * CV_ELEM_SIZE(image_type);
+    header_.slot_size = raw_dump::kMetaSize + raw_dump::Align(header_.image_size);
+    header_.capacity = budget > raw_dump::kAlignment ? (budget - raw_dump::kAlignment) / header_.slot_size : 0;
+    static_assert(sizeof(RawDumpHeader) <= raw_dump::kAlignment);
+    if (!header_.capacity) {
+      LOG(ERROR) << "Raw dump budget of " << (budget >> 20) << " MB is less than one frame of "
+                 << (header_.slot_size >> 10) << " KB.";
+      return false;
+    }
+
+#if defined(__linux__)
+    fd_ = ::open(file.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_DIRECT, 0644);
+#else
+    fd_ = ::open(file.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+#endif
+    if (fd_ < 0) {
+      LOG(ERROR) << "Failed to create raw dump " << file << ".";
+      return false;
+    }
+    const auto file_size = static_cast<off_t>(raw_dump::kAlignment + header_.capacity * header_.slot_size);
+#if defined(__linux__)
+    const bool allocated = ::fallocate(fd_, 0, 0, file_size) == 0;
+#else
+    fcntl(fd_, F_NOCACHE, 1);
+    const bool allocated = ::ftruncate(fd_, file_size) == 0;
+#endif
+    if (!allocated) {
+      LOG(ERROR) << "Failed to allocate " << (file_size >> 20) << " MB for raw dump. Please check your disk space.";
+      Release();
+      return false;
+    }
+
+    for (size_t i = 0; i < kSlotCount + 1; ++i) {
+      void *buffer = nullptr;
+      if (posix_memalign(&buffer, raw_dump::kAlignment, header_.slot_size) != 0) {
+        LOG(ERROR) << "Failed to allocate aligned buffer for raw dump.";
+        Release();
+        return false;
+      }
+      std::memset(buffer, 0, header_.slot_size);
+      buffers_.emplace_back(static_cast<char *>(buffer));
+    }
+    /// 最后一个缓冲区用于写文件头
+    for (size_t i = 0; i < kSlotCount; ++i) {
+      free_.push_back(buffers_[i].get());
+    }
+    if (!WriteHeader()) {
+      Release();
+      return false;
+    }
+
+    /// 所有可能失败的步骤都在启动线程之前完成，失败时只需释放资源
+    if (!session_file.empty()) {
+      reader_fd_ = ::open(file.c_str(), O_RDONLY);
+      if (reader_fd_ < 0 || !session_writer_.Open(session_file, frame_size, 8 << 20)) {
+        LOG(ERROR) << "Failed to open " << session_file << " for background compression of raw dump.";
+        Release();
+        return false;
+      }
+      quality_ = quality;
+      compressor_ = std::thread([this] { Compress(); });
+    }
+    writer_ = std::thread([this] { Flush(); });
+    LOG(INFO) << "Raw dump is recording to " << file << " with " << header_.capacity << " slots of "
+              << (header_.slot_size >> 10) << " KB.";
+    return true;
+  }
+
+  /**
+   * @brief 将图像复制到对齐的槽位缓冲区中
+   * @param [in] image 原始图像，大小和类型须与打开时一致
+   * @return 是否得到槽位，缓冲区用尽或文件写满时返回假并计入丢帧
+   */
+  bool Stage(cv::Mat REF_IN image) {
+    if (image.size() != cv::Size(static_cast<int>(header_.cols), static_cast<int>(header_.rows)) ||
+        image.type() != static_cast<int>(header_.image_type)) {
+      LOG_EVERY_N(ERROR, 100) << "Frame does not match the layout of raw dump.";
+      return false;
+    }
+    /// 上一次暂存后没有提交时直接复用该槽位
+    if (!staged_) {
+      std::lock_guard lock{lock_};
+      if (stop_flag_ || free_.empty() || submitted_ >= header_.capacity) {
+        ++dropped_;
+        LOG_EVERY_N(WARNING, 100) << "Raw dump is full or falling behind, " << dropped_ << " frames are dropped.";
+        return false;
+      }
+      staged_ = free_.front();
+      free_.pop_front();
+    }
+    cv::Mat slot_image(image.size(), image.type(), staged_ + raw_dump::kMetaSize);
+    image.copyTo(slot_image);
+    return true;
+  }
+
+  /**
+   * @brief 写入已暂存帧的其余数据并提交写盘，立即返回
+   * @param [in] record 帧的其余数据，其中的图像会被忽略
+   */
+  void Commit(SessionRecord REF_IN record) {
+    if (!staged_) {
+      return;
+    }
+    char *slot = std::exchange(staged_, nullptr);
+    const size_t meta_size = sizeof(RawDumpSlotHeader) + record.receive.size() + record.send.size() +
+                             record.detections.size() * sizeof(SessionDetection);
+    RawDumpSlotHeader slot_header;
+    slot_header.time_stamp = record.time_stamp;
+    slot_header.receive_size = record.receive.size();
+    slot_header.send_size = record.send.size();
+    /// 元数据区放不下时舍弃多余的识别结果
+    slot_header.detection_count =
+        meta_size <= raw_dump::kMetaSize
+            ? record.detections.size()
+            : (raw_dump::kMetaSize - sizeof(RawDumpSlotHeader) - record.receive.size() - record.send.size()) /
+                  sizeof(SessionDetection);
+    std::unique_lock lock{lock_};
+    slot_header.index = submitted_++;
+    lock.unlock();
+    auto *ptr = std::copy_n(reinterpret_cast<const char *>(&slot_header), sizeof(slot_header), slot);
+    ptr = std::copy(record.receive.begin(), record.receive.end(), ptr);
+    ptr = std::copy(record.send.begin(), record.send.end(), ptr);
+    std::copy_n(reinterpret_cast<const char *>(record.detections.data()),
+                slot_header.detection_count * sizeof(SessionDetection), ptr);
+
+    lock.lock();
+    pending_.emplace_back(slot_header.index, slot);
+    lock.unlock();
+    cv_.notify_all();
+  }
+
+  /**
+   * @brief 等待已提交的帧全部写盘并关闭文件
+   * @param wait_compression 是否等待后台压缩完成，为假时取消压缩，只等待正在压缩的一帧
+   */
+  void Close(const bool wait_compression = false) {
+    {
+      std::lock_guard lock{lock_};
+      if (stop_flag_ || fd_ < 0) {
+        return;
+      }
+      stop_flag_ = true;
+      cancel_flag_ = !wait_compression;
+    }
+    cv_.notify_all();
+    if (writer_.joinable()) {
+      writer_.join();
+    }
+    cv_.notify_all();
+    header_.count = written_;
+    WriteHeader();
+    if (compressor_.joinable()) {
+      if (wait_compression) {
+        LOG(INFO) << "Waiting for background compression of raw dump, " << compressed_ << " of " << written_
+                  << " frames are done.";
+      }
+      compressor_.join();
+      session_writer_.Close();
+      LOG(INFO) << "Background compression of raw dump stopped at " << compressed_ << " of " << written_
+                << " frames.";
+    }
+    Release();
+    LOG(INFO) << "Raw dump is closed with " << written_ << " frames, " << dropped_ << " frames dropped.";
+  }
+
+  /// 因缓冲区用尽或文件写满丢弃的帧数
+  [[nodiscard]] uint64_t Dropped() {
+    std::lock_guard lock{lock_};
+    return dropped_;
+  }
+
+ private:
+  struct FreeDeleter {
+    void operator()(char *ptr) const { std::free(ptr); }
+  };
+
+  /// 关闭文件描述符并释放缓冲区，不涉及线程
+  void Release() {
+    if (fd_ >= 0) {
+      ::close(fd_);
+      fd_ = -1;
+    }
+    if (reader_fd_ >= 0) {
+      ::close(reader_fd_);
+      reader_fd_ = -1;
+    }
+    free_.clear();
+    buffers_.clear();
+  }
+
+  /// 将文件头写入文件起始的对齐块
+  bool WriteHeader() {
+    char *buffer = buffers_.back().get();
+    std::memset(buffer, 0, raw_dump::kAlignment);
+    std::memcpy(buffer, &header_, sizeof(header_));
+    if (::pwrite(fd_, buffer, raw_dump::kAlignment, 0) != static_cast<ssize_t>(raw_dump::kAlignment)) {
+      LOG(ERROR) << "Failed to write header of raw dump.";
+      return false;
+    }
+    return true;
+  }
+
+  /// 写入线程，按提交顺序将槽位写入文件
+  void Flush() {
+    while (true) {
+      std::unique_lock lock{lock_};
+      cv_.wait(lock, [this] { return !pending_.empty() || stop_flag_; });
+      if (pending_.empty()) {
+        return;
+      }
+      const auto [index, slot] = pending_.front();
+      pending_.pop_front();
+      lock.unlock();
+
+      const auto offset = static_cast<off_t>(raw_dump::kAlignment + index * header_.slot_size);
+      if (::pwrite(fd_, slot, header_.slot_size, offset) != static_cast<ssize_t>(header_.slot_size)) {
+        LOG_EVERY_N(ERROR, 100) << "Failed to write raw dump.";
+      }
+
+      lock.lock();
+      free_.push_back(slot);
+      ++written_;
+      lock.unlock();
+      cv_.notify_all();
+    }
+  }
+
+  /// 后台压缩线程，以最低调度优先级跟在写入进度之后把已写入的帧压缩为会话文件
+  void Compress() {
+#if defined(__linux__)
+    const sched_param param{0};
+    pthread_setschedparam(pthread_self(), SCHED_IDLE, &param);
+#endif
+    const auto pixel_format = static_cast<PixelFormat>(header_.pixel_format);
+    std::vector<char> slot(header_.slot_size);
+    std::vector<char> bytes;
+    cv::Mat bgr;
+    SessionRecord record;
+    while (true) {
+      {
+        std::unique_lock lock{lock_};
+        cv_.wait(lock, [this] {
+          return cancel_flag_ || compressed_ < written_ || (stop_flag_ && written_ == submitted_);
+        });
+        if (cancel_flag_ || compressed_ >= written_) {
+          return;
+        }
+      }
+      const auto offset = static_cast<off_t>(raw_dump::kAlignment + compressed_ * header_.slot_size);
+      if (::pread(reader_fd_, slot.data(), header_.slot_size, offset) != static_cast<ssize_t>(header_.slot_size)) {
+        LOG(ERROR) << "Failed to read raw dump for compression.";
+        return;
+      }
+      RawDumpSlotHeader slot_header;
+      std::memcpy(&slot_header, slot.data(), sizeof(slot_header));
+      const auto *ptr = slot.data() + sizeof(slot_header);
+      record.index = slot_header.index;
+      record.time_stamp = slot_header.time_stamp;
+      record.receive.assign(ptr, ptr + slot_header.receive_size);
+      ptr += slot_header.receive_size;
+      record.send.assign(ptr, ptr + slot_header.send_size);
+      ptr += slot_header.send_size;
+      record.detections.resize(slot_header.detection_count);
+      std::memcpy(record.detections.data(), ptr, slot_header.detection_count * sizeof(SessionDetection));
+      const cv::Mat image(static_cast<int>(header_.rows), static_cast<int>(header_.cols),
+                          static_cast<int>(header_.image_type), slot.data() + raw_dump::kMetaSize);
+      /// 会话文件总是保存 BGR 图像，与 Recorder 一致，Bayer 数据的 JPEG 无法再去马赛克
+      if (pixel_format == PixelFormat::kBgr8) {
+        record.image = image;
+      } else {
+        ToBgr(image, pixel_format, bgr);
+        record.image = bgr;
+      }
+      EncodeSessionRecord(record, SessionImageFormat::kJpeg, quality_, bytes);
+      session_writer_.Append(record.time_stamp, bytes);
+      std::lock_guard lock{lock_};
+      ++compressed_;
+    }
+  }
+
+  int fd_ = -1;                                              ///< 转储文件
+  RawDumpHeader header_;                                     ///< 文件头
+  std::vector<std::unique_ptr<char, FreeDeleter>> buffers_;  ///< 对齐的槽位缓冲区
+  std::deque<char *> free_;                                  ///< 空闲的槽位缓冲区
+  std::deque<std::pair<uint64_t, char *>> pending_;          ///< 等待写盘的槽位
+  std::mutex lock_;                                          ///< 队列锁
+  std::condition_variable cv_;                               ///< 队列通知
+  uint64_t submitted_{};                                     ///< 已接收的帧数
+  uint64_t written_{};                                       ///< 已写盘的帧数
+  uint64_t dropped_{};                                       ///< 丢弃的帧数
+  bool stop_flag_{};                                         ///< 停止信号
+  bool cancel_flag_{};                                       ///< 取消后台压缩的信号
+  char *staged_{};                                           ///< 已暂存图像、等待提交的槽位
+  std::thread writer_;                                       ///< 写入线程
+
+  int reader_fd_ = -1;            ///< 后台压缩读取转储文件使用的文件描述符
+  int quality_{};                 ///< 后台压缩的 JPEG 质量
+  uint64_t compressed_{};         ///< 已压缩的帧数
+  SessionWriter session_writer_;  ///< 后台压缩输出的会话文件
+  std::thread compressor_;        ///< 后台压缩线程
+};
+
+}  // namespace srm::video
+
+#endif  // SRM_VIDEO_RAW_DUMP_HPP_
@@ -0,0 +1,63 @@
+#ifndef SRM_VIDEO_READER_DIRECTORY_HPP_
+#define SRM_VIDEO_READER_DIRECTORY_HPP_
+
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <opencv2/imgcodecs.hpp>
+#include <string>
+#include <vector>
+
+#include "srm/video/reader-parallel.hpp"
+
+namespace srm::video {
+
+/**
+ * @brief 图像目录视频源
+ * @details
+ * 按文件名顺序读取目录中的所有图像（png、jpg、jpeg、bmp、tif、tiff），由多个线程并行解码。
+ * pixel_format 为 bgr8 时图像统一转换为 BGR 三通道，否则按单通道读取，用于 Bayer 原始数据集。
+ */
+class DirectoryReader final : public ParallelReader {
+  inline static auto registry = RegistrySub<Reader, DirectoryReader>("directory");
+
+ public:
+  DirectoryReader() = default;
+  ~DirectoryReader() override { Stop(); }
+
+  bool Initialize(std::string REF_IN prefix) override {
+    namespace fs = std::filesystem;
+    const auto directory = cfg.Get<std::string>({prefix, "directory"});
+    std::error_code error;
+    for (const auto &entry : fs::directory_iterator(directory, error)) {
+      auto extension = entry.path().extension().string();
+      std::ranges::transform(extension, extension.begin(), [](unsigned char c) { return std::tolower(c); });
+      if (entry.is_regular_file() && (extension == ".png" || extension == ".jpg" || extension == ".jpeg" ||
+                                      extension == ".bmp" || extension == ".tif" || extension == ".tiff")) {
+        files_.push_back(entry.path().string());
+      }
+    }
+    if (error) {
+      LOG(ERROR) << "Failed to list directory " << directory << ": " << error.message() << ".";
+      return false;
+    }
+    std::ranges::sort(files_);
+    if (!ParsePixelFormat(cfg.Get<std::string>({prefix, "pixel_format"}), pixel_format_)) {
+      return false;
+    }
+    return Start(prefix, files_.size());
+  }
+
+ private:
+  bool Load(const size_t index, cv::Mat REF_OUT image) override {
+    image = cv::imread(files_[index], pixel_format_ == PixelFormat::kBgr8 ? cv::IMREAD_COLOR : cv::IMREAD_GRAYSCALE);
+    return !image.empty();
+  }
+
+  std::vector<std::string> files_;  ///< 按文件名排序的图像路径
+  PixelFormat pixel_format_{};      ///< 输出的像素格式
+};
+
+}  // namespace srm::video
+
+#endif  // SRM_VIDEO_READER_DIRECTORY_HPP_
@@ -0,0 +1,316 @@
+#ifndef SRM_VIDEO_READER_MANAGED_HPP_
+#define SRM_VIDEO_READER_MANAGED_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "srm/common/config.hpp"
+#include "srm/video/exposure-controller.hpp"
+#include "srm/video/reader.h"
+
+namespace srm::video {
+
+/// 相机断流统计
+struct CameraOutage {
+  uint32_t count{};                  ///< 已恢复的断流次数
+  uint32_t reopen_count{};           ///< 重新打开相机的次数
+  std::chrono::nanoseconds last{};   ///< 最近一次断流的时长
+  std::chrono::nanoseconds max{};    ///< 最长一次断流的时长
+  std::chrono::nanoseconds total{};  ///< 断流总时长
+};
+
+/**
+ * @brief 自行管理相机对象的相机视频源
+ * @details
+ * 配置方式与 camera 视频源相同，但直接持有相机对象，因此可以在运行中调整相机参数：
+ * 开启 exposure.enable 时由 ExposureController 根据灯条亮度自动调节曝光时间和增益，统计区域由 SetExposureTargets 给出。
+ * 开启 supervisor.enable 时由后台线程监视相机：相机断开，或软触发下超过 stall_timeout 没有新帧时，
+ * 关闭并重新打开相机，恢复当前的曝光时间、增益和触发设置，直到重新出帧，不需要重启程序。
+ * 注册的回调保存在本类中，由相机上的一个转发回调调用，因此重新打开相机后无需重新注册。
+ * 断流期间 GetFrame 返回 false，恢复后断流时长等统计通过 Outage 取得。
+ * 重新打开后相机时钟从零开始，转发回调为每次打开加上一个偏移，使新的第一帧时间戳为上一帧加一个帧间隔，
+ * 回调和 GetFrame 得到的时间戳始终单调递增；同时在新的第一帧之前调用 SetReopenCallback 设置的回调，
+ * 使用者应在其中重置相机与本机的时钟同步。
+ * 相机以关闭相机的删除器共享持有，自动曝光调节参数时只在复制指针时持有 camera_lock_，不会阻塞取图。
+ */
+class ManagedCameraReader final : public Reader {
+  inline static auto registry = RegistrySub<Reader, ManagedCameraReader>("managed");
+  using Clock = std::chrono::steady_clock;
+
+ public:
+  ManagedCameraReader() = default;
+  ~ManagedCameraReader() override {
+    {
+      std::lock_guard lock{supervisor_lock_};
+      stop_flag_ = true;
+    }
+    supervisor_cv_.notify_all();
+    if (supervisor_.joinable()) {
+      supervisor_.join();
+    }
+    exposure_controller_.Stop();
+    camera_.reset();
+  }
+
+  bool Initialize(std::string REF_IN prefix) override {
+    camera_name_ = cfg.Get<std::string>({prefix, "camera"});
+    intrinsic_mat_ = cfg.Get<cv::Mat>({"video.cameras", camera_name_, "intrinsic_mat"});
+    distortion_mat_ = cfg.Get<cv::Mat>({"video.cameras", camera_name_, "distortion_mat"});
+    type_ = cfg.Get<std::string>({"video.cameras", camera_name_, "type"});
+    serial_number_ = cfg.Get<std::string>({"video.cameras", camera_name_, "sn"});
+    time_stamp_ns_ = cfg.Get<int>({"video.cameras", camera_name_, "time_stamp_ns"});
+    hardware_trigger_ = cfg.Get<bool>({prefix, "hardware_trigger"});
+    frame_rate_ = cfg.Get<double>({prefix, "frame_rate"});
+    const auto exposure = static_cast<uint32_t>(cfg.Get<int>({"video.cameras", camera_name_, "exposure_time"}));
+    const auto gain = cfg.Get<float>({"video.cameras", camera_name_, "gain_value"});
+    camera_ = Open(exposure, gain);
+    open_time_ = Clock::now().time_since_epoch().count();
+    if (!camera_) {
+      return false;
+    }
+    exposure_control_ = exposure_controller_.Initialize(
+        prefix + ".exposure", exposure, gain, [this](const uint32_t time, const float value) {
+          std::shared_ptr<Camera> camera;
+          {
+            std::lock_guard lock{camera_lock_};
+            camera = camera_;
+          }
+          return camera && camera->SetExposureTime(time) && camera->SetGainValue(value);
+        });
+    if (cfg.Get<bool>({prefix, "supervisor", "enable"})) {
+      check_interval_ = std::chrono::milliseconds(cfg.Get<int>({prefix, "supervisor", "check_interval"}));
+      stall_timeout_ = std::chrono::milliseconds(cfg.Get<int>({prefix, "supervisor", "stall_timeout"}));
+      supervisor_ = std::thread([this] { Supervise(); });
+    }
+    source_count_ = 1;
+    LOG(INFO) << "Opened camera " << camera_name_ << ".";
+    return true;
+  }
+
+  bool GetFrame(Frame REF_OUT frame) override {
+    {
+      std::lock_guard lock{camera_lock_};
+      if (!camera_ || !camera_->GetFrame(frame)) {
+        return false;
+      }
+    }
+    if (exposure_control_ && frame.valid) {
+      exposure_controller_.Feed(frame);
+    }
+    return true;
+  }
+
+  void RegisterFrameCallback(FrameCallback FWD_IN callback) override {
+    std::lock_guard lock{callback_lock_};
+    callback_list_.push_back(std::forward<FrameCallback>(callback));
+  }
+
+  /**
+   * @brief 设置重新打开相机后的回调，在新的第一帧的帧回调之前于相机线程中调用，用于重置时钟同步
+   * @param [in] callback 回调函数
+   */
+  void SetReopenCallback(std::function<void()> FWD_IN callback) {
+    std::lock_guard lock{callback_lock_};
+    reopen_callback_ = std::forward<std::function<void()>>(callback);
+  }
+
+  /**
+   * @brief 将识别到的目标设置为自动曝光的统计区域，未启用自动曝光时忽略
+   * @param [in] boxes 目标的外接矩形，单位像素
+   */
+  void SetExposureTargets(std::vector<cv::Rect> REF_IN boxes) {
+    if (exposure_control_) {
+      exposure_controller_.SetTargets(boxes);
+    }
+  }
+
+  [[nodiscard]] const cv::Mat &IntrinsicMat() const override { return intrinsic_mat_; }
+  [[nodiscard]] const cv::Mat &DistortionMat() const override { return distortion_mat_; }
+
+  /// 断流统计
+  [[nodiscard]] CameraOutage Outage() {
+    std::lock_guard lock{supervisor_lock_};
+    return outage_;
+  }
+
+ private:
+  /**
+   * @brief 创建并打开相机，应用所有设置并开启视频流
+   * @details 不持有 camera_lock_，打开相机较慢时 GetFrame 不会被阻塞
+   * @param exposure 曝光时间，单位 us
+   * @param gain 增益，单位 dB
+   * @return 打开的相机，最后一个持有者释放时关闭，失败时为空
+   */
+  std::shared_ptr<Camera> Open(const uint32_t exposure, const float gain) {
+    std::unique_ptr<Camera> camera{CreateCamera(type_)};
+    if (!camera) {
+      LOG(ERROR) << "Failed to create camera object of type " << type_ << ".";
+      return nullptr;
+    }
+    if (!camera->OpenCamera(serial_number_, "")) {
+      LOG(ERROR) << "Failed to open camera " << camera_name_ << ".";
+      return nullptr;
+    }
+    camera->SetTimeStampNS(time_stamp_ns_);
+    if (!camera->SetExposureTime(exposure)) {
+      LOG(WARNING) << "Failed to set exposure time of camera.";
+    }
+    if (!camera->SetGainValue(gain)) {
+      LOG(WARNING) << "Failed to set gain value of camera.";
+    }
+    if (!camera->SetHardwareTriggerMode(hardware_trigger_)) {
+      LOG(WARNING) << "Failed to set hardware trigger mode of camera.";
+    }
+    if (!hardware_trigger_ && !camera->SetFrameRate(frame_rate_)) {
+      LOG(WARNING) << "Failed to set frame rate of camera. Fallback to default value.";
+    }
+    /// first 和 offset 属于本次打开，重新打开时随新的转发回调重置
+    auto forward = [this, first = true, offset = uint64_t{}](Frame &frame) mutable {
+      last_frame_time_ = Clock::now().time_since_epoch().count();
+      const uint64_t last = last_time_stamp_;
+      std::lock_guard lock{callback_lock_};
+      if (first) {
+        first = false;
+        if (last) {
+          /// 重新打开后的第一帧：接在上一帧之后一个帧间隔，此后本次打开的所有帧使用同一偏移
+          uint64_t interval = frame_interval_;
+          if (!interval && frame_rate_ > 0) {
+            interval = static_cast<uint64_t>(1e9 / frame_rate_);
+          }
+          offset = last + std::max<uint64_t>(interval, 1) - frame.time_stamp;
+          if (reopen_callback_) {
+            reopen_callback_();
+          }
+        }
+      }
+      frame.time_stamp += offset;
+      if (last && frame.time_stamp > last) {
+        frame_interval_ = frame.time_stamp - last;
+      }
+      last_time_stamp_ = frame.time_stamp;
+      for (const auto &callback : callback_list_) {
+        (*callback.func)(frame);
+      }
+    };
+    camera->RegisterFrameCallback({std::make_unique<FrameCallback::function>(std::move(forward))});
+    if (!camera->StartStream()) {
+      LOG(ERROR) << "Failed to start stream of camera " << camera_name_ << ".";
+      Close(std::move(camera));
+      return nullptr;
+    }
+    return {camera.release(), [](Camera *camera) { Close(std::unique_ptr<Camera>(camera)); }};
+  }
+
+  /// 关闭并释放相机
+  static void Close(std::unique_ptr<Camera> camera) {
+    if (camera) {
+      camera->StopStream();
+      camera->CloseCamera();
+    }
+  }
+
+  /// 监视线程
+  void Supervise() {
+    const auto time_point = [](const int64_t count) { return Clock::time_point(Clock::duration(count)); };
+    bool outage = false;
+    Clock::time_point outage_start;
+    std::unique_lock lock{supervisor_lock_};
+    while (!supervisor_cv_.wait_for(lock, check_interval_, [this] { return stop_flag_; })) {
+      const auto now = Clock::now();
+      const auto last_frame = time_point(last_frame_time_);
+      if (outage && last_frame > outage_start) {
+        const auto duration = last_frame - outage_start;
+        ++outage_.count;
+        outage_.last = duration;
+        outage_.max = std::max(outage_.max, outage_.last);
+        outage_.total += outage_.last;
+        outage = false;
+        LOG(WARNING) << "Camera " << camera_name_ << " resumed after "
+                     << std::chrono::duration_cast<std::chrono::milliseconds>(duration).count() << " ms, "
+                     << outage_.count << " outages and " << outage_.reopen_count << " reopens in total.";
+      }
+      bool connected;
+      {
+        std::lock_guard camera_lock{camera_lock_};
+        connected = camera_ && camera_->IsConnected();
+      }
+      /// 从最近一帧或最近一次打开相机起计算无帧时间，重新打开后留出出帧的时间
+      const bool stalled = now - std::max(last_frame, time_point(open_time_)) > stall_timeout_;
+      if (connected && !stalled) {
+        continue;
+      }
+      if (connected && hardware_trigger_) {
+        /// 硬触发下没有触发信号时同样没有新帧，不能据此判断相机故障
+        LOG_EVERY_N(WARNING, 100) << "No frame from camera " << camera_name_ << ", please check the trigger signal.";
+        continue;
+      }
+      if (!outage) {
+        outage = true;
+        outage_start = last_frame;
+        LOG(WARNING) << "Camera " << camera_name_ << (connected ? " stalled" : " disconnected") << ", reopening.";
+      }
+      /// 两次打开至少间隔 stall_timeout，相机未插好时不会频繁重试
+      if (now - time_point(open_time_) < stall_timeout_) {
+        continue;
+      }
+      ++outage_.reopen_count;
+      lock.unlock();
+      std::shared_ptr<Camera> camera;
+      {
+        std::lock_guard camera_lock{camera_lock_};
+        camera = std::move(camera_);
+      }
+      /// 自动曝光正在使用旧相机时，由其释放时关闭
+      camera.reset();
+      camera = Open(exposure_controller_.Exposure(), exposure_controller_.Gain());
+      open_time_ = Clock::now().time_since_epoch().count();
+      if (camera) {
+        LOG(INFO) << "Camera " << camera_name_ << " is reopened, waiting for frames.";
+        std::lock_guard camera_lock{camera_lock_};
+        camera_ = std::move(camera);
+      }
+      lock.lock();
+    }
+  }
+
+  cv::Mat intrinsic_mat_;                     ///< 相机内参
+  cv::Mat distortion_mat_;                    ///< 相机畸变
+  std::string camera_name_;                   ///< 相机配置名称
+  std::string type_;                          ///< 相机类型
+  std::string serial_number_;                 ///< 相机序列号
+  int time_stamp_ns_{};                       ///< 相机时间戳单位
+  bool hardware_trigger_{};                   ///< 是否硬触发
+  double frame_rate_{};                       ///< 软触发帧率
+  std::shared_ptr<Camera> camera_;            ///< 相机，重新打开时会被替换
+  std::mutex camera_lock_;                    ///< 相机指针锁
+  std::vector<FrameCallback> callback_list_;  ///< 注册的回调函数列表
+  std::function<void()> reopen_callback_;     ///< 重新打开相机后的回调
+  std::mutex callback_lock_;                  ///< 回调列表锁
+  std::atomic_uint64_t last_time_stamp_{};    ///< 最近一帧加上偏移后的时间戳，为 0 表示尚未出帧
+  std::atomic_uint64_t frame_interval_{};     ///< 最近两帧的时间戳间隔，单位 ns
+
+  bool exposure_control_{};                 ///< 是否启用自动曝光
+  ExposureController exposure_controller_;  ///< 自动曝光控制器
+
+  std::chrono::milliseconds check_interval_{};  ///< 监视间隔
+  std::chrono::milliseconds stall_timeout_{};   ///< 视为断流的无帧时间
+  std::atomic_int64_t last_frame_time_{};       ///< 最近一帧到达的本机时间
+  std::atomic_int64_t open_time_{};             ///< 最近一次尝试打开相机的本机时间
+  CameraOutage outage_;                         ///< 断流统计
+  std::mutex supervisor_lock_;                  ///< 监视线程锁
+  std::condition_variable supervisor_cv_;       ///< 监视线程通知
+  bool stop_flag_{};                            ///< 监视线程停止信号
+  std::thread supervisor_;                      ///< 监视线程
+};
+
+}  // namespace srm::video
+
+#endif  // SRM_VIDEO_READER_MANAGED_HPP_
@@ -0,0 +1,200 @@
+#ifndef SRM_VIDEO_READER_PARALLEL_HPP_
+#define SRM_VIDEO_READER_PARALLEL_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "srm/common/config.hpp"
+#include "srm/video/reader.h"
+
+namespace srm::video {
+
+/**
+ * @brief 多线程并行加载的离线视频源基类
+ * @details
+ * 适用于可按序号随机读取每一帧的数据集（图像目录、原始帧文件等）。
+ * 多个加载线程各自领取下一个帧序号，将图像加载到环形槽位中，GetFrame 按序号顺序取出，
+ * 因此输出顺序与单线程一致，吞吐量随线程数增加，用于测试各环节的计算上限。
+ * 时间戳为虚拟时钟，即输出序号乘以 fps 对应的帧间隔；只有 paced 为真时才按该帧率等待。
+ * @note 子类须在析构函数中调用 Stop，保证加载线程退出时子类的数据仍然有效
+ */
+class ParallelReader : public Reader {
+  /// 环形槽位
+  struct Slot {
+    cv::Mat image;   ///< 加载得到的图像
+    uint64_t seq{};  ///< 输出序号
+    bool ready{};    ///< 是否已加载完成
+    bool valid{};    ///< 是否加载成功
+  };
+
+ public:
+  ParallelReader() = default;
+  ~ParallelReader() override = default;
+
+  bool GetFrame(Frame REF_OUT frame) override {
+    uint64_t seq;
+    while (true) {
+      std::unique_lock lock{lock_};
+      cv_.wait(lock, [this] {
+        const auto &slot = slots_[consumed_ % slots_.size()];
+        return stop_flag_ || consumed_ >= limit_ || (slot.ready && slot.seq == consumed_);
+      });
+      if (stop_flag_ || consumed_ >= limit_) {
+        return false;
+      }
+      auto &slot = slots_[consumed_ % slots_.size()];
+      seq = consumed_++;
+      slot.ready = false;
+      const bool valid = slot.valid;
+      if (valid) {
+        /// 交换图像，使用者不再持有的旧缓冲区留给槽位复用
+        std::swap(frame.image, slot.image);
+        if (slot.image.u && slot.image.u->refcount > 1) {
+          slot.image = cv::Mat();
+        }
+      }
+      lock.unlock();
+      cv_.notify_all();
+      if (valid) {
+        break;
+      }
+      LOG_EVERY_N(WARNING, 100) << "Failed to load frame " << seq % count_ << ", skipped.";
+    }
+    if (paced_) {
+      std::this_thread::sleep_until(start_time_ + period_ * seq);
+    }
+    frame.valid = true;
+    frame.time_stamp = static_cast<uint64_t>(std::chrono::nanoseconds(period_ * seq).count());
+    frame.sync_data.reset();
+    position_ = seq % count_;
+    for (const auto &callback : callback_list_) {
+      (*callback.func)(frame);
+    }
+    return true;
+  }
+
+  void RegisterFrameCallback(FrameCallback FWD_IN callback) override {
+    callback_list_.push_back(std::forward<FrameCallback>(callback));
+  }
+
+  [[nodiscard]] const cv::Mat &IntrinsicMat() const override { return intrinsic_mat_; }
+  [[nodiscard]] const cv::Mat &DistortionMat() const override { return distortion_mat_; }
+
+  /// 数据集中的帧数
+  [[nodiscard]] size_t FrameCount() const { return count_; }
+
+  /// 最近一次 GetFrame 得到的帧在数据集中的序号
+  [[nodiscard]] size_t Position() const { return position_; }
+
+ protected:
+  /**
+   * @brief 读取公共配置并启动加载线程，子类在准备好数据集后调用
+   * @param [in] prefix 前置路径
+   * @param count 数据集中的帧数
+   * @return 是否启动成功
+   */
+  bool Start(std::string REF_IN prefix, const size_t count) {
+    const auto camera = cfg.Get<std::string>({prefix, "camera"});
+    intrinsic_mat_ = cfg.Get<cv::Mat>({"video.cameras", camera, "intrinsic_mat"});
+    distortion_mat_ = cfg.Get<cv::Mat>({"video.cameras", camera, "distortion_mat"});
+    const auto fps = cfg.Get<double>({prefix, "fps"});
+    paced_ = cfg.Get<bool>({prefix, "paced"});
+    period_ = std::chrono::nanoseconds(static_cast<int64_t>(1e9 / (fps > 0 ? fps : 1000)));
+    auto workers = cfg.Get<int>({prefix, "workers"});
+    if (workers <= 0) {
+      workers = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    }
+    if (!count) {
+      LOG(ERROR) << "No frame is found for " << prefix << ".";
+      return false;
+    }
+    count_ = count;
+    limit_ = cfg.Get<bool>({prefix, "loop"}) ? std::numeric_limits<uint64_t>::max() : count;
+    slots_.resize(std::max<size_t>(workers * 2, cfg.Get<int>({prefix, "queue_size"})));
+    source_count_ = 1;
+    start_time_ = std::chrono::steady_clock::now();
+    for (int i = 0; i < workers; ++i) {
+      workers_.emplace_back([this] { Work(); });
+    }
+    LOG(INFO) << count << " frames are loaded by " << workers << " threads from " << prefix << ".";
+    return true;
+  }
+
+  /// 停止并等待所有加载线程
+  void Stop() {
+    {
+      std::lock_guard lock{lock_};
+      stop_flag_ = true;
+    }
+    cv_.notify_all();
+    for (auto &worker : workers_) {
+      if (worker.joinable()) {
+        worker.join();
+      }
+    }
+    workers_.clear();
+  }
+
+  /**
+   * @brief 加载一帧，会在多个加载线程中同时调用
+   * @param index 帧在数据集中的序号
+   * @param [in,out] image 输出图像，可复用其中的缓冲区
+   * @return 是否加载成功
+   */
+  virtual bool Load(size_t index, cv::Mat REF_OUT image) = 0;
+
+ private:
+  /// 加载线程
+  void Work() {
+    while (true) {
+      std::unique_lock lock{lock_};
+      cv_.wait(lock, [this] { return stop_flag_ || (next_ < limit_ && next_ < consumed_ + slots_.size()); });
+      if (stop_flag_) {
+        return;
+      }
+      const uint64_t seq = next_++;
+      auto &slot = slots_[seq % slots_.size()];
+      cv::Mat image = std::move(slot.image);
+      lock.unlock();
+
+      const bool valid = Load(seq % count_, image);
+
+      lock.lock();
+      slot.image = std::move(image);
+      slot.seq = seq;
+      slot.valid = valid;
+      slot.ready = true;
+      lock.unlock();
+      cv_.notify_all();
+    }
+  }
+
+  cv::Mat intrinsic_mat_;                             ///< 相机内参
+  cv::Mat distortion_mat_;                            ///< 相机畸变
+  bool paced_{};                                      ///< 是否按帧率等待
+  std::chrono::nanoseconds period_{};                 ///< 虚拟时钟的帧间隔
+  std::chrono::steady_clock::time_point start_time_;  ///< 开始时间
+  size_t count_{};                                    ///< 数据集中的帧数
+  std::atomic_size_t position_{};                     ///< 最近一次输出的帧序号
+  std::vector<FrameCallback> callback_list_;          ///< 注册的回调函数列表
+
+  std::vector<Slot> slots_;           ///< 环形槽位
+  std::mutex lock_;                   ///< 槽位锁
+  std::condition_variable cv_;        ///< 槽位通知
+  uint64_t next_{};                   ///< 下一个待加载的输出序号
+  uint64_t consumed_{};               ///< 下一个待输出的输出序号
+  uint64_t limit_{};                  ///< 输出序号上限，循环播放时不限
+  bool stop_flag_{};                  ///< 停止信号
+  std::vector<std::thread> workers_;  ///< 加载线程
+};
+
+}  // namespace srm::video
+
+#endif  // SRM_VIDEO_READER_PARALLEL_HPP_
@@ -0,0 +1,289 @@
+#ifndef SRM_VIDEO_READER_PREFETCH_HPP_
+#define SRM_VIDEO_READER_PREFETCH_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <opencv2/videoio.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "srm/common/config.hpp"
+#include "srm/video/reader.h"
+
+namespace srm::video {
+
+/**
+ * @brief 预解码视频文件视频源
+ * @details
+ * 解码在后台线程中提前进行，解码结果写入循环复用的图像缓冲区，GetFrame 只从有界队列中取帧，不再等待解码器。
+ * 节奏可选：pts(按封装时间戳实时输出) | fps(按固定帧率输出) | fast(不等待，用于性能测试)。
+ * 循环播放时在后台线程中回到文件开头，队列中已有的帧可以掩盖这段时间；开启 preload 时整个文件在初始化时解码到内存，
+ * 循环播放不再经过解码器，性能测试只测量自身的处理流程。
+ * 时间戳从 0 开始，循环播放时继续递增，不会回退。
+ */
+class PrefetchReader final : public Reader {
+  inline static auto registry = RegistrySub<Reader, PrefetchReader>("prefetch");
+
+  /// 节奏模式
+  enum class Pacing { kPts, kFps, kFast };
+
+  /// 解码得到的一帧
+  struct Item {
+    cv::Mat image;          ///< 图像
+    uint64_t time_stamp{};  ///< 时间戳，单位 ns
+    int64_t index{};        ///< 在文件中的帧序号
+  };
+
+ public:
+  PrefetchReader() = default;
+  ~PrefetchReader() override {
+    {
+      std::lock_guard lock{queue_lock_};
+      stop_flag_ = true;
+    }
+    queue_cv_.notify_all();
+    if (thread_.joinable()) {
+      thread_.join();
+    }
+  }
+
+  bool Initialize(std::string REF_IN prefix) override {
+    const auto camera = cfg.Get<std::string>({prefix, "camera"});
+    const auto video = cfg.Get<std::string>({prefix, "video"});
+    const auto pacing = cfg.Get<std::string>({prefix, "pacing"});
+    if (pacing == "pts") {
+      pacing_ = Pacing::kPts;
+    } else if (pacing == "fps") {
+      pacing_ = Pacing::kFps;
+    } else if (pacing == "fast") {
+      pacing_ = Pacing::kFast;
+    } else {
+      LOG(ERROR) << "Unknown pacing " << pacing << " for prefetch reader.";
+      return false;
+    }
+    loop_ = cfg.Get<bool>({prefix, "loop"});
+    queue_size_ = std::max(2, cfg.Get<int>({prefix, "queue_size"}));
+    preload_ = cfg.Get<bool>({prefix, "preload"});
+    intrinsic_mat_ = cfg.Get<cv::Mat>({"video.cameras", camera, "intrinsic_mat"});
+    distortion_mat_ = cfg.Get<cv::Mat>({"video.cameras", camera, "distortion_mat"});
+    if (!capture_.open(video)) {
+      LOG(ERROR) << "Failed to open video " << video << ".";
+      return false;
+    }
+    auto fps = cfg.Get<double>({prefix, "fps"});
+    if (fps <= 0) {
+      fps = capture_.get(cv::CAP_PROP_FPS);
+    }
+    period_ = static_cast<uint64_t>(1e9 / (fps > 0 ? fps : 30));
+    frame_count_ = static_cast<int64_t>(capture_.get(cv::CAP_PROP_FRAME_COUNT));
+    if (preload_) {
+      for (Item item; Read(frame_count_, item); item = {}) {
+        item.index = static_cast<int64_t>(cache_.size());
+        cache_.push_back(std::move(item));
+      }
+      capture_.release();
+      if (cache_.empty()) {
+        LOG(ERROR) << "No frame is decoded from " << video << ".";
+        return false;
+      }
+      frame_count_ = static_cast<int64_t>(cache_.size());
+      LOG(INFO) << frame_count_ << " frames are preloaded from " << video << ".";
+    }
+    pool_.resize(queue_size_ + 2);
+    source_count_ = 1;
+    thread_ = std::thread([this] { Decode(); });
+    return true;
+  }
+
+  bool GetFrame(Frame REF_OUT frame) override {
+    Item item;
+    {
+      std::unique_lock lock{queue_lock_};
+      queue_cv_.wait(lock, [this] { return !queue_.empty() || decode_finished_; });
+      if (queue_.empty()) {
+        return false;
+      }
+      item = std::move(queue_.front());
+      queue_.pop_front();
+    }
+    queue_cv_.notify_all();
+    if (pacing_ != Pacing::kFast) {
+      Pace(item.time_stamp);
+    }
+    frame.valid = true;
+    frame.image = std::move(item.image);
+    frame.time_stamp = item.time_stamp;
+    frame.sync_data.reset();
+    position_ = item.index;
+    for (const auto &callback : callback_list_) {
+      (*callback.func)(frame);
+    }
+    return true;
+  }
+
+  void RegisterFrameCallback(FrameCallback FWD_IN callback) override {
+    callback_list_.push_back(std::forward<FrameCallback>(callback));
+  }
+
+  [[nodiscard]] const cv::Mat &IntrinsicMat() const override { return intrinsic_mat_; }
+  [[nodiscard]] const cv::Mat &DistortionMat() const override { return distortion_mat_; }
+
+  /**
+   * @brief 跳转到指定帧，下一次 GetFrame 得到的即为该帧
+   * @param index 帧序号，从 0 开始
+   * @note 已预解码的帧会被丢弃，节奏从跳转后的第一帧重新开始计算，时间戳可能回退
+   */
+  void Seek(const int64_t index) {
+    {
+      std::lock_guard lock{queue_lock_};
+      seek_ = std::max<int64_t>(0, index);
+      queue_.clear();
+      decode_finished_ = false;
+      pacing_started_ = false;
+    }
+    queue_cv_.notify_all();
+  }
+
+  /// 文件中的帧数，无法获取时小于等于 0
+  [[nodiscard]] int64_t FrameCount() const { return frame_count_; }
+
+  /// 最近一次 GetFrame 得到的帧在文件中的序号
+  [[nodiscard]] int64_t Position() const { return position_; }
+
+ private:
+  /**
+   * @brief 读取文件中的一帧
+   * @param index 帧序号，只在 preload 完成后使用
+   * @param [in,out] item 输出的帧，会复用其中的图像缓冲区
+   * @return 是否读取成功，到达文件末尾时返回 false
+   */
+  bool Read(const int64_t index, Item REF_OUT item) {
+    if (!cache_.empty()) {
+      if (index >= static_cast<int64_t>(cache_.size())) {
+        return false;
+      }
+      cache_[index].image.copyTo(item.image);
+      item.time_stamp = cache_[index].time_stamp;
+      return true;
+    }
+    if (!capture_.read(item.image) || item.image.empty()) {
+      return false;
+    }
+    if (pacing_ == Pacing::kPts) {
+      item.time_stamp = static_cast<uint64_t>(capture_.get(cv::CAP_PROP_POS_MSEC) * 1e6);
+    } else {
+      item.time_stamp = static_cast<uint64_t>(capture_.get(cv::CAP_PROP_POS_FRAMES) - 1) * period_;
+    }
+    return true;
+  }
+
+  /// 取一个空闲的图像缓冲区，仍被队列或使用者持有的缓冲区会被替换为新的
+  cv::Mat Slot() {
+    cv::Mat &slot = pool_[pool_index_++ % pool_.size()];
+    if (slot.u && slot.u->refcount > 1) {
+      slot = cv::Mat();
+    }
+    return slot;
+  }
+
+  /// 后台解码线程
+  void Decode() {
+    int64_t index = 0;
+    uint64_t offset = 0;
+    uint64_t last_time_stamp = 0;
+    while (true) {
+      {
+        std::unique_lock lock{queue_lock_};
+        queue_cv_.wait(lock, [this] {
+          return stop_flag_ || seek_ >= 0 || (!decode_finished_ && queue_.size() < queue_size_);
+        });
+        if (stop_flag_) {
+          return;
+        }
+        if (seek_ >= 0) {
+          index = seek_;
+          seek_ = -1;
+          decode_finished_ = false;
+          if (!preload_) {
+            capture_.set(cv::CAP_PROP_POS_FRAMES, static_cast<double>(index));
+          }
+        }
+      }
+      Item item{Slot()};
+      if (!Read(index, item)) {
+        /// 文件末尾，循环播放时回到开头，时间戳接着上一帧继续增加
+        if (loop_ && index > 0) {
+          offset = last_time_stamp + period_;
+          index = 0;
+          if (!preload_) {
+            capture_.set(cv::CAP_PROP_POS_FRAMES, 0);
+          }
+          continue;
+        }
+        {
+          std::lock_guard lock{queue_lock_};
+          decode_finished_ = seek_ < 0;
+        }
+        queue_cv_.notify_all();
+        continue;
+      }
+      item.index = index++;
+      item.time_stamp += offset;
+      last_time_stamp = item.time_stamp;
+      {
+        std::lock_guard lock{queue_lock_};
+        if (seek_ >= 0) {
+          continue;
+        }
+        queue_.push_back(std::move(item));
+      }
+      queue_cv_.notify_all();
+    }
+  }
+
+  /// 按时间戳等待
+  void Pace(const uint64_t time_stamp) {
+    using namespace std::chrono;
+    const auto now = steady_clock::now();
+    if (!pacing_started_.exchange(true)) {
+      first_time_stamp_ = time_stamp;
+      start_time_ = now;
+      return;
+    }
+    std::this_thread::sleep_until(start_time_ + nanoseconds(time_stamp - first_time_stamp_));
+  }
+
+  cv::Mat intrinsic_mat_;                             ///< 相机内参
+  cv::Mat distortion_mat_;                            ///< 相机畸变
+  Pacing pacing_{};                                   ///< 节奏模式
+  bool loop_{};                                       ///< 是否循环播放
+  bool preload_{};                                    ///< 是否预先解码整个文件
+  size_t queue_size_{};                               ///< 预解码队列长度
+  uint64_t period_{};                                 ///< 帧间隔，单位 ns
+  int64_t frame_count_{};                             ///< 文件中的帧数
+  std::atomic_int64_t position_{};                    ///< 最近一次输出的帧序号
+  std::atomic_bool pacing_started_{};                 ///< 是否已输出节奏的第一帧
+  uint64_t first_time_stamp_{};                       ///< 节奏第一帧的时间戳
+  std::chrono::steady_clock::time_point start_time_;  ///< 节奏第一帧的输出时间
+  std::vector<FrameCallback> callback_list_;          ///< 注册的回调函数列表
+
+  cv::VideoCapture capture_;          ///< 解码器，初始化后只在解码线程中使用
+  std::vector<Item> cache_;           ///< preload 时解码得到的所有帧
+  std::vector<cv::Mat> pool_;         ///< 循环复用的图像缓冲区
+  size_t pool_index_{};               ///< 下一个使用的缓冲区
+  std::deque<Item> queue_;            ///< 预解码队列
+  std::mutex queue_lock_;             ///< 队列锁
+  std::condition_variable queue_cv_;  ///< 队列通知
+  int64_t seek_{-1};                  ///< 待处理的跳转目标，小于 0 表示没有
+  bool decode_finished_{};            ///< 解码线程是否已读完文件
+  bool stop_flag_{};                  ///< 解码线程停止信号
+  std::thread thread_;                ///< 解码线程
+};
+
+}  // namespace srm::video
+
+#endif  // SRM_VIDEO_READER_PREFETCH_HPP_
@@ -0,0 +1,116 @@
+#ifndef SRM_VIDEO_READER_RAW_HPP_
+#define SRM_VIDEO_READER_RAW_HPP_
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "srm/video/raw-dump.hpp"
+#include "srm/video/reader-parallel.hpp"
+
+namespace srm::video {
+
+/**
+ * @brief 原始帧转储视频源
+ * @details
+ * 将 RawDumpWriter 写出的文件整个映射到内存，按槽位直接定位每一帧，由多个线程并行复制到输出图像，不经过解码。
+ * 文件未正常关闭时按槽位标识跳过未写入的槽位。像素格式以文件头中记录的为准，通过 Format 取得。
+ */
+class RawReader final : public ParallelReader {
+  inline static auto registry = RegistrySub<Reader, RawReader>("raw");
+
+ public:
+  RawReader() = default;
+  ~RawReader() override {
+    Stop();
+    if (data_ != MAP_FAILED) {
+      ::munmap(data_, size_);
+    }
+  }
+
+  bool Initialize(std::string REF_IN prefix) override {
+    const auto file = cfg.Get<std::string>({prefix, "file"});
+    const int fd = ::open(file.c_str(), O_RDONLY);
+    struct stat st {};
+    if (fd < 0 || ::fstat(fd, &st) != 0) {
+      LOG(ERROR) << "Failed to open raw dump " << file << ".";
+      if (fd >= 0) {
+        ::close(fd);
+      }
+      return false;
+    }
+    size_ = static_cast<size_t>(st.st_size);
+    if (size_ >= raw_dump::kAlignment) {
+      data_ = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+    }
+    ::close(fd);
+    if (data_ == MAP_FAILED) {
+      LOG(ERROR) << "Failed to map raw dump " << file << ".";
+      return false;
+    }
+    ::madvise(data_, size_, MADV_SEQUENTIAL);
+
+    std::memcpy(&header_, data_, sizeof(header_));
+    if (header_.magic != raw_dump::kFileMagic || header_.slot_size < raw_dump::kMetaSize + header_.image_size) {
+      LOG(ERROR) << file << " is not a valid raw dump.";
+      return false;
+    }
+    if (header_.version != raw_dump::kVersion) {
+      LOG(ERROR) << file << " is raw dump version " << header_.version << ", only version " << raw_dump::kVersion
+                 << " is supported.";
+      return false;
+    }
+    pixel_format_ = static_cast<PixelFormat>(header_.pixel_format);
+    if (header_.pixel_format > static_cast<uint32_t>(PixelFormat::kBayerBg8) ||
+        static_cast<int>(header_.image_type) != PixelFormatType(pixel_format_)) {
+      LOG(ERROR) << "Image type of " << file << " does not match its pixel format.";
+      return false;
+    }
+    /// 文件可能被截断，只使用完整的槽位
+    const uint64_t slots = std::min(header_.capacity, (size_ - raw_dump::kAlignment) / header_.slot_size);
+    const uint64_t count = header_.count ? std::min(header_.count, slots) : slots;
+    for (uint64_t i = 0; i < count; ++i) {
+      if (!header_.count) {
+        RawDumpSlotHeader slot_header;
+        std::memcpy(&slot_header, Slot(i), sizeof(slot_header));
+        if (slot_header.magic != raw_dump::kSlotMagic) {
+          continue;
+        }
+      }
+      slots_.push_back(i);
+    }
+    return Start(prefix, slots_.size());
+  }
+
+  /// 转储文件中图像的像素格式
+  [[nodiscard]] PixelFormat Format() const { return pixel_format_; }
+
+ private:
+  /// 第 i 个槽位的起始地址
+  [[nodiscard]] const char *Slot(const uint64_t i) const {
+    return static_cast<const char *>(data_) + raw_dump::kAlignment + i * header_.slot_size;
+  }
+
+  bool Load(const size_t index, cv::Mat REF_OUT image) override {
+    auto *data = const_cast<char *>(Slot(slots_[index]) + raw_dump::kMetaSize);
+    const cv::Mat view(static_cast<int>(header_.rows), static_cast<int>(header_.cols),
+                       static_cast<int>(header_.image_type), data);
+    view.copyTo(image);
+    return true;
+  }
+
+  void *data_ = MAP_FAILED;      ///< 映射的文件
+  size_t size_{};                ///< 文件大小
+  RawDumpHeader header_;         ///< 文件头
+  PixelFormat pixel_format_{};   ///< 图像的像素格式
+  std::vector<uint64_t> slots_;  ///< 有效槽位的序号
+};
+
+}  // namespace srm::video
+
+#endif  // SRM_VIDEO_READER_RAW_HPP_
@@ -0,0 +1,157 @@
+#ifndef SRM_VIDEO_READER_REPLAY_HPP_
+#define SRM_VIDEO_READER_REPLAY_HPP_
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+#include "srm/common/config.hpp"
+#include "srm/video/reader.h"
+#include "srm/video/session.hpp"
+
+namespace srm::video {
+
+/**
+ * @brief 会话回放视频源
+ * @details
+ * 按顺序读出会话文件中的每一帧，不丢帧，可选择尽可能快地读取或按录制时的时间间隔读取。
+ * 解码在后台线程中提前进行，GetFrame 只从有界队列中取帧。
+ * @warning 会话中保存的是已经过回调处理（如翻转）的图像，因此注册的回调不会被执行
+ */
+class ReplayReader final : public Reader {
+  inline static auto registry = RegistrySub<Reader, ReplayReader>("replay");
+  static constexpr size_t kQueueSize = 8;  ///< 预解码队列长度
+
+ public:
+  ReplayReader() = default;
+  ~ReplayReader() override {
+    {
+      std::lock_guard lock{queue_lock_};
+      stop_flag_ = true;
+    }
+    queue_cv_.notify_all();
+    if (thread_.joinable()) {
+      thread_.join();
+    }
+  }
+
+  bool Initialize(std::string REF_IN prefix) override {
+    const auto session_file = cfg.Get<std::string>({prefix, "session"});
+    const auto camera = cfg.Get<std::string>({prefix, "camera"});
+    const auto pacing = cfg.Get<std::string>({prefix, "pacing"});
+    if (pacing != "fast" && pacing != "recorded") {
+      LOG(ERROR) << "Unknown pacing " << pacing << " for replay reader.";
+      return false;
+    }
+    recorded_pacing_ = pacing == "recorded";
+    intrinsic_mat_ = cfg.Get<cv::Mat>({"video.cameras", camera, "intrinsic_mat"});
+    distortion_mat_ = cfg.Get<cv::Mat>({"video.cameras", camera, "distortion_mat"});
+    if (!session_.Open(session_file)) {
+      return false;
+    }
+    source_count_ = 1;
+    thread_ = std::thread([this] { Decode(); });
+    return true;
+  }
+
+  bool GetFrame(Frame REF_OUT frame) override {
+    SessionRecord record;
+    {
+      std::unique_lock lock{queue_lock_};
+      queue_cv_.wait(lock, [this] { return !queue_.empty() || decode_finished_; });
+      if (queue_.empty()) {
+        return false;
+      }
+      record = std::move(queue_.front());
+      queue_.pop_front();
+    }
+    queue_cv_.notify_all();
+    if (recorded_pacing_) {
+      Pace(record.time_stamp);
+    }
+    frame.valid = !record.image.empty();
+    frame.image = std::move(record.image);
+    frame.time_stamp = record.time_stamp;
+    frame.sync_data.reset();
+    current_ = std::move(record);
+    return true;
+  }
+
+  void RegisterFrameCallback(FrameCallback FWD_IN callback) override {
+    LOG(INFO) << "Frames in session have already passed the callbacks, ignore the callback for replay reader.";
+  }
+
+  [[nodiscard]] const cv::Mat &IntrinsicMat() const override { return intrinsic_mat_; }
+  [[nodiscard]] const cv::Mat &DistortionMat() const override { return distortion_mat_; }
+
+  /// 会话中的帧是否已经全部读出
+  [[nodiscard]] bool Finished() {
+    std::lock_guard lock{queue_lock_};
+    return decode_finished_ && queue_.empty();
+  }
+
+  /// 会话中的帧数量
+  [[nodiscard]] size_t FrameCount() const { return session_.Count(); }
+
+  /// 最近一次 GetFrame 得到的帧在会话中记录的收发数据和识别结果，图像已移入 Frame
+  attr_reader_ref(current_, CurrentRecord);
+
+ private:
+  /// 后台解码线程
+  void Decode() {
+    for (size_t n = 0; n < session_.Count(); ++n) {
+      SessionRecord record;
+      if (!session_.Read(n, record)) {
+        continue;
+      }
+      std::unique_lock lock{queue_lock_};
+      queue_cv_.wait(lock, [this] { return queue_.size() < kQueueSize || stop_flag_; });
+      if (stop_flag_) {
+        return;
+      }
+      queue_.push_back(std::move(record));
+      lock.unlock();
+      queue_cv_.notify_all();
+    }
+    {
+      std::lock_guard lock{queue_lock_};
+      decode_finished_ = true;
+    }
+    queue_cv_.notify_all();
+  }
+
+  /// 按录制时的时间间隔等待
+  void Pace(const uint64_t time_stamp) {
+    using namespace std::chrono;
+    const auto now = steady_clock::now();
+    /// 时间戳回退时（如会话中途重开相机）以当前帧为新的起点，避免无符号相减下溢
+    if (!pacing_started_ || time_stamp < first_time_stamp_) {
+      pacing_started_ = true;
+      first_time_stamp_ = time_stamp;
+      start_time_ = now;
+      return;
+    }
+    std::this_thread::sleep_until(start_time_ + nanoseconds(time_stamp - first_time_stamp_));
+  }
+
+  SessionReader session_;                             ///< 会话文件
+  SessionRecord current_;                             ///< 当前帧的会话记录
+  cv::Mat intrinsic_mat_;                             ///< 相机内参
+  cv::Mat distortion_mat_;                            ///< 相机畸变
+  bool recorded_pacing_{};                            ///< 是否按录制时间回放
+  bool pacing_started_{};                             ///< 是否已读出第一帧
+  uint64_t first_time_stamp_{};                       ///< 第一帧的时间戳
+  std::chrono::steady_clock::time_point start_time_;  ///< 第一帧的回放时间
+
+  std::deque<SessionRecord> queue_;   ///< 预解码队列
+  std::mutex queue_lock_;             ///< 队列锁
+  std::condition_variable queue_cv_;  ///< 队列通知
+  bool decode_finished_{};            ///< 解码线程是否已读完会话
+  bool stop_flag_{};                  ///< 解码线程停止信号
+  std::thread thread_;                ///< 解码线程
+};
+
+}  // namespace srm::video
+
+#endif  // SRM_VIDEO_READER_REPLAY_HPP_
@@ -0,0 +1,295 @@
+#ifndef SRM_VIDEO_READER_SYNTHETIC_HPP_
+#define SRM_VIDEO_READER_SYNTHETIC_HPP_
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <numbers>
+#include <opencv2/calib3d.hpp>
+#include <opencv2/imgproc.hpp>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "srm/common/config.hpp"
+#include "srm/video/reader.h"
+
+namespace srm::video {
+
+/// 合成场景中一块装甲板的真值
+struct SyntheticArmor {
+  cv::Vec3d rvec;                  ///< 装甲板坐标系到相机坐标系的旋转向量
+  cv::Vec3d tvec;                  ///< 装甲板中心在相机坐标系中的位置，单位 mm
+  std::array<cv::Point2f, 4> pts;  ///< 灯条端点在图像中的位置，依次为左上、右上、右下、左下
+  bool visible;                    ///< 是否朝向相机并被绘制
+};
+
+/// 合成帧的真值
+struct SyntheticTruth {
+  uint64_t time_stamp{};               ///< 帧时间戳，单位 ns
+  double yaw{};                        ///< 运动角度，spin 为整车转角，rune 为能量机关转角，单位弧度
+  std::vector<SyntheticArmor> armors;  ///< 所有装甲板，包括背对相机未绘制的
+};
+
+/**
+ * @brief 合成装甲板场景的视频源
+ * @details
+ * 按相机内参和畸变将三维装甲板模型（灯条、底板和数字）投影到图像上，可选运动模式：
+ * static(静止) | translate(横向往复平移) | spin(小陀螺，四块装甲板绕车体中心旋转) | rune(五块装甲板绕中心旋转)。
+ * 曝光模糊通过在曝光时间内多次采样叠加得到，噪声从预先生成的噪声帧中循环选取，单帧开销很小，可用于压力测试。
+ * 每帧的真值通过 Truth 取得，相机坐标系方向为右、下、前，与坐标求解器一致。
+ * 时间戳为虚拟相机时钟，即帧序号乘以帧间隔。
+ */
+class SyntheticReader final : public Reader {
+  inline static auto registry = RegistrySub<Reader, SyntheticReader>("synthetic");
+  static constexpr int kNoiseBank = 8;                               ///< 预先生成的噪声帧数量
+  static constexpr double kBarSpacing = 135;                         ///< 两根灯条的间距，单位 mm
+  static constexpr double kBarLength = 56;                           ///< 灯条长度，单位 mm
+  static constexpr double kPlateHalfHeight = 62.5;                   ///< 底板半高，单位 mm
+  static constexpr double kArmorTilt = 15 * std::numbers::pi / 180;  ///< 装甲板向后倾斜的角度
+
+ public:
+  SyntheticReader() = default;
+  ~SyntheticReader() override = default;
+
+  bool Initialize(std::string REF_IN prefix) override {
+    const auto camera = cfg.Get<std::string>({prefix, "camera"});
+    intrinsic_mat_ = cfg.Get<cv::Mat>({"video.cameras", camera, "intrinsic_mat"});
+    distortion_mat_ = cfg.Get<cv::Mat>({"video.cameras", camera, "distortion_mat"});
+    size_ = {cfg.Get<int>({prefix, "width"}), cfg.Get<int>({prefix, "height"})};
+    const auto fps = cfg.Get<double>({prefix, "fps"});
+    period_ = std::chrono::nanoseconds(static_cast<int64_t>(1e9 / (fps > 0 ? fps : 400)));
+    paced_ = fps > 0;
+    motion_ = cfg.Get<std::string>({prefix, "motion"});
+    if (motion_ != "static" && motion_ != "translate" && motion_ != "spin" && motion_ != "rune") {
+      LOG(ERROR) << "Unknown motion " << motion_ << " for synthetic reader.";
+      return false;
+    }
+    distance_ = cfg.Get<double>({prefix, "distance"});
+    amplitude_ = cfg.Get<double>({prefix, "amplitude"});
+    speed_ = cfg.Get<double>({prefix, "speed"});
+    radius_ = cfg.Get<double>({prefix, "radius"});
+    number_ = std::to_string(cfg.Get<int>({prefix, "number"}));
+    bar_color_ = cfg.Get<std::string>({prefix, "color"}) == "red" ? cv::Scalar(60, 60, 255) : cv::Scalar(255, 160, 40);
+    exposure_ = cfg.Get<double>({prefix, "exposure"}) * 1e-3;
+    samples_ = std::max(1, cfg.Get<int>({prefix, "exposure_samples"}));
+    if (!ParsePixelFormat(cfg.Get<std::string>({prefix, "pixel_format"}), pixel_format_)) {
+      return false;
+    }
+    if (size_.width <= 0 || size_.height <= 0 || intrinsic_mat_.empty() ||
+        (IsBayer(pixel_format_) && (size_.width | size_.height) & 1)) {
+      LOG(ERROR) << "Invalid image size or camera for synthetic reader.";
+      return false;
+    }
+
+    /// 数字贴图，投影时按底板四角做透视变换
+    texture_ = cv::Mat(64, 64, CV_8UC3, cv::Scalar(40, 40, 40));
+    cv::putText(texture_, number_, {14, 52}, cv::FONT_HERSHEY_SIMPLEX, 1.8, cv::Scalar(200, 200, 200), 4);
+
+    const auto noise = cfg.Get<double>({prefix, "noise"});
+    if (noise > 0) {
+      cv::RNG rng(cfg.Get<int>({prefix, "seed"}));
+      for (int i = 0; i < kNoiseBank; ++i) {
+        cv::Mat bank(size_, CV_16SC3);
+        rng.fill(bank, cv::RNG::NORMAL, 0, noise);
+        noise_.push_back(std::move(bank));
+      }
+    }
+    source_count_ = 1;
+    start_time_ = std::chrono::steady_clock::now();
+    return true;
+  }
+
+  bool GetFrame(Frame REF_OUT frame) override {
+    if (paced_) {
+      std::this_thread::sleep_until(start_time_ + period_ * index_);
+    }
+    const double t = std::chrono::duration<double>(period_ * index_).count();
+    /// 非 BGR 输出时先绘制到内部的彩色图像，再采样为单通道
+    cv::Mat &image = pixel_format_ == PixelFormat::kBgr8 ? frame.image : color_;
+    if (samples_ == 1) {
+      Render(t, image, truth_);
+    } else {
+      /// 在曝光时间内多次采样叠加，得到运动模糊，真值取曝光中点
+      accumulator_.create(size_, CV_32FC3);
+      accumulator_.setTo(0);
+      for (int i = 0; i < samples_; ++i) {
+        const double ts = t - exposure_ * (1 - (i + 0.5) / samples_);
+        Render(ts, sample_, truth_);
+        cv::accumulate(sample_, accumulator_);
+      }
+      accumulator_.convertTo(image, CV_8UC3, 1.0 / samples_);
+      Pose(t - exposure_ / 2, truth_);
+      Project(truth_);
+    }
+    if (!noise_.empty()) {
+      cv::add(image, noise_[index_ % noise_.size()], image, cv::noArray(), CV_8UC3);
+    }
+    if (IsBayer(pixel_format_)) {
+      Mosaic(color_, pixel_format_, frame.image);
+    } else if (pixel_format_ == PixelFormat::kMono8) {
+      cv::cvtColor(color_, frame.image, cv::COLOR_BGR2GRAY);
+    }
+    frame.valid = true;
+    frame.time_stamp = static_cast<uint64_t>(std::chrono::nanoseconds(period_ * index_).count());
+    frame.sync_data.reset();
+    truth_.time_stamp = frame.time_stamp;
+    ++index_;
+    for (const auto &callback : callback_list_) {
+      (*callback.func)(frame);
+    }
+    return true;
+  }
+
+  void RegisterFrameCallback(FrameCallback FWD_IN callback) override {
+    callback_list_.push_back(std::forward<FrameCallback>(callback));
+  }
+
+  [[nodiscard]] const cv::Mat &IntrinsicMat() const override { return intrinsic_mat_; }
+  [[nodiscard]] const cv::Mat &DistortionMat() const override { return distortion_mat_; }
+
+  /// 最近一次 GetFrame 得到的帧的真值
+  attr_reader_ref(truth_, Truth);
+
+ private:
+  /**
+   * @brief 计算某一时刻所有装甲板的位姿
+   * @param t 时间，单位 s
+   * @param [out] truth 真值，只更新位姿和可见性
+   */
+  void Pose(const double t, SyntheticTruth REF_OUT truth) const {
+    truth.armors.clear();
+    const auto add = [&](const cv::Matx33d &rotation, const cv::Vec3d &position) {
+      SyntheticArmor armor{};
+      cv::Rodrigues(rotation, armor.rvec);
+      armor.tvec = position;
+      /// 装甲板法向量为其 z 轴的反方向，指向相机一侧时才可见
+      const cv::Vec3d normal(-rotation(0, 2), -rotation(1, 2), -rotation(2, 2));
+      armor.visible = normal.dot(position) < -0.2 * cv::norm(position);
+      truth.armors.push_back(armor);
+    };
+    const auto rot_y = [](const double a) {
+      return cv::Matx33d(std::cos(a), 0, std::sin(a), 0, 1, 0, -std::sin(a), 0, std::cos(a));
+    };
+    const auto rot_x = [](const double a) {
+      return cv::Matx33d(1, 0, 0, 0, std::cos(a), -std::sin(a), 0, std::sin(a), std::cos(a));
+    };
+    const auto rot_z = [](const double a) {
+      return cv::Matx33d(std::cos(a), -std::sin(a), 0, std::sin(a), std::cos(a), 0, 0, 0, 1);
+    };
+    const cv::Vec3d center(0, 0, distance_);
+    if (motion_ == "static" || motion_ == "translate") {
+      const double x = motion_ == "translate" ? amplitude_ * std::sin(speed_ * t) : 0;
+      truth.yaw = 0;
+      add(rot_x(kArmorTilt), center + cv::Vec3d(x, 0, 0));
+    } else if (motion_ == "spin") {
+      truth.yaw = speed_ * t;
+      for (int k = 0; k < 4; ++k) {
+        const double a = truth.yaw + k * std::numbers::pi / 2;
+        add(rot_y(-a) * rot_x(kArmorTilt), center + cv::Vec3d(radius_ * std::sin(a), 0, -radius_ * std::cos(a)));
+      }
+    } else {
+      truth.yaw = speed_ * t;
+      for (int k = 0; k < 5; ++k) {
+        const double a = truth.yaw + k * 2 * std::numbers::pi / 5;
+        add(rot_z(a + std::numbers::pi / 2), center + cv::Vec3d(radius_ * std::cos(a), radius_ * std::sin(a), 0));
+      }
+    }
+  }
+
+  /**
+   * @brief 计算所有装甲板灯条端点和底板四角在图像中的位置
+   * @param [in,out] truth 真值，更新灯条端点
+   * @return 每块装甲板的底板四角
+   */
+  std::vector<std::array<cv::Point2f, 4>> Project(SyntheticTruth REF_OUT truth) const {
+    const double bx = kBarSpacing / 2, by = kBarLength / 2, px = kBarSpacing / 2 - 5, py = kPlateHalfHeight;
+    /// 依次为灯条端点（左上、右上、右下、左下）和底板四角
+    const std::vector<cv::Point3d> model = {{-bx, -by, 0}, {bx, -by, 0}, {bx, by, 0}, {-bx, by, 0},
+                                            {-px, -py, 0}, {px, -py, 0}, {px, py, 0}, {-px, py, 0}};
+    std::vector<std::array<cv::Point2f, 4>> plates;
+    std::vector<cv::Point2f> projected;
+    for (auto &armor : truth.armors) {
+      cv::projectPoints(model, armor.rvec, armor.tvec, intrinsic_mat_, distortion_mat_, projected);
+      std::copy_n(projected.begin(), 4, armor.pts.begin());
+      plates.push_back({projected[4], projected[5], projected[6], projected[7]});
+    }
+    return plates;
+  }
+
+  /**
+   * @brief 绘制某一时刻的场景
+   * @param t 时间，单位 s
+   * @param [out] image 输出图像
+   * @param [out] truth 真值
+   */
+  void Render(const double t, cv::Mat REF_OUT image, SyntheticTruth REF_OUT truth) const {
+    image.create(size_, CV_8UC3);
+    image.setTo(cv::Scalar(20, 20, 20));
+    Pose(t, truth);
+    const auto plates = Project(truth);
+    for (size_t i = 0; i < truth.armors.size(); ++i) {
+      const auto &armor = truth.armors[i];
+      if (!armor.visible) {
+        continue;
+      }
+      DrawPlate(image, plates[i]);
+      /// 灯条宽度随距离变化，中心过曝为白色
+      const auto &pts = armor.pts;
+      const int width = std::max(1, static_cast<int>(cv::norm(pts[0] - pts[3]) / 8));
+      for (const auto &[a, b] : {std::pair{pts[0], pts[3]}, std::pair{pts[1], pts[2]}}) {
+        cv::line(image, a, b, bar_color_, width + 2, cv::LINE_AA);
+        cv::line(image, a, b, cv::Scalar(255, 255, 255), std::max(1, width / 2), cv::LINE_AA);
+      }
+    }
+  }
+
+  /// 将数字贴图透视变换到底板上
+  void DrawPlate(cv::Mat &image, const std::array<cv::Point2f, 4> &corners) const {
+    const cv::Rect bound = cv::boundingRect(std::vector<cv::Point2f>(corners.begin(), corners.end())) &
+                           cv::Rect(0, 0, image.cols, image.rows);
+    if (bound.area() <= 0) {
+      return;
+    }
+    const std::array<cv::Point2f, 4> src = {cv::Point2f(0, 0), cv::Point2f(64, 0), cv::Point2f(64, 64),
+                                            cv::Point2f(0, 64)};
+    std::array<cv::Point2f, 4> dst;
+    for (size_t i = 0; i < 4; ++i) {
+      dst[i] = corners[i] - cv::Point2f(static_cast<float>(bound.x), static_cast<float>(bound.y));
+    }
+    const cv::Mat homography = cv::getPerspectiveTransform(src.data(), dst.data());
+    cv::Mat roi = image(bound);
+    cv::warpPerspective(texture_, roi, homography, roi.size(), cv::INTER_LINEAR, cv::BORDER_TRANSPARENT);
+  }
+
+  cv::Mat intrinsic_mat_;                             ///< 相机内参
+  cv::Mat distortion_mat_;                            ///< 相机畸变
+  cv::Size size_;                                     ///< 图像大小
+  std::chrono::nanoseconds period_{};                 ///< 帧间隔
+  bool paced_{};                                      ///< 是否按帧率等待
+  std::string motion_;                                ///< 运动模式
+  double distance_{};                                 ///< 目标中心距相机的距离，单位 mm
+  double amplitude_{};                                ///< translate 的平移幅度，单位 mm
+  double speed_{};                                    ///< 角速度，translate 为往复角频率，单位 rad/s
+  double radius_{};                                   ///< spin 和 rune 的旋转半径，单位 mm
+  std::string number_;                                ///< 装甲板数字
+  cv::Scalar bar_color_;                              ///< 灯条颜色
+  double exposure_{};                                 ///< 曝光时间，单位 s
+  int samples_{1};                                    ///< 曝光时间内的采样次数
+  cv::Mat texture_;                                   ///< 数字贴图
+  std::vector<cv::Mat> noise_;                        ///< 预先生成的噪声帧
+  PixelFormat pixel_format_{};                        ///< 输出的像素格式
+  cv::Mat color_;                                     ///< 非 BGR 输出时绘制的彩色图像
+  cv::Mat sample_;                                    ///< 单次采样的图像
+  cv::Mat accumulator_;                               ///< 运动模糊的累加图像
+  SyntheticTruth truth_;                              ///< 当前帧的真值
+  uint64_t index_{};                                  ///< 帧序号
+  std::chrono::steady_clock::time_point start_time_;  ///< 第一帧的时间
+  std::vector<FrameCallback> callback_list_;          ///< 注册的回调函数列表
+};
+
+}  // namespace srm::video
+
+#endif  // SRM_VIDEO_READER_SYNTHETIC_HPP_
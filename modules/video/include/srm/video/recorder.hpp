@@ -0,0 +1,221 @@
+#ifndef SRM_VIDEO_RECORDER_HPP_
+#define SRM_VIDEO_RECORDER_HPP_
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <utility>
+
+#include "srm/common/image-format.hpp"
+#include "srm/video/session.hpp"
+
+namespace srm::video {
+
+/**
+ * @brief 会话录制类
+ * @details
+ * 将图像、时间戳、收发数据包和识别结果写入同一个会话文件，格式见 session.hpp，可直接由 ReplayReader 回放。
+ * 调用线程只负责把图像复制到复用的缓冲区，压缩由多个后台线程并行完成，
+ * 写入线程按帧序号重新排序后攒满一块再写盘，关闭时在文件尾写入索引。
+ * 已接收但尚未写盘的帧数不超过 queue_size，压缩或写盘跟不上时新帧在复制图像之前就被丢弃并计数，不会阻塞主循环。
+ * 调用顺序为 Reserve、Snapshot、Write，只应由一个线程提交。Snapshot 只复制原始格式的图像，去马赛克在压缩线程中进行。
+ */
+class Recorder final {
+ public:
+  Recorder() = default;
+  ~Recorder() { Close(); }
+
+  /**
+   * @brief 创建会话文件并启动后台线程
+   * @param [in] file 文件路径
+   * @param frame_size 图像长宽大小
+   * @param format 图像存储格式
+   * @param quality JPEG 压缩质量，仅在 format 为 kJpeg 时有效
+   * @param workers 压缩线程数量
+   * @param queue_size 已接收但尚未写盘的最大帧数，超过时丢帧
+   * @param chunk_size 每次写盘的最小字节数
+   * @return 是否创建成功
+   */
+  bool Open(std::string REF_IN file, const cv::Size frame_size, const SessionImageFormat format, const int quality,
+            const size_t workers, const size_t queue_size, const size_t chunk_size) {
+    if (!writer_.Open(file, frame_size, chunk_size)) {
+      return false;
+    }
+    format_ = format;
+    quality_ = quality;
+    queue_size_ = queue_size;
+    for (size_t i = 0; i < std::max<size_t>(workers, 1); ++i) {
+      workers_.emplace_back([this] { Encode(); });
+    }
+    flusher_ = std::thread([this] { Flush(); });
+    LOG(INFO) << "Session is recording to " << file << ".";
+    return true;
+  }
+
+  /**
+   * @brief 为下一帧预留位置，应在复制图像之前调用
+   * @return 是否预留成功，已接收但尚未写盘的帧数达到上限时返回假并计入丢帧，此时不应再调用 Snapshot 和 Write
+   */
+  bool Reserve() {
+    std::lock_guard lock{lock_};
+    if (stop_flag_ || in_flight_ >= queue_size_) {
+      ++dropped_;
+      LOG_EVERY_N(WARNING, 100) << "Recorder is falling behind, " << dropped_ << " frames are dropped.";
+      return false;
+    }
+    ++in_flight_;
+    return true;
+  }
+
+  /**
+   * @brief 将图像复制到复用的缓冲区，避免读取类复用图像缓冲区时覆盖录制内容
+   * @param [in] image 原始格式的图像，不做格式转换
+   * @return 图像副本
+   */
+  cv::Mat Snapshot(cv::Mat REF_IN image) {
+    cv::Mat snapshot;
+    {
+      std::lock_guard lock{pool_lock_};
+      if (!pool_.empty()) {
+        snapshot = std::move(pool_.back());
+        pool_.pop_back();
+      }
+    }
+    image.copyTo(snapshot);
+    return snapshot;
+  }
+
+  /**
+   * @brief 提交一帧，立即返回
+   * @param [in] record 帧数据，其中的图像应来自 Snapshot
+   * @param pixel_format 图像的像素格式，非 BGR 时在压缩线程中转换为 BGR 后存储
+   * @return 是否被接收，须先通过 Reserve 预留位置，录制已关闭时返回假并计入丢帧
+   */
+  bool Write(SessionRecord FWD_IN record, const PixelFormat pixel_format) {
+    {
+      std::lock_guard lock{lock_};
+      if (stop_flag_) {
+        in_flight_ = in_flight_ > 0 ? in_flight_ - 1 : 0;
+        ++dropped_;
+        return false;
+      }
+      record.index = submitted_++;
+      pending_.emplace_back(std::forward<SessionRecord>(record), pixel_format);
+    }
+    pending_cv_.notify_one();
+    return true;
+  }
+
+  /// 等待已提交的帧全部写盘，写入索引并关闭文件
+  void Close() {
+    {
+      std::lock_guard lock{lock_};
+      if (stop_flag_ || workers_.empty()) {
+        return;
+      }
+      stop_flag_ = true;
+    }
+    pending_cv_.notify_all();
+    for (auto &worker : workers_) {
+      worker.join();
+    }
+    done_cv_.notify_all();
+    flusher_.join();
+    writer_.Close();
+    LOG(INFO) << "Session is closed with " << writer_.Count() << " frames, " << dropped_ << " frames dropped.";
+  }
+
+  /// 因队列已满或录制已关闭丢弃的帧数
+  [[nodiscard]] uint64_t Dropped() {
+    std::lock_guard lock{lock_};
+    return dropped_;
+  }
+
+ private:
+  /// 压缩线程，将帧序列化为完整的记录
+  void Encode() {
+    cv::Mat bgr;
+    while (true) {
+      SessionRecord record;
+      PixelFormat pixel_format;
+      {
+        std::unique_lock lock{lock_};
+        pending_cv_.wait(lock, [this] { return !pending_.empty() || stop_flag_; });
+        if (pending_.empty()) {
+          return;
+        }
+        std::tie(record, pixel_format) = std::move(pending_.front());
+        pending_.pop_front();
+      }
+
+      /// 存储的总是 BGR 图像，与回放的约定一致
+      cv::Mat snapshot = std::move(record.image);
+      if (pixel_format == PixelFormat::kBgr8) {
+        record.image = snapshot;
+      } else {
+        ToBgr(snapshot, pixel_format, bgr);
+        record.image = bgr;
+      }
+      std::vector<char> bytes;
+      EncodeSessionRecord(record, format_, quality_, bytes);
+      record.image.release();
+
+      /// 图像缓冲区交还给 Snapshot 复用
+      if (snapshot.isContinuous()) {
+        std::lock_guard lock{pool_lock_};
+        pool_.push_back(std::move(snapshot));
+      }
+      {
+        std::lock_guard lock{lock_};
+        done_.emplace(record.index, std::make_pair(record.time_stamp, std::move(bytes)));
+      }
+      done_cv_.notify_one();
+    }
+  }
+
+  /// 写入线程，按帧序号顺序写入记录
+  void Flush() {
+    uint64_t next = 0;
+    while (true) {
+      std::unique_lock lock{lock_};
+      done_cv_.wait(lock, [&] { return done_.contains(next) || (stop_flag_ && next == submitted_); });
+      if (!done_.contains(next)) {
+        break;
+      }
+      auto node = done_.extract(next++);
+      lock.unlock();
+      const auto &[time_stamp, bytes] = node.mapped();
+      writer_.Append(time_stamp, bytes);
+      lock.lock();
+      --in_flight_;
+    }
+  }
+
+  SessionWriter writer_;         ///< 会话文件
+  SessionImageFormat format_{};  ///< 图像存储格式
+  int quality_{};                ///< JPEG 压缩质量
+  size_t queue_size_{};          ///< 已接收但尚未写盘的最大帧数
+
+  std::deque<std::pair<SessionRecord, PixelFormat>> pending_;        ///< 等待压缩的帧及其像素格式
+  std::map<uint64_t, std::pair<uint64_t, std::vector<char>>> done_;  ///< 已压缩、等待写盘的记录
+  std::mutex lock_;                                                  ///< 队列锁
+  std::condition_variable pending_cv_;                               ///< 压缩队列通知
+  std::condition_variable done_cv_;                                  ///< 写盘队列通知
+  uint64_t submitted_{};                                             ///< 已接收的帧数
+  size_t in_flight_{};                                               ///< 已预留但尚未写盘的帧数
+  uint64_t dropped_{};                                               ///< 丢弃的帧数
+  bool stop_flag_{};                                                 ///< 停止信号
+  std::vector<std::thread> workers_;                                 ///< 压缩线程
+  std::thread flusher_;                                              ///< 写入线程
+
+  std::vector<cv::Mat> pool_;  ///< 可复用的图像缓冲区
+  std::mutex pool_lock_;       ///< 缓冲区锁
+};
+
+}  // namespace srm::video
+
+#endif  // SRM_VIDEO_RECORDER_HPP_
@@ -0,0 +1,353 @@
+#ifndef SRM_VIDEO_SESSION_HPP_
+#define SRM_VIDEO_SESSION_HPP_
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <opencv2/imgcodecs.hpp>
+#include <string>
+#include <vector>
+
+#include "srm/common/tags.hpp"
+
+namespace srm::video {
+
+/**
+ * @brief 会话文件格式
+ * @details
+ * 会话文件将图像、时间戳、收发数据包和识别结果按帧保存在同一个文件中，供离线回放使用：
+ * @code
+ * SessionHeader
+ * SessionRecordHeader | 图像 | 接收数据包 | 发送数据包 | SessionDetection * n   （每帧一条）
+ * ...
+ * SessionIndexEntry * count                                                    （正常关闭时写入）
+ * SessionFooter
+ * @endcode
+ * 文件未正常关闭时没有索引，读取时会顺序扫描记录重建索引。
+ */
+namespace session {
+
+constexpr std::array<char, 4> kFileMagic = {'S', 'R', 'M', 'S'};    ///< 文件头标识
+constexpr std::array<char, 4> kRecordMagic = {'F', 'R', 'M', 'E'};  ///< 帧记录标识
+constexpr std::array<char, 4> kIndexMagic = {'S', 'R', 'M', 'I'};   ///< 索引标识
+constexpr uint32_t kVersion = 1;                                    ///< 文件格式版本
+
+}  // namespace session
+
+/// 会话中图像的存储格式
+enum class SessionImageFormat : uint16_t {
+  kJpeg = 0,  ///< JPEG 压缩
+  kRaw = 1,   ///< 未压缩的原始数据，按 rows * cols * elemSize 连续存放
+};
+
+/// 会话文件头
+struct SessionHeader {
+  std::array<char, 4> magic = session::kFileMagic;  ///< 文件头标识
+  uint32_t version = session::kVersion;             ///< 文件格式版本
+  uint32_t cols{};                                  ///< 图像宽度
+  uint32_t rows{};                                  ///< 图像高度
+  uint64_t reserved{};                              ///< 保留
+};
+
+/// 每帧记录头
+struct SessionRecordHeader {
+  std::array<char, 4> magic = session::kRecordMagic;  ///< 帧记录标识
+  uint32_t payload_size{};                            ///< 记录头之后的数据总大小
+  uint64_t index{};                                   ///< 帧序号
+  uint64_t time_stamp{};                              ///< 帧时间戳，单位 ns
+  SessionImageFormat image_format{};                  ///< 图像存储格式
+  uint16_t image_type{};                              ///< 图像的 OpenCV 类型
+  uint32_t image_size{};                              ///< 图像数据大小
+  uint32_t cols{};                                    ///< 图像宽度
+  uint32_t rows{};                                    ///< 图像高度
+  uint32_t receive_size{};                            ///< 接收数据包大小
+  uint32_t send_size{};                               ///< 发送数据包大小
+  uint32_t detection_count{};                         ///< 识别结果数量
+  uint32_t reserved{};                                ///< 保留
+};
+
+/// 识别结果
+struct SessionDetection {
+  std::array<float, 8> pts{};  ///< 四个角点的坐标 (x0, y0, ..., x3, y3)
+  int32_t label{};             ///< 类别
+  float prob{};                ///< 置信度
+};
+
+/// 索引项
+struct SessionIndexEntry {
+  uint64_t offset{};      ///< 帧记录在文件中的偏移
+  uint64_t time_stamp{};  ///< 帧时间戳，单位 ns
+};
+
+/// 文件尾
+struct SessionFooter {
+  uint64_t index_offset{};                           ///< 索引在文件中的偏移
+  uint64_t count{};                                  ///< 帧数量
+  std::array<char, 4> magic = session::kIndexMagic;  ///< 索引标识
+  uint32_t version = session::kVersion;              ///< 文件格式版本
+};
+
+/// 从会话中读取的一帧
+struct SessionRecord {
+  uint64_t index{};                          ///< 帧序号
+  uint64_t time_stamp{};                     ///< 帧时间戳，单位 ns
+  cv::Mat image;                             ///< 解码后的图像
+  std::vector<char> receive;                 ///< 接收数据包
+  std::vector<char> send;                    ///< 发送数据包
+  std::vector<SessionDetection> detections;  ///< 识别结果
+};
+
+/**
+ * @brief 将一帧序列化为完整的帧记录
+ * @param [in] record 帧数据，record.index 作为帧序号写入
+ * @param format 图像存储格式
+ * @param quality JPEG 压缩质量，仅在 format 为 kJpeg 时有效
+ * @param [out] bytes 序列化结果，包含记录头
+ */
+inline void EncodeSessionRecord(SessionRecord REF_IN record, const SessionImageFormat format, const int quality,
+                                std::vector<char> REF_OUT bytes) {
+  thread_local std::vector<uint8_t> image_buffer;
+  SessionRecordHeader header;
+  header.index = record.index;
+  header.time_stamp = record.time_stamp;
+  header.image_format = format;
+  header.image_type = record.image.type();
+  header.cols = record.image.cols;
+  header.rows = record.image.rows;
+  const char *image_data;
+  if (format == SessionImageFormat::kJpeg) {
+    cv::imencode(".jpg", record.image, image_buffer, {cv::IMWRITE_JPEG_QUALITY, quality});
+    header.image_size = image_buffer.size();
+    image_data = reinterpret_cast<const char *>(image_buffer.data());
+  } else {
+    header.image_size = record.image.total() * record.image.elemSize();
+    image_data = reinterpret_cast<const char *>(record.image.data);
+  }
+  header.receive_size = record.receive.size();
+  header.send_size = record.send.size();
+  header.detection_count = record.detections.size();
+  const size_t detection_size = record.detections.size() * sizeof(SessionDetection);
+  header.payload_size = header.image_size + header.receive_size + header.send_size + detection_size;
+
+  bytes.resize(sizeof(header) + header.payload_size);
+  auto *ptr = bytes.data();
+  ptr = std::copy_n(reinterpret_cast<const char *>(&header), sizeof(header), ptr);
+  ptr = std::copy_n(image_data, header.image_size, ptr);
+  ptr = std::copy(record.receive.begin(), record.receive.end(), ptr);
+  ptr = std::copy(record.send.begin(), record.send.end(), ptr);
+  std::copy_n(reinterpret_cast<const char *>(record.detections.data()), detection_size, ptr);
+}
+
+/// 会话文件写入类，按帧序号顺序追加记录，攒满一块再写盘
+class SessionWriter final {
+ public:
+  SessionWriter() = default;
+  ~SessionWriter() { Close(); }
+
+  /**
+   * @brief 创建会话文件并写入文件头
+   * @param [in] file 文件路径
+   * @param frame_size 图像长宽大小
+   * @param chunk_size 每次写盘的最小字节数
+   * @return 是否创建成功
+   */
+  bool Open(std::string REF_IN file, const cv::Size frame_size, const size_t chunk_size) {
+    file_.open(file, std::ios::binary | std::ios::trunc);
+    if (!file_.is_open()) {
+      LOG(ERROR) << "Failed to create session " << file << ".";
+      return false;
+    }
+    SessionHeader header;
+    header.cols = frame_size.width;
+    header.rows = frame_size.height;
+    file_.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    offset_ = sizeof(header);
+    chunk_size_ = chunk_size;
+    chunk_.reserve(chunk_size + (chunk_size >> 2));
+    index_.clear();
+    return true;
+  }
+
+  /**
+   * @brief 追加一条由 EncodeSessionRecord 序列化的记录
+   * @param time_stamp 帧时间戳，单位 ns
+   * @param [in] bytes 序列化的帧记录
+   */
+  void Append(const uint64_t time_stamp, std::vector<char> REF_IN bytes) {
+    index_.push_back({offset_ + chunk_.size(), time_stamp});
+    chunk_.insert(chunk_.end(), bytes.begin(), bytes.end());
+    if (chunk_.size() >= chunk_size_) {
+      WriteChunk();
+    }
+  }
+
+  /// 写入剩余数据和索引并关闭文件
+  void Close() {
+    if (!file_.is_open()) {
+      return;
+    }
+    WriteChunk();
+    SessionFooter footer;
+    footer.index_offset = offset_;
+    footer.count = index_.size();
+    file_.write(reinterpret_cast<const char *>(index_.data()),
+                static_cast<std::streamsize>(index_.size() * sizeof(SessionIndexEntry)));
+    file_.write(reinterpret_cast<const char *>(&footer), sizeof(footer));
+    file_.close();
+  }
+
+  /// 已写入的帧数量
+  [[nodiscard]] size_t Count() const { return index_.size(); }
+
+ private:
+  /// 将缓存的数据块写入文件
+  void WriteChunk() {
+    if (chunk_.empty()) {
+      return;
+    }
+    if (!file_.write(chunk_.data(), static_cast<std::streamsize>(chunk_.size()))) {
+      LOG_EVERY_N(ERROR, 100) << "Failed to write session. Please check your disk space.";
+    }
+    offset_ += chunk_.size();
+    chunk_.clear();
+  }
+
+  std::ofstream file_;                    ///< 会话文件
+  size_t chunk_size_{};                   ///< 每次写盘的最小字节数
+  uint64_t offset_{};                     ///< 已写入文件的字节数
+  std::vector<char> chunk_;               ///< 待写盘的数据块
+  std::vector<SessionIndexEntry> index_;  ///< 帧索引
+};
+
+/// 会话文件读取类，支持按帧序号随机访问
+class SessionReader final {
+ public:
+  /**
+   * @brief 打开会话文件并加载索引
+   * @param [in] file 文件路径
+   * @return 是否打开成功
+   */
+  bool Open(std::string REF_IN file) {
+    file_.open(file, std::ios::binary);
+    if (!file_.is_open()) {
+      LOG(ERROR) << "Failed to open session " << file << ".";
+      return false;
+    }
+    if (!file_.read(reinterpret_cast<char *>(&header_), sizeof(header_)) || header_.magic != session::kFileMagic) {
+      LOG(ERROR) << file << " is not a session file.";
+      return false;
+    }
+    if (header_.version != session::kVersion) {
+      LOG(ERROR) << "Unsupported session version " << header_.version << ".";
+      return false;
+    }
+    if (!LoadIndex() && !RebuildIndex()) {
+      LOG(ERROR) << "Failed to build index of session " << file << ".";
+      return false;
+    }
+    LOG(INFO) << "Session " << file << " is opened with " << index_.size() << " frames.";
+    return true;
+  }
+
+  /**
+   * @brief 读取一帧
+   * @param n 帧序号
+   * @param [out] record 帧数据
+   * @param decode 是否解码图像，为假时 record.image 为空
+   * @return 是否读取成功
+   */
+  bool Read(const size_t n, SessionRecord REF_OUT record, const bool decode = true) {
+    if (n >= index_.size()) {
+      return false;
+    }
+    SessionRecordHeader header;
+    file_.clear();
+    file_.seekg(static_cast<std::streamoff>(index_[n].offset));
+    if (!file_.read(reinterpret_cast<char *>(&header), sizeof(header)) || header.magic != session::kRecordMagic) {
+      LOG(ERROR) << "Broken record " << n << " in session.";
+      return false;
+    }
+    buffer_.resize(header.image_size);
+    record.receive.resize(header.receive_size);
+    record.send.resize(header.send_size);
+    record.detections.resize(header.detection_count);
+    file_.read(buffer_.data(), header.image_size);
+    file_.read(record.receive.data(), header.receive_size);
+    file_.read(record.send.data(), header.send_size);
+    file_.read(reinterpret_cast<char *>(record.detections.data()),
+               static_cast<std::streamsize>(header.detection_count * sizeof(SessionDetection)));
+    if (!file_) {
+      LOG(ERROR) << "Truncated record " << n << " in session.";
+      return false;
+    }
+    record.index = header.index;
+    record.time_stamp = header.time_stamp;
+    record.image.release();
+    if (decode) {
+      if (header.image_format == SessionImageFormat::kJpeg) {
+        record.image = cv::imdecode(cv::Mat(1, static_cast<int>(buffer_.size()), CV_8UC1, buffer_.data()),
+                                    cv::IMREAD_UNCHANGED);
+      } else {
+        cv::Mat(static_cast<int>(header.rows), static_cast<int>(header.cols), header.image_type, buffer_.data())
+            .copyTo(record.image);
+      }
+    }
+    return true;
+  }
+
+  /// 帧数量
+  [[nodiscard]] size_t Count() const { return index_.size(); }
+
+  /// 第 n 帧的时间戳
+  [[nodiscard]] uint64_t TimeStamp(const size_t n) const { return index_[n].time_stamp; }
+
+  attr_reader_ref(header_, Header);
+
+ private:
+  /// 从文件尾加载索引
+  bool LoadIndex() {
+    SessionFooter footer;
+    file_.clear();
+    file_.seekg(-static_cast<std::streamoff>(sizeof(footer)), std::ios::end);
+    if (!file_.read(reinterpret_cast<char *>(&footer), sizeof(footer)) || footer.magic != session::kIndexMagic) {
+      return false;
+    }
+    index_.resize(footer.count);
+    file_.seekg(static_cast<std::streamoff>(footer.index_offset));
+    return static_cast<bool>(file_.read(reinterpret_cast<char *>(index_.data()),
+                                        static_cast<std::streamsize>(footer.count * sizeof(SessionIndexEntry))));
+  }
+
+  /// 文件未正常关闭时顺序扫描记录重建索引
+  bool RebuildIndex() {
+    LOG(WARNING) << "Session has no index, rebuilding it by scanning records.";
+    index_.clear();
+    file_.clear();
+    auto offset = static_cast<std::streamoff>(sizeof(SessionHeader));
+    SessionRecordHeader header;
+    while (file_.seekg(offset) && file_.read(reinterpret_cast<char *>(&header), sizeof(header)) &&
+           header.magic == session::kRecordMagic) {
+      const auto next = offset + static_cast<std::streamoff>(sizeof(header) + header.payload_size);
+      /// 最后一条记录可能没有写完整
+      if (!file_.seekg(next - 1) || file_.peek() == std::ifstream::traits_type::eof()) {
+        break;
+      }
+      index_.push_back({static_cast<uint64_t>(offset), header.time_stamp});
+      offset = next;
+    }
+    return !index_.empty();
+  }
+
+  std::ifstream file_;                    ///< 会话文件
+  SessionHeader header_;                  ///< 文件头
+  std::vector<SessionIndexEntry> index_;  ///< 帧索引
+  std::vector<char> buffer_;              ///< 图像读取缓冲区
+};
+
+}  // namespace srm::video
+
+#endif  // SRM_VIDEO_SESSION_HPP_
@@ -0,0 +1,239 @@
+#ifndef SRM_VIDEO_WRITER_ADAPTIVE_HPP_
+#define SRM_VIDEO_WRITER_ADAPTIVE_HPP_
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <opencv2/imgproc.hpp>
+#include <opencv2/videoio.hpp>
+#include <thread>
+
+#include "srm/common/image-format.hpp"
+#include "srm/common/tags.hpp"
+
+namespace srm::video {
+
+/// 录像统计数据
+struct WriterStatistics {
+  uint64_t received{};         ///< 收到的帧数
+  uint64_t resampled{};        ///< 因与上一帧落在同一输出帧内被跳过的帧数
+  uint64_t decimated{};        ///< 因缓冲区压力被抽帧跳过的帧数
+  uint64_t dropped{};          ///< 因超出内存预算被丢弃的帧数
+  uint64_t written{};          ///< 实际编码的帧数
+  uint64_t duplicated{};       ///< 为保持时间轴重复写入的帧数
+  uint64_t discontinuities{};  ///< 时间戳回退或跳变的次数
+};
+
+/**
+ * @brief 自适应录像类
+ * @details
+ * 按固定的输出帧率对输入帧按时间戳重采样，每个输出帧只保留一帧，缺帧时重复上一帧，
+ * 保证视频声明的帧率与时间戳一致。时间戳回退或相邻两帧间隔超过 kMaxGap 个输出帧时视为不连续，
+ * 以该帧作为上一帧之后的下一个输出帧重新建立时间轴，不会停在同一输出帧或补写大量重复帧。缓冲区按字节数限制内存：
+ * 占用超过一半预算时只保留每 decimation 个输出帧中的一个，超过预算时丢帧，
+ * 两种情况下都优先保留有识别结果的帧，并分别计数。
+ * 缓冲区保存原始格式的图像，去马赛克在编码线程中进行，被跳过或丢弃的帧不做转换。
+ */
+class AdaptiveWriter final {
+  static constexpr uint64_t kMaxGap = 4;  ///< 允许用重复帧补齐的最大输出帧间隔
+
+  /// 等待编码的帧
+  struct Item {
+    cv::Mat image;             ///< 原始格式的图像
+    PixelFormat pixel_format;  ///< 图像的像素格式
+    uint64_t slot;             ///< 输出帧序号
+    bool detection;            ///< 是否有识别结果
+  };
+
+ public:
+  AdaptiveWriter() = default;
+  ~AdaptiveWriter() { Close(); }
+
+  /**
+   * @brief 打开或创建新视频文件
+   * @param [in] video_file 文件名
+   * @param frame_size 图像长宽大小
+   * @param fps 视频声明的帧率，输入帧按此帧率重采样
+   * @param memory_budget 缓冲区内存预算，单位字节
+   * @param decimation 缓冲区压力较大时的抽帧间隔
+   * @return 是否打开成功
+   */
+  bool Open(std::string REF_IN video_file, const cv::Size frame_size, const double fps, const size_t memory_budget,
+            const uint64_t decimation) {
+    writer_ = std::make_unique<cv::VideoWriter>(video_file, cv::VideoWriter::fourcc('M', 'J', 'P', 'G'), fps,
+                                                frame_size);
+    if (!writer_->isOpened()) {
+      LOG(ERROR) << "Failed to open video " << video_file << ".";
+      return false;
+    }
+    frame_size_ = frame_size;
+    period_ = static_cast<uint64_t>(1e9 / fps);
+    memory_budget_ = memory_budget;
+    decimation_ = std::max<uint64_t>(decimation, 1);
+    thread_ = std::thread([this] { Encode(); });
+    return true;
+  }
+
+  /**
+   * @brief 写入视频，立即返回
+   * @param [in] frame 图像数据，可以是 Bayer 等原始格式，接收后才在编码线程中转换为 BGR
+   * @param pixel_format 图像的像素格式
+   * @param time_stamp 帧时间戳，单位 ns
+   * @param detection 本帧是否有识别结果，有识别结果的帧优先保留
+   * @return 是否实际写入数据
+   */
+  bool Write(cv::Mat FWD_IN frame, const PixelFormat pixel_format, const uint64_t time_stamp, const bool detection) {
+    std::unique_lock lock{lock_};
+    ++statistics_.received;
+    if (!started_) {
+      started_ = true;
+      base_time_stamp_ = time_stamp;
+    } else if (time_stamp < last_time_stamp_ || time_stamp - last_time_stamp_ > kMaxGap * period_) {
+      ++statistics_.discontinuities;
+      LOG_EVERY_N(WARNING, 10) << "Discontinuous time stamp in video writer, rebase the timeline.";
+      base_slot_ = last_received_slot_ + 1;
+      base_time_stamp_ = time_stamp;
+    }
+    const uint64_t slot = base_slot_ + (time_stamp - base_time_stamp_) / period_;
+    last_time_stamp_ = time_stamp;
+    last_received_slot_ = slot;
+    const size_t bytes = frame.total() * frame.elemSize();
+
+    /// 同一输出帧内只保留一帧，后到的有识别结果的帧可替换还未编码的无识别结果帧
+    if (slot <= last_slot_ && accepted_) {
+      if (detection && !queue_.empty() && queue_.back().slot == slot && !queue_.back().detection) {
+        queued_bytes_ += bytes - queue_.back().image.total() * queue_.back().image.elemSize();
+        queue_.back() = {std::forward<cv::Mat>(frame), pixel_format, slot, true};
+        return true;
+      }
+      ++statistics_.resampled;
+      return false;
+    }
+    if (queued_bytes_ * 2 > memory_budget_ && slot % decimation_ && !detection) {
+      ++statistics_.decimated;
+      return false;
+    }
+    if (queued_bytes_ + bytes > memory_budget_ && !EvictForDetection(detection, bytes)) {
+      ++statistics_.dropped;
+      LOG_EVERY_N(WARNING, 100) << "Video writer is falling behind, " << statistics_.dropped << " frames are dropped.";
+      return false;
+    }
+    queued_bytes_ += bytes;
+    queue_.push_back({std::forward<cv::Mat>(frame), pixel_format, slot, detection});
+    last_slot_ = slot;
+    accepted_ = true;
+    lock.unlock();
+    cv_.notify_one();
+    return true;
+  }
+
+  /// 等待缓冲区中的帧全部编码并关闭视频
+  void Close() {
+    {
+      std::lock_guard lock{lock_};
+      if (stop_flag_ || !writer_) {
+        return;
+      }
+      stop_flag_ = true;
+    }
+    cv_.notify_one();
+    thread_.join();
+    writer_->release();
+    LOG(INFO) << "Video writer is closed: " << statistics_.received << " frames received, " << statistics_.written
+              << " written, " << statistics_.duplicated << " duplicated, " << statistics_.resampled << " resampled, "
+              << statistics_.decimated << " decimated, " << statistics_.dropped << " dropped, "
+              << statistics_.discontinuities << " discontinuities.";
+  }
+
+  /// 录像统计数据
+  [[nodiscard]] WriterStatistics Statistics() {
+    std::lock_guard lock{lock_};
+    return statistics_;
+  }
+
+ private:
+  /**
+   * @brief 超出预算时为有识别结果的帧腾出空间，丢弃最新的无识别结果帧
+   * @return 是否腾出了足够的空间
+   */
+  bool EvictForDetection(const bool detection, const size_t bytes) {
+    if (!detection) {
+      return false;
+    }
+    for (auto it = queue_.rbegin(); it != queue_.rend() && queued_bytes_ + bytes > memory_budget_;) {
+      if (it->detection) {
+        ++it;
+        continue;
+      }
+      queued_bytes_ -= it->image.total() * it->image.elemSize();
+      ++statistics_.dropped;
+      it = std::make_reverse_iterator(queue_.erase(std::next(it).base()));
+    }
+    return queued_bytes_ + bytes <= memory_budget_;
+  }
+
+  /// 编码线程，跳过的输出帧用上一帧补齐
+  void Encode() {
+    cv::Mat image;
+    cv::Mat last_image;
+    uint64_t next_slot = 0;
+    while (true) {
+      Item item;
+      {
+        std::unique_lock lock{lock_};
+        cv_.wait(lock, [this] { return !queue_.empty() || stop_flag_; });
+        if (queue_.empty()) {
+          return;
+        }
+        item = std::move(queue_.front());
+        queue_.pop_front();
+      }
+      uint64_t duplicated = 0;
+      /// 时间轴在 Write 中已保证连续，此处再限制一次补齐的数量
+      next_slot = std::max(next_slot, item.slot > kMaxGap ? item.slot - kMaxGap : 0);
+      for (; !last_image.empty() && next_slot < item.slot; ++next_slot, ++duplicated) {
+        writer_->write(last_image);
+      }
+      const size_t bytes = item.image.total() * item.image.elemSize();
+      ToBgr(item.image, item.pixel_format, image);
+      if (image.size() != frame_size_) {
+        cv::resize(image, image, frame_size_);
+      }
+      writer_->write(image);
+      next_slot = item.slot + 1;
+      std::lock_guard lock{lock_};
+      queued_bytes_ -= bytes;
+      ++statistics_.written;
+      statistics_.duplicated += duplicated;
+      last_image = std::move(image);
+    }
+  }
+
+  std::unique_ptr<cv::VideoWriter> writer_;  ///< 视频写入接口
+  cv::Size frame_size_;                      ///< 视频图像大小
+  uint64_t period_{};                        ///< 输出帧间隔，单位 ns
+  size_t memory_budget_{};                   ///< 缓冲区内存预算，单位字节
+  uint64_t decimation_{};                    ///< 抽帧间隔
+
+  std::deque<Item> queue_;         ///< 等待编码的帧
+  size_t queued_bytes_{};          ///< 缓冲区占用的字节数
+  bool started_{};                 ///< 是否收到过帧
+  bool accepted_{};                ///< 是否接收过帧
+  uint64_t base_time_stamp_{};     ///< 当前时间轴起点的时间戳
+  uint64_t base_slot_{};           ///< 当前时间轴起点的输出帧序号
+  uint64_t last_time_stamp_{};     ///< 最近收到的帧的时间戳
+  uint64_t last_received_slot_{};  ///< 最近收到的帧的输出帧序号
+  uint64_t last_slot_{};           ///< 最近接收的帧的输出帧序号
+  WriterStatistics statistics_;    ///< 录像统计数据
+  std::mutex lock_;                ///< 队列锁
+  std::condition_variable cv_;     ///< 队列通知
+  bool stop_flag_{};               ///< 写入线程停止信号
+  std::thread thread_;             ///< 写入线程
+};
+
+}  // namespace srm::video
+
+#endif  // SRM_VIDEO_WRITER_ADAPTIVE_HPP_
@@ -1,6 +1,11 @@
 #ifndef SRM_VIEWER_VIEWER_HPP_
 #define SRM_VIEWER_VIEWER_HPP_
 
+#include "srm/viewer/jpeg-encoder.hpp"
+#include "srm/viewer/overlay.hpp"
+#include "srm/viewer/server-http.hpp"
+#include "srm/viewer/shm-ring.hpp"
 #include "srm/viewer/viewer-video.h"
+#include "srm/viewer/viewer-web.hpp"
 
 #endif  // SRM_VIEWER_HPP_
@@ -0,0 +1,99 @@
+#ifndef SRM_VIEWER_JPEG_ENCODER_HPP_
+#define SRM_VIEWER_JPEG_ENCODER_HPP_
+
+#include <glog/logging.h>
+
+#include <cstdint>
+#include <opencv2/imgcodecs.hpp>
+#include <vector>
+
+#if defined(SRM_HAS_TURBOJPEG)
+#include <turbojpeg.h>
+#endif
+
+#include "srm/common/tags.hpp"
+
+namespace srm::viewer {
+
+/**
+ * @brief JPEG 编码器
+ * @details
+ * 编译时找到 libjpeg-turbo 则直接调用 TurboJPEG，压缩句柄和输出缓冲区在多次编码间复用，
+ * 否则退化为 cv::imencode，输出缓冲区同样复用。只应在单个线程中使用。
+ */
+class JpegEncoder final {
+ public:
+  JpegEncoder() = default;
+  ~JpegEncoder() {
+#if defined(SRM_HAS_TURBOJPEG)
+    if (buffer_) {
+      tjFree(buffer_);
+    }
+    if (handle_) {
+      tjDestroy(handle_);
+    }
+#endif
+  }
+
+  JpegEncoder(const JpegEncoder &) = delete;
+  JpegEncoder &operator=(const JpegEncoder &) = delete;
+
+  /**
+   * @brief 编码一张图像
+   * @param [in] image BGR 图像，可以是不连续的子图
+   * @param quality 编码质量，0 到 100
+   * @return 是否编码成功，成功后通过 Data 和 Size 取得结果，结果在下一次编码前有效
+   */
+  bool Encode(cv::Mat REF_IN image, const int quality) {
+    if (image.type() != CV_8UC3) {
+      LOG_EVERY_N(ERROR, 100) << "Only BGR images can be encoded for viewer.";
+      return false;
+    }
+#if defined(SRM_HAS_TURBOJPEG)
+    if (!handle_ && !(handle_ = tjInitCompress())) {
+      LOG(ERROR) << "Failed to initialize TurboJPEG.";
+      return false;
+    }
+    const auto capacity = tjBufSize(image.cols, image.rows, TJSAMP_420);
+    if (capacity > capacity_) {
+      if (buffer_) {
+        tjFree(buffer_);
+      }
+      buffer_ = tjAlloc(static_cast<int>(capacity));
+      capacity_ = capacity;
+    }
+    size_ = capacity_;
+    if (tjCompress2(handle_, image.data, image.cols, static_cast<int>(image.step), image.rows, TJPF_BGR, &buffer_,
+                    &size_, TJSAMP_420, quality, TJFLAG_NOREALLOC | TJFLAG_FASTDCT) != 0) {
+      LOG_EVERY_N(ERROR, 100) << "Failed to encode frame for viewer: " << tjGetErrorStr2(handle_);
+      return false;
+    }
+    return true;
+#else
+    return cv::imencode(".jpg", image, buffer_, {cv::IMWRITE_JPEG_QUALITY, quality});
+#endif
+  }
+
+  /// 编码结果
+#if defined(SRM_HAS_TURBOJPEG)
+  [[nodiscard]] const uint8_t *Data() const { return buffer_; }
+  [[nodiscard]] size_t Size() const { return size_; }
+#else
+  [[nodiscard]] const uint8_t *Data() const { return buffer_.data(); }
+  [[nodiscard]] size_t Size() const { return buffer_.size(); }
+#endif
+
+ private:
+#if defined(SRM_HAS_TURBOJPEG)
+  tjhandle handle_{};         ///< 压缩句柄
+  uint8_t *buffer_{};         ///< 输出缓冲区
+  unsigned long capacity_{};  ///< 输出缓冲区大小
+  unsigned long size_{};      ///< 编码结果大小
+#else
+  std::vector<uint8_t> buffer_;  ///< 输出缓冲区
+#endif
+};
+
+}  // namespace srm::viewer
+
+#endif  // SRM_VIEWER_JPEG_ENCODER_HPP_
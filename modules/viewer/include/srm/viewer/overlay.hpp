@@ -0,0 +1,121 @@
+#ifndef SRM_VIEWER_OVERLAY_HPP_
+#define SRM_VIEWER_OVERLAY_HPP_
+
+#include <algorithm>
+#include <opencv2/imgproc.hpp>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace srm::viewer {
+
+/**
+ * @brief 单帧的叠加绘图指令
+ * @details
+ * 绘图类只记录要画的图形，不修改原图。网页端在 canvas 上绘制，
+ * 只有需要带绘图的 JPEG 时才调用 Rasterize 画到图像副本上。
+ */
+struct Overlay {
+  /// 折线
+  struct Polyline {
+    std::vector<cv::Point2f> pts;  ///< 顶点
+    cv::Scalar color;              ///< 颜色，BGR
+    int thickness;                 ///< 线宽
+    bool closed;                   ///< 是否首尾相连
+  };
+
+  /// 圆
+  struct Circle {
+    cv::Point2f center;  ///< 圆心
+    float radius;        ///< 半径
+    cv::Scalar color;    ///< 颜色，BGR
+    int thickness;       ///< 线宽
+  };
+
+  /// 文字
+  struct Text {
+    cv::Point2f pos;   ///< 左下角位置
+    std::string text;  ///< 内容
+    cv::Scalar color;  ///< 颜色，BGR
+  };
+
+  std::vector<Polyline> polylines;  ///< 折线列表
+  std::vector<Circle> circles;      ///< 圆列表
+  std::vector<Text> texts;          ///< 文字列表
+
+  void Clear() {
+    polylines.clear();
+    circles.clear();
+    texts.clear();
+  }
+
+  [[nodiscard]] bool Empty() const { return polylines.empty() && circles.empty() && texts.empty(); }
+
+  /**
+   * @brief 将所有图形画到图像上
+   * @param [in] image 目标图像，可以是原图裁剪缩放后的预览图
+   * @param offset 预览图左上角在原图中的位置
+   * @param scale 预览图相对原图的缩放比例
+   */
+  void Rasterize(cv::Mat &image, const cv::Point2f offset = {}, const float scale = 1) const {
+    const auto map = [&](const cv::Point2f &pt) { return (pt - offset) * scale; };
+    for (const auto &[pts, color, thickness, closed] : polylines) {
+      for (size_t i = 0; i + 1 < pts.size(); ++i) {
+        cv::line(image, map(pts[i]), map(pts[i + 1]), color, thickness);
+      }
+      if (closed && pts.size() > 2) {
+        cv::line(image, map(pts.back()), map(pts.front()), color, thickness);
+      }
+    }
+    for (const auto &[center, radius, color, thickness] : circles) {
+      cv::circle(image, map(center), std::max(1, static_cast<int>(radius * scale)), color, thickness);
+    }
+    for (const auto &[pos, text, color] : texts) {
+      cv::putText(image, text, map(pos), cv::FONT_HERSHEY_SIMPLEX, 0.6, color, 1);
+    }
+  }
+
+  /**
+   * @brief 以 JSON 数组形式输出所有图形，供网页端绘制
+   * @details 每个元素形如 {"type":"polyline","color":"rgb(r,g,b)","width":1,"closed":true,"pts":[x0,y0,...]}
+   */
+  void WriteJson(std::ostream &json) const {
+    const auto color_str = [](const cv::Scalar &color) {
+      return "\"rgb(" + std::to_string(static_cast<int>(color[2])) + "," + std::to_string(static_cast<int>(color[1])) +
+             "," + std::to_string(static_cast<int>(color[0])) + ")\"";
+    };
+    bool first = true;
+    json << "[";
+    for (const auto &[pts, color, thickness, closed] : polylines) {
+      json << (first ? "" : ",") << R"({"type":"polyline","color":)" << color_str(color) << R"(,"width":)" << thickness
+           << R"(,"closed":)" << (closed ? "true" : "false") << R"(,"pts":[)";
+      for (size_t i = 0; i < pts.size(); ++i) {
+        json << (i ? "," : "") << pts[i].x << "," << pts[i].y;
+      }
+      json << "]}";
+      first = false;
+    }
+    for (const auto &[center, radius, color, thickness] : circles) {
+      json << (first ? "" : ",") << R"({"type":"circle","color":)" << color_str(color) << R"(,"width":)" << thickness
+           << R"(,"x":)" << center.x << R"(,"y":)" << center.y << R"(,"r":)" << radius << "}";
+      first = false;
+    }
+    for (const auto &[pos, text, color] : texts) {
+      json << (first ? "" : ",") << R"({"type":"text","color":)" << color_str(color) << R"(,"x":)" << pos.x
+           << R"(,"y":)" << pos.y << R"(,"text":")";
+      for (const char c : text) {
+        if (c == '"' || c == '\\') {
+          json << '\\';
+        }
+        json << c;
+      }
+      json << "\"}";
+      first = false;
+    }
+    json << "]";
+  }
+};
+
+}  // namespace srm::viewer
+
+#endif  // SRM_VIEWER_OVERLAY_HPP_
@@ -0,0 +1,657 @@
+#ifndef SRM_VIEWER_SERVER_HTTP_HPP_
+#define SRM_VIEWER_SERVER_HTTP_HPP_
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <glog/logging.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cctype>
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/syscall.h>
+#endif
+
+#include "srm/common/tags.hpp"
+
+namespace srm::viewer {
+
+namespace http {
+
+/// 计算 SHA-1 摘要，仅用于 WebSocket 握手
+inline std::array<uint8_t, 20> Sha1(std::string REF_IN data) {
+  uint32_t h[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+  std::string msg = data;
+  const uint64_t bit_len = static_cast<uint64_t>(data.size()) * 8;
+  msg.push_back(static_cast<char>(0x80));
+  while (msg.size() % 64 != 56) {
+    msg.push_back(0);
+  }
+  for (int i = 7; i >= 0; --i) {
+    msg.push_back(static_cast<char>(bit_len >> (i * 8)));
+  }
+  const auto rotl = [](const uint32_t x, const int n) { return (x << n) | (x >> (32 - n)); };
+  for (size_t chunk = 0; chunk < msg.size(); chunk += 64) {
+    uint32_t w[80];
+    for (int i = 0; i < 16; ++i) {
+      const auto *p = reinterpret_cast<const uint8_t *>(msg.data() + chunk + i * 4);
+      w[i] = (p[0] << 24) | (p[1] << 16) | (p[2] << 8) | p[3];
+    }
+    for (int i = 16; i < 80; ++i) {
+      w[i] = rotl(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+    }
+    uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+    for (int i = 0; i < 80; ++i) {
+      uint32_t f, k;
+      if (i < 20) {
+        f = (b & c) | (~b & d), k = 0x5A827999;
+      } else if (i < 40) {
+        f = b ^ c ^ d, k = 0x6ED9EBA1;
+      } else if (i < 60) {
+        f = (b & c) | (b & d) | (c & d), k = 0x8F1BBCDC;
+      } else {
+        f = b ^ c ^ d, k = 0xCA62C1D6;
+      }
+      const uint32_t temp = rotl(a, 5) + f + e + k + w[i];
+      e = d, d = c, c = rotl(b, 30), b = a, a = temp;
+    }
+    h[0] += a, h[1] += b, h[2] += c, h[3] += d, h[4] += e;
+  }
+  std::array<uint8_t, 20> digest{};
+  for (int i = 0; i < 20; ++i) {
+    digest[i] = static_cast<uint8_t>(h[i / 4] >> (24 - (i % 4) * 8));
+  }
+  return digest;
+}
+
+/// Base64 编码
+inline std::string Base64(const uint8_t *data, const size_t size) {
+  static constexpr char kTable[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  std::string out;
+  for (size_t i = 0; i < size; i += 3) {
+    const uint32_t n = (data[i] << 16) | (i + 1 < size ? data[i + 1] << 8 : 0) | (i + 2 < size ? data[i + 2] : 0);
+    out.push_back(kTable[(n >> 18) & 63]);
+    out.push_back(kTable[(n >> 12) & 63]);
+    out.push_back(i + 1 < size ? kTable[(n >> 6) & 63] : '=');
+    out.push_back(i + 2 < size ? kTable[n & 63] : '=');
+  }
+  return out;
+}
+
+/// 解码 application/x-www-form-urlencoded 中的值
+inline std::string UrlDecode(std::string REF_IN str) {
+  std::string out;
+  out.reserve(str.size());
+  for (size_t i = 0; i < str.size(); ++i) {
+    if (str[i] == '+') {
+      out.push_back(' ');
+    } else if (str[i] == '%') {
+      /// 不完整或非十六进制的转义原样保留
+      unsigned char value = 0;
+      const char *begin = str.data() + i + 1;
+      const char *end = str.data() + std::min(i + 3, str.size());
+      const auto [ptr, ec] = std::from_chars(begin, end, value, 16);
+      if (ec != std::errc{} || ptr != begin + 2) {
+        out.push_back(str[i]);
+        continue;
+      }
+      out.push_back(static_cast<char>(value));
+      i += 2;
+    } else {
+      out.push_back(str[i]);
+    }
+  }
+  return out;
+}
+
+/// 转义 HTML 特殊字符
+inline std::string HtmlEscape(std::string REF_IN str) {
+  std::string out;
+  out.reserve(str.size());
+  for (const char c : str) {
+    switch (c) {
+      case '&': out += "&amp;"; break;
+      case '<': out += "&lt;"; break;
+      case '>': out += "&gt;"; break;
+      case '"': out += "&quot;"; break;
+      default: out.push_back(c);
+    }
+  }
+  return out;
+}
+
+/// 读取整个文件
+inline bool ReadFile(std::string REF_IN path, std::string REF_OUT content) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file.is_open()) {
+    return false;
+  }
+  std::stringstream ss;
+  ss << file.rdbuf();
+  content = ss.str();
+  return true;
+}
+
+/// 根据扩展名得到 Content-Type
+inline std::string ContentType(std::string REF_IN path) {
+  static const std::unordered_map<std::string, std::string> kTypes = {
+      {".html", "text/html; charset=utf-8"}, {".js", "application/javascript"}, {".css", "text/css"},
+      {".json", "application/json"},         {".png", "image/png"},             {".jpg", "image/jpeg"}};
+  const auto dot = path.rfind('.');
+  if (dot != std::string::npos) {
+    if (const auto it = kTypes.find(path.substr(dot)); it != kTypes.end()) {
+      return it->second;
+    }
+  }
+  return "application/octet-stream";
+}
+
+}  // namespace http
+
+/**
+ * @brief 内嵌的调试网页服务器
+ * @details
+ * 在独立的低优先级线程中用 epoll 处理所有连接，提供：
+ * - GET / ：配置编辑和视频页面，由 templates/video.html 渲染
+ * - GET /static/... ：静态资源
+ * - GET /VideoStream ：MJPEG 视频流
+ * - GET /ws ：WebSocket，每帧推送一条 JSON 格式的帧信息和识别结果
+ * - POST /save ：保存配置文件
+ *
+ * Publish 只替换最新一帧的指针并通过 eventfd 唤醒服务线程，从不阻塞调用者；
+ * 客户端接收不及时、发送缓冲区积压超过上限时跳过该客户端的新帧。
+ */
+class HttpServer final {
+  static constexpr size_t kMaxBacklog = 4 << 20;  ///< 每个客户端发送缓冲区的积压上限
+  static constexpr size_t kMaxRequest = 1 << 20;  ///< 请求的最大长度
+
+  /// 连接类型
+  enum class ConnectionType {
+    kHttp,       ///< 普通请求
+    kStream,     ///< MJPEG 视频流
+    kWebSocket,  ///< WebSocket
+  };
+
+  /// 客户端连接
+  struct Connection {
+    int fd{};                                     ///< 套接字
+    ConnectionType type = ConnectionType::kHttp;  ///< 连接类型
+    std::string in;                               ///< 接收缓冲区
+    std::string out;                              ///< 发送缓冲区
+    size_t out_offset{};                          ///< 发送缓冲区中已发送的字节数
+    bool close_after_write{};                     ///< 发送完毕后关闭连接
+    bool want_write{};                            ///< 是否在等待套接字可写
+    bool broken{};                                ///< 连接已断开或出错，等待关闭
+  };
+
+ public:
+  HttpServer() = default;
+  ~HttpServer() { Stop(); }
+
+  /**
+   * @brief 启动服务器
+   * @param port 监听端口
+   * @param [in] assets_dir static 和 templates 目录所在的路径
+   * @param [in] config_file 配置编辑器读写的配置文件
+   * @return 是否启动成功
+   */
+  bool Start(const int port, std::string REF_IN assets_dir, std::string REF_IN config_file) {
+#if defined(__linux__)
+    assets_dir_ = assets_dir;
+    config_file_ = config_file;
+    listen_fd_ = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    const int on = 1;
+    /// 复用处于 TIME_WAIT 的端口，不再需要杀掉占用端口的进程
+    setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(port);
+    if (bind(listen_fd_, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0 || listen(listen_fd_, 16) != 0) {
+      LOG(ERROR) << "Failed to listen on port " << port << ": " << std::strerror(errno) << ".";
+      close(listen_fd_);
+      listen_fd_ = -1;
+      return false;
+    }
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    event_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    Watch(listen_fd_, EPOLLIN, EPOLL_CTL_ADD);
+    Watch(event_fd_, EPOLLIN, EPOLL_CTL_ADD);
+    thread_ = std::thread([this] { Loop(); });
+    LOG(INFO) << "Viewer server is listening on port " << port << ".";
+    return true;
+#else
+    LOG(ERROR) << "Viewer server is only supported on Linux.";
+    return false;
+#endif
+  }
+
+  /// 停止服务器并关闭所有连接
+  void Stop() {
+    if (!thread_.joinable()) {
+      return;
+    }
+    stop_flag_ = true;
+    Notify();
+    thread_.join();
+    for (const auto &[fd, connection] : connections_) {
+      close(fd);
+    }
+    connections_.clear();
+    close(listen_fd_);
+    close(epoll_fd_);
+    close(event_fd_);
+  }
+
+  /// 是否有视频流或 WebSocket 客户端
+  [[nodiscard]] bool Subscribed() const { return subscribers_.load(std::memory_order_relaxed) > 0; }
+
+  /**
+   * @brief 发布最新一帧，立即返回
+   * @param jpeg JPEG 数据，为空时只推送帧信息
+   * @param json 帧信息和识别结果
+   */
+  void Publish(std::shared_ptr<const std::vector<uint8_t>> jpeg, std::shared_ptr<const std::string> json) {
+    {
+      std::lock_guard lock{lock_};
+      jpeg_ = std::move(jpeg);
+      json_ = std::move(json);
+    }
+    Notify();
+  }
+
+ private:
+#if defined(__linux__)
+  /// 服务线程主循环
+  void Loop() {
+    setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), 10);
+    std::array<epoll_event, 32> events{};
+    while (!stop_flag_) {
+      const int n = epoll_wait(epoll_fd_, events.data(), events.size(), 1000);
+      for (int i = 0; i < n; ++i) {
+        const int fd = events[i].data.fd;
+        if (fd == listen_fd_) {
+          Accept();
+        } else if (fd == event_fd_) {
+          uint64_t value;
+          while (read(event_fd_, &value, sizeof(value)) > 0) {
+          }
+          Broadcast();
+        } else if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+          Close(fd);
+        } else if (const auto it = connections_.find(fd); it != connections_.end()) {
+          auto &connection = it->second;
+          if (events[i].events & EPOLLIN) {
+            Receive(connection);
+          }
+          if (events[i].events & EPOLLOUT) {
+            Flush(connection);
+          }
+          if (Finished(connection)) {
+            Close(fd);
+          }
+        }
+      }
+    }
+  }
+
+  void Watch(const int fd, const uint32_t events, const int op) const {
+    epoll_event event{};
+    event.events = events;
+    event.data.fd = fd;
+    epoll_ctl(epoll_fd_, op, fd, &event);
+  }
+
+  void Accept() {
+    while (true) {
+      const int fd = accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+      if (fd < 0) {
+        return;
+      }
+      const int on = 1;
+      setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+      connections_[fd].fd = fd;
+      Watch(fd, EPOLLIN, EPOLL_CTL_ADD);
+    }
+  }
+
+  void Close(const int fd) {
+    const auto it = connections_.find(fd);
+    if (it == connections_.end()) {
+      return;
+    }
+    if (it->second.type != ConnectionType::kHttp) {
+      subscribers_.fetch_sub(1, std::memory_order_relaxed);
+    }
+    epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+    close(fd);
+    connections_.erase(it);
+  }
+
+  /// 连接是否可以关闭
+  static bool Finished(Connection REF_IN connection) {
+    return connection.broken || (connection.close_after_write && connection.out_offset == connection.out.size());
+  }
+
+  void Receive(Connection REF_OUT connection) {
+    char buffer[4096];
+    while (true) {
+      const auto size = read(connection.fd, buffer, sizeof(buffer));
+      if (size > 0) {
+        connection.in.append(buffer, size);
+        continue;
+      }
+      if (size == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) {
+        connection.broken = true;
+        return;
+      }
+      break;
+    }
+    if (connection.in.size() > kMaxRequest) {
+      connection.broken = true;
+      return;
+    }
+    if (connection.type == ConnectionType::kWebSocket) {
+      ReceiveWebSocket(connection);
+    } else if (connection.type == ConnectionType::kHttp) {
+      ReceiveHttp(connection);
+    }
+  }
+
+  /// 解析完整的 HTTP 请求并分发
+  void ReceiveHttp(Connection REF_OUT connection) {
+    const auto header_end = connection.in.find("\r\n\r\n");
+    if (header_end == std::string::npos) {
+      return;
+    }
+    const std::string header = connection.in.substr(0, header_end);
+    std::istringstream request_line(header.substr(0, header.find("\r\n")));
+    std::string method, target;
+    request_line >> method >> target;
+    const auto length_value = HeaderValue(header, "content-length").value_or("0");
+    size_t content_length = 0;
+    const auto [ptr, ec] =
+        std::from_chars(length_value.data(), length_value.data() + length_value.size(), content_length);
+    if (ec != std::errc{} || ptr != length_value.data() + length_value.size() || content_length > kMaxRequest) {
+      connection.in.clear();
+      Respond(connection, "400 Bad Request", "text/plain", "Bad Content-Length");
+      return;
+    }
+    if (connection.in.size() < header_end + 4 + content_length) {
+      return;
+    }
+    const std::string body = connection.in.substr(header_end + 4, content_length);
+    connection.in.erase(0, header_end + 4 + content_length);
+
+    if (method == "GET" && target == "/") {
+      ServeIndex(connection);
+    } else if (method == "GET" && target.starts_with("/static/") && target.find("..") == std::string::npos) {
+      ServeFile(connection, assets_dir_ + target);
+    } else if (method == "GET" && target == "/VideoStream") {
+      connection.type = ConnectionType::kStream;
+      subscribers_.fetch_add(1, std::memory_order_relaxed);
+      Append(connection, "HTTP/1.1 200 OK\r\nContent-Type: multipart/x-mixed-replace; boundary=frame\r\n"
+                         "Cache-Control: no-cache\r\nConnection: close\r\n\r\n");
+    } else if (method == "GET" && target == "/ws") {
+      UpgradeWebSocket(connection, header);
+    } else if (method == "POST" && target == "/save") {
+      SaveConfig(connection, body);
+    } else {
+      Respond(connection, "404 Not Found", "text/plain", "Not Found");
+    }
+  }
+
+  /// 处理客户端发来的 WebSocket 帧，只关心关闭和 ping
+  void ReceiveWebSocket(Connection REF_OUT connection) {
+    auto &in = connection.in;
+    while (in.size() >= 2) {
+      const auto opcode = static_cast<uint8_t>(in[0]) & 0x0F;
+      uint64_t length = static_cast<uint8_t>(in[1]) & 0x7F;
+      size_t offset = 2;
+      if (length == 126) {
+        if (in.size() < 4) {
+          return;
+        }
+        length = (static_cast<uint8_t>(in[2]) << 8) | static_cast<uint8_t>(in[3]);
+        offset = 4;
+      } else if (length == 127) {
+        connection.broken = true;
+        return;
+      }
+      const bool masked = static_cast<uint8_t>(in[1]) & 0x80;
+      const size_t total = offset + (masked ? 4 : 0) + length;
+      if (in.size() < total) {
+        return;
+      }
+      if (opcode == 0x8) {
+        connection.broken = true;
+        return;
+      }
+      if (opcode == 0x9) {
+        std::string payload = in.substr(offset + (masked ? 4 : 0), length);
+        if (masked) {
+          for (size_t i = 0; i < payload.size(); ++i) {
+            payload[i] ^= in[offset + i % 4];
+          }
+        }
+        Append(connection, WebSocketFrame(0xA, payload));
+      }
+      in.erase(0, total);
+    }
+  }
+
+  void UpgradeWebSocket(Connection REF_OUT connection, std::string REF_IN header) {
+    const auto key = HeaderValue(header, "sec-websocket-key");
+    if (!key) {
+      Respond(connection, "400 Bad Request", "text/plain", "Bad Request");
+      return;
+    }
+    const auto digest = http::Sha1(*key + "258EAFA5-E914-47DA-95CA-C5AB0DC85B11");
+    connection.type = ConnectionType::kWebSocket;
+    subscribers_.fetch_add(1, std::memory_order_relaxed);
+    Append(connection, "HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+                       "Sec-WebSocket-Accept: " +
+                           http::Base64(digest.data(), digest.size()) + "\r\n\r\n");
+  }
+
+  void ServeIndex(Connection REF_OUT connection) {
+    std::string page, config;
+    if (!http::ReadFile(assets_dir_ + "/templates/video.html", page) || !http::ReadFile(config_file_, config)) {
+      Respond(connection, "500 Internal Server Error", "text/plain", "Failed to read page or config.");
+      return;
+    }
+    Replace(page, "{{ config }}", http::HtmlEscape(config));
+    Replace(page, "{{ url_for('VideoStream') }}", "/VideoStream");
+    Respond(connection, "200 OK", "text/html; charset=utf-8", page);
+  }
+
+  void ServeFile(Connection REF_OUT connection, std::string REF_IN path) {
+    std::string content;
+    if (!http::ReadFile(path, content)) {
+      Respond(connection, "404 Not Found", "text/plain", "Not Found");
+      return;
+    }
+    Respond(connection, "200 OK", http::ContentType(path), content);
+  }
+
+  void SaveConfig(Connection REF_OUT connection, std::string REF_IN body) {
+    constexpr std::string_view kKey = "content=";
+    const auto begin = body.find(kKey);
+    if (begin == std::string::npos) {
+      Respond(connection, "400 Bad Request", "application/json", R"({"status": "error"})");
+      return;
+    }
+    const auto end = body.find('&', begin);
+    const auto content = http::UrlDecode(body.substr(begin + kKey.size(), end - begin - kKey.size()));
+    std::ofstream file(config_file_, std::ios::trunc);
+    file << content;
+    Respond(connection, "200 OK", "application/json",
+            file ? R"({"status": "success"})" : R"({"status": "error"})");
+  }
+
+  /// 将最新一帧发送给所有订阅者，积压过多的客户端跳过本帧
+  void Broadcast() {
+    std::shared_ptr<const std::vector<uint8_t>> jpeg;
+    std::shared_ptr<const std::string> json;
+    {
+      std::lock_guard lock{lock_};
+      jpeg.swap(jpeg_);
+      json.swap(json_);
+    }
+    std::vector<int> finished;
+    for (auto &[fd, connection] : connections_) {
+      if (connection.out.size() - connection.out_offset > kMaxBacklog) {
+        continue;
+      }
+      if (connection.type == ConnectionType::kStream && jpeg) {
+        Append(connection, "--frame\r\nContent-Type: image/jpeg\r\nContent-Length: " + std::to_string(jpeg->size()) +
+                               "\r\n\r\n");
+        Append(connection, std::string_view(reinterpret_cast<const char *>(jpeg->data()), jpeg->size()));
+        Append(connection, "\r\n");
+      } else if (connection.type == ConnectionType::kWebSocket && json) {
+        Append(connection, WebSocketFrame(0x1, *json));
+      }
+      if (Finished(connection)) {
+        finished.push_back(fd);
+      }
+    }
+    for (const int fd : finished) {
+      Close(fd);
+    }
+  }
+
+  void Respond(Connection REF_OUT connection, std::string REF_IN status, std::string REF_IN type,
+               std::string_view body) {
+    Append(connection, "HTTP/1.1 " + status + "\r\nContent-Type: " + type +
+                           "\r\nContent-Length: " + std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n");
+    Append(connection, body);
+    connection.close_after_write = true;
+  }
+
+  /// 追加到发送缓冲区，套接字空闲时立即发送
+  void Append(Connection REF_OUT connection, std::string_view data) {
+    connection.out.append(data);
+    if (!connection.want_write) {
+      Flush(connection);
+    }
+  }
+
+  /// 尽可能多地发送缓冲区中的数据，发不完时等待套接字可写
+  void Flush(Connection REF_OUT connection) {
+    while (!connection.broken && connection.out_offset < connection.out.size()) {
+      const auto size = send(connection.fd, connection.out.data() + connection.out_offset,
+                             connection.out.size() - connection.out_offset, MSG_NOSIGNAL);
+      if (size > 0) {
+        connection.out_offset += size;
+        continue;
+      }
+      if (size < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+        if (!connection.want_write) {
+          connection.want_write = true;
+          Watch(connection.fd, EPOLLIN | EPOLLOUT, EPOLL_CTL_MOD);
+        }
+        return;
+      }
+      connection.broken = true;
+      return;
+    }
+    connection.out.clear();
+    connection.out_offset = 0;
+    if (connection.want_write) {
+      connection.want_write = false;
+      Watch(connection.fd, EPOLLIN, EPOLL_CTL_MOD);
+    }
+  }
+
+  static std::string WebSocketFrame(const uint8_t opcode, std::string_view payload) {
+    std::string frame;
+    frame.push_back(static_cast<char>(0x80 | opcode));
+    if (payload.size() < 126) {
+      frame.push_back(static_cast<char>(payload.size()));
+    } else if (payload.size() < 65536) {
+      frame.push_back(126);
+      frame.push_back(static_cast<char>(payload.size() >> 8));
+      frame.push_back(static_cast<char>(payload.size()));
+    } else {
+      frame.push_back(127);
+      for (int i = 7; i >= 0; --i) {
+        frame.push_back(static_cast<char>(static_cast<uint64_t>(payload.size()) >> (i * 8)));
+      }
+    }
+    frame.append(payload);
+    return frame;
+  }
+
+  /// 取出请求头中的字段，字段名不区分大小写
+  static std::optional<std::string> HeaderValue(std::string REF_IN header, std::string REF_IN name) {
+    std::istringstream lines(header);
+    std::string line;
+    while (std::getline(lines, line)) {
+      const auto colon = line.find(':');
+      if (colon == std::string::npos || colon != name.size()) {
+        continue;
+      }
+      if (std::equal(name.begin(), name.end(), line.begin(),
+                     [](const char a, const char b) { return a == std::tolower(b); })) {
+        auto value = line.substr(colon + 1);
+        value.erase(0, value.find_first_not_of(' '));
+        value.erase(value.find_last_not_of(" \r") + 1);
+        return value;
+      }
+    }
+    return std::nullopt;
+  }
+
+  static void Replace(std::string REF_OUT str, std::string_view from, std::string REF_IN to) {
+    if (const auto pos = str.find(from); pos != std::string::npos) {
+      str.replace(pos, from.size(), to);
+    }
+  }
+#endif
+
+  void Notify() const {
+#if defined(__linux__)
+    const uint64_t one = 1;
+    [[maybe_unused]] const auto ret = write(event_fd_, &one, sizeof(one));
+#endif
+  }
+
+  std::string assets_dir_;                           ///< static 和 templates 目录所在的路径
+  std::string config_file_;                          ///< 配置文件路径
+  int listen_fd_ = -1;                               ///< 监听套接字
+  int epoll_fd_ = -1;                                ///< epoll 实例
+  int event_fd_ = -1;                                ///< 新帧通知
+  std::unordered_map<int, Connection> connections_;  ///< 所有客户端连接
+  std::atomic_int subscribers_{};                    ///< 视频流和 WebSocket 客户端数量
+  std::atomic_bool stop_flag_{};                     ///< 服务线程停止信号
+  std::thread thread_;                               ///< 服务线程
+
+  std::shared_ptr<const std::vector<uint8_t>> jpeg_;  ///< 待发送的最新一帧
+  std::shared_ptr<const std::string> json_;           ///< 待发送的最新帧信息
+  std::mutex lock_;                                   ///< 待发送数据的锁
+};
+
+}  // namespace srm::viewer
+
+#endif  // SRM_VIEWER_SERVER_HTTP_HPP_
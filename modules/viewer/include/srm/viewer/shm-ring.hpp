@@ -0,0 +1,203 @@
+#ifndef SRM_VIEWER_SHM_RING_HPP_
+#define SRM_VIEWER_SHM_RING_HPP_
+
+#include <fcntl.h>
+#include <glog/logging.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+#include "srm/common/tags.hpp"
+
+namespace srm::viewer {
+
+/**
+ * @brief 共享内存环形缓冲区格式
+ * @details
+ * 布局固定，供其他进程（如 video.py）直接按偏移读取，所有整数均为小端：
+ * @code
+ * ShmRingHeader（64 字节）
+ * 槽位 0：ShmSlotHeader（64 字节）| ViewerDetection * kMaxDetections | JPEG 数据（slot_size 字节）
+ * 槽位 1：...
+ * @endcode
+ * 每个槽位使用顺序锁：写入前 seq 变为奇数，写完后变为下一个偶数，读者前后两次读到相同的偶数才说明数据完整。
+ * 每发布一帧 futex 加一并唤醒等待者，读者可在 futex 上阻塞等待新帧。
+ * 读者每次读取时更新 heartbeat，写者据此判断是否有读者连接，没有读者时不编码。
+ */
+namespace shm_ring {
+
+constexpr std::array<char, 4> kMagic = {'S', 'R', 'M', 'V'};  ///< 共享内存标识
+constexpr uint32_t kVersion = 2;                              ///< 格式版本
+constexpr uint32_t kMaxDetections = 32;                       ///< 每帧最多附带的识别结果数量
+constexpr uint64_t kHeartbeatTimeout = 2'000'000'000;         ///< 读者心跳超时，单位 ns
+
+}  // namespace shm_ring
+
+/// 识别结果
+struct ViewerDetection {
+  std::array<float, 8> pts{};  ///< 四个角点的坐标 (x0, y0, ..., x3, y3)
+  int32_t label{};             ///< 类别
+  float prob{};                ///< 置信度
+};
+
+/// 共享内存头
+struct alignas(64) ShmRingHeader {
+  std::array<char, 4> magic = shm_ring::kMagic;  ///< 共享内存标识
+  uint32_t version = shm_ring::kVersion;         ///< 格式版本
+  uint32_t slot_count{};                         ///< 槽位数量
+  uint32_t slot_size{};                          ///< 每个槽位中 JPEG 数据区的大小
+  uint32_t futex{};                              ///< 每发布一帧加一，读者在此等待
+  uint32_t reserved{};                           ///< 保留
+  uint64_t latest{};                             ///< 最新一帧的序号，从 1 开始，0 表示还没有帧
+  uint64_t heartbeat{};                          ///< 读者最近一次读取的时间，CLOCK_MONOTONIC，单位 ns
+};
+
+/// 槽位头
+struct alignas(64) ShmSlotHeader {
+  uint64_t seq{};              ///< 顺序锁计数，奇数表示正在写入
+  uint64_t frame_index{};      ///< 帧序号
+  uint64_t time_stamp{};       ///< 帧时间戳，单位 ns
+  float fps{};                 ///< 发送端帧率
+  uint32_t jpeg_size{};        ///< JPEG 数据大小
+  uint32_t detection_count{};  ///< 识别结果数量
+  uint32_t cols{};             ///< 原图宽度
+  uint32_t rows{};             ///< 原图高度
+  uint32_t roi_x{};            ///< 预览图对应原图区域的左上角横坐标
+  uint32_t roi_y{};            ///< 预览图对应原图区域的左上角纵坐标
+  uint32_t roi_width{};        ///< 预览图对应原图区域的宽度，JPEG 由该区域缩放得到
+  uint32_t roi_height{};       ///< 预览图对应原图区域的高度
+};
+
+static_assert(sizeof(ShmRingHeader) == 64 && sizeof(ShmSlotHeader) == 64);
+static_assert(sizeof(ViewerDetection) == 40);
+
+/// 共享内存环形缓冲区的写入端
+class ShmRingWriter final {
+ public:
+  ShmRingWriter() = default;
+  ~ShmRingWriter() {
+    if (ptr_) {
+      munmap(ptr_, size_);
+      shm_unlink(name_.c_str());
+    }
+  }
+
+  /**
+   * @brief 创建共享内存
+   * @param [in] name 共享内存名字
+   * @param slot_count 槽位数量
+   * @param slot_size 每个槽位中 JPEG 数据区的大小
+   * @return 是否创建成功
+   */
+  bool Create(std::string REF_IN name, const uint32_t slot_count, const uint32_t slot_size) {
+    if (!slot_count) {
+      LOG(ERROR) << "Shared memory " << name << " needs at least one slot.";
+      return false;
+    }
+    name_ = name;
+    stride_ = sizeof(ShmSlotHeader) + shm_ring::kMaxDetections * sizeof(ViewerDetection) + slot_size;
+    size_ = sizeof(ShmRingHeader) + slot_count * stride_;
+    shm_unlink(name_.c_str());
+    const int fd = shm_open(name_.c_str(), O_CREAT | O_RDWR, 0666);
+    if (fd < 0) {
+      LOG(ERROR) << "Failed to create shared memory " << name << ".";
+      return false;
+    }
+    if (ftruncate(fd, static_cast<off_t>(size_)) != 0) {
+      LOG(ERROR) << "Failed to resize shared memory " << name << ".";
+      close(fd);
+      return false;
+    }
+    void *ptr = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (ptr == MAP_FAILED) {
+      LOG(ERROR) << "Failed to map shared memory " << name << ".";
+      return false;
+    }
+    ptr_ = static_cast<char *>(ptr);
+    std::memset(ptr_, 0, size_);
+    header_ = new (ptr_) ShmRingHeader;
+    header_->slot_count = slot_count;
+    header_->slot_size = slot_size;
+    return true;
+  }
+
+  /// 是否有读者在心跳超时时间内读取过
+  [[nodiscard]] bool Attached() const {
+    const auto now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                         std::chrono::steady_clock::now().time_since_epoch())
+                         .count();
+    const auto heartbeat = std::atomic_ref(header_->heartbeat).load(std::memory_order_relaxed);
+    return heartbeat && static_cast<uint64_t>(now) - heartbeat < shm_ring::kHeartbeatTimeout;
+  }
+
+  /**
+   * @brief 发布一帧并唤醒等待的读者
+   * @param [in] meta 帧信息，seq、jpeg_size 和 detection_count 会被覆盖
+   * @param [in] jpeg JPEG 数据
+   * @param jpeg_size JPEG 数据大小
+   * @param [in] detections 识别结果
+   * @param detection_count 识别结果数量，超出 kMaxDetections 的部分被舍弃
+   * @return 是否发布成功，JPEG 数据超出槽位大小时返回假
+   */
+  bool Publish(ShmSlotHeader REF_IN meta, const uint8_t *jpeg, const size_t jpeg_size,
+               const ViewerDetection *detections, const size_t detection_count) {
+    if (jpeg_size > header_->slot_size) {
+      LOG_EVERY_N(WARNING, 100) << "Frame of " << jpeg_size << " bytes exceeds the slot size of viewer.";
+      return false;
+    }
+    const uint64_t index = std::atomic_ref(header_->latest).load(std::memory_order_relaxed) + 1;
+    char *slot = ptr_ + sizeof(ShmRingHeader) + (index % header_->slot_count) * stride_;
+    auto *slot_header = reinterpret_cast<ShmSlotHeader *>(slot);
+    std::atomic_ref seq(slot_header->seq);
+
+    const uint64_t begin = seq.load(std::memory_order_relaxed) + 1;
+    seq.store(begin, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    const auto count = std::min<size_t>(detection_count, shm_ring::kMaxDetections);
+    slot_header->frame_index = meta.frame_index;
+    slot_header->time_stamp = meta.time_stamp;
+    slot_header->fps = meta.fps;
+    slot_header->jpeg_size = jpeg_size;
+    slot_header->detection_count = count;
+    slot_header->cols = meta.cols;
+    slot_header->rows = meta.rows;
+    slot_header->roi_x = meta.roi_x;
+    slot_header->roi_y = meta.roi_y;
+    slot_header->roi_width = meta.roi_width;
+    slot_header->roi_height = meta.roi_height;
+    std::memcpy(slot + sizeof(ShmSlotHeader), detections, count * sizeof(ViewerDetection));
+    std::memcpy(slot + sizeof(ShmSlotHeader) + shm_ring::kMaxDetections * sizeof(ViewerDetection), jpeg, jpeg_size);
+    seq.store(begin + 1, std::memory_order_release);
+
+    std::atomic_ref(header_->latest).store(index, std::memory_order_release);
+    std::atomic_ref(header_->futex).fetch_add(1, std::memory_order_release);
+#if defined(__linux__)
+    syscall(SYS_futex, &header_->futex, FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+#endif
+    return true;
+  }
+
+ private:
+  std::string name_;         ///< 共享内存名字
+  char *ptr_{};              ///< 共享内存起始地址
+  size_t size_{};            ///< 共享内存大小
+  size_t stride_{};          ///< 每个槽位的大小
+  ShmRingHeader *header_{};  ///< 共享内存头
+};
+
+}  // namespace srm::viewer
+
+#endif  // SRM_VIEWER_SHM_RING_HPP_
@@ -0,0 +1,248 @@
+#ifndef SRM_VIEWER_VIEWER_WEB_HPP_
+#define SRM_VIEWER_VIEWER_WEB_HPP_
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <opencv2/imgproc.hpp>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "srm/common/config.hpp"
+#include "srm/common/image-format.hpp"
+#include "srm/viewer/jpeg-encoder.hpp"
+#include "srm/viewer/overlay.hpp"
+#include "srm/viewer/server-http.hpp"
+#include "srm/viewer/shm-ring.hpp"
+
+namespace srm::viewer {
+
+/**
+ * @brief 网页可视化类
+ * @details
+ * 图像与帧信息、识别结果一起写入共享内存环形缓冲区（格式见 shm-ring.hpp），
+ * 并由内嵌的 HttpServer 直接以 MJPEG 和 WebSocket 推送给浏览器。
+ * SendFrame 把最新一帧复制到与编码线程轮换使用的两个缓冲区之一，编码在后台线程中进行，编码跟不上时旧帧被新帧覆盖，
+ * 调用方随后复用或修改原图不影响编码；
+ * 共享内存和网页都没有读者时 SendFrame 直接返回，不产生任何编码开销。
+ * Bayer 原始数据按原样复制，只有被选中发送的帧才在编码线程中去马赛克。
+ * 绘图以 Overlay 形式随 WebSocket 发送，由网页在 canvas 上绘制，原图不被修改；
+ * 配置 rasterize 为真时才在编码线程中把绘图画到图像副本上，供 video.py 等只读取 JPEG 的客户端使用。
+ * 网页只需要小图：按 preview_fps 抽帧，按 preview_width 缩小后编码，开启 roi 时只发送跟踪目标周围的区域，
+ * 预览图对应的原图区域随帧信息发送，网页据此换算绘图坐标。
+ */
+class WebViewer {
+ public:
+  WebViewer() = default;
+  ~WebViewer() {
+    {
+      std::lock_guard lock{lock_};
+      stop_flag_ = true;
+    }
+    cv_.notify_one();
+    if (thread_.joinable()) {
+      thread_.join();
+    }
+  }
+
+  /**
+   * @brief 初始化可视化类
+   * @param [in] shm_name 共享内存名字
+   * @param port 网页端口
+   * @return 是否初始化成功
+   */
+  bool Initialize(std::string REF_IN shm_name, const int port) {
+    const std::string prefix = "viewer.web";
+    rasterize_ = cfg.Get<bool>({prefix, "rasterize"});
+    quality_ = cfg.Get<int>({prefix, "quality"});
+    preview_width_ = cfg.Get<int>({prefix, "preview_width"});
+    const auto preview_fps = cfg.Get<double>({prefix, "preview_fps"});
+    preview_period_ = preview_fps > 0 ? static_cast<uint64_t>(1e9 / preview_fps) : 0;
+    roi_ = cfg.Get<bool>({prefix, "roi"});
+    roi_width_ = cfg.Get<int>({prefix, "roi_width"});
+    const auto slot_count = cfg.Get<int>({prefix, "slot_count"});
+    if (slot_count <= 0) {
+      LOG(ERROR) << "Invalid slot count " << slot_count << " of web viewer.";
+      return false;
+    }
+    if (!ring_.Create(shm_name, slot_count, cfg.Get<int>({prefix, "shm_size"}))) {
+      return false;
+    }
+    if (cfg.Get<bool>({prefix, "server"}) &&
+        !server_.Start(port, cfg.Get<std::string>({prefix, "assets"}), cfg.Get<std::string>({prefix, "config"}))) {
+      return false;
+    }
+    thread_ = std::thread([this] { Encode(); });
+    return true;
+  }
+
+  /// 是否有共享内存或网页读者，没有读者时绘图类无需生成绘图
+  [[nodiscard]] bool Active() const { return ring_.Attached() || server_.Subscribed(); }
+
+  /**
+   * @brief 发送图像到网页
+   * @param [in] img 要发送的图像，被选中发送时复制一份，之后可以被修改
+   * @param time_stamp 帧时间戳，单位 ns
+   * @param [in] detections 本帧的识别结果
+   * @param [in] overlay 本帧的绘图
+   * @param pixel_format 图像的像素格式，非 BGR 时在编码线程中转换
+   * @return 是否发送成功
+   */
+  bool SendFrame(cv::Mat REF_IN img, const uint64_t time_stamp = 0,
+                 std::vector<ViewerDetection> REF_IN detections = {}, Overlay FWD_IN overlay = {},
+                 const PixelFormat pixel_format = PixelFormat::kBgr8) {
+    if (last_time_stamp_ && time_stamp > last_time_stamp_) {
+      const auto fps = 1e9f / static_cast<float>(time_stamp - last_time_stamp_);
+      fps_ = fps_ > 0 ? 0.9f * fps_ + 0.1f * fps : fps;
+    }
+    last_time_stamp_ = time_stamp;
+    ++frame_index_;
+    if (!Active() || (time_stamp < next_send_ && next_send_ - time_stamp <= preview_period_)) {
+      return true;
+    }
+    /// 按预览帧率的节拍发送，落后超过一个周期时从当前帧重新计时
+    next_send_ = next_send_ && time_stamp - next_send_ < preview_period_ ? next_send_ + preview_period_
+                                                                         : time_stamp + preview_period_;
+    {
+      std::lock_guard lock{lock_};
+      /// 复制到编码线程上次交还的缓冲区，大小不变时不重新分配
+      img.copyTo(image_);
+      pixel_format_ = pixel_format;
+      detections_ = detections;
+      overlay_ = std::forward<Overlay>(overlay);
+      meta_.frame_index = frame_index_;
+      meta_.time_stamp = time_stamp;
+      meta_.fps = fps_;
+      meta_.cols = img.cols;
+      meta_.rows = img.rows;
+      ready_ = true;
+    }
+    cv_.notify_one();
+    return true;
+  }
+
+ private:
+  /// 编码线程，只编码最新一帧
+  void Encode() {
+    cv::Mat image, bgr;
+    PixelFormat pixel_format{};
+    std::vector<ViewerDetection> detections;
+    Overlay overlay;
+    ShmSlotHeader meta;
+    while (true) {
+      {
+        std::unique_lock lock{lock_};
+        cv_.wait(lock, [this] { return ready_ || stop_flag_; });
+        if (stop_flag_) {
+          return;
+        }
+        std::swap(image, image_);
+        pixel_format = pixel_format_;
+        detections.swap(detections_);
+        std::swap(overlay, overlay_);
+        meta = meta_;
+        ready_ = false;
+      }
+      if (pixel_format != PixelFormat::kBgr8) {
+        ToBgr(image, pixel_format, bgr);
+      }
+      const cv::Mat &source = pixel_format == PixelFormat::kBgr8 ? image : bgr;
+      const auto roi = Roi(source.size(), detections);
+      const bool rasterize = rasterize_ && !overlay.Empty();
+      const float scale =
+          preview_width_ > 0 && roi.width > preview_width_ ? static_cast<float>(preview_width_) / roi.width : 1.f;
+      cv::Mat preview = source(roi);
+      /// 缩小或绘图都写入复用的 preview_，不修改原图
+      if (scale < 1) {
+        cv::resize(preview, preview_, {}, scale, scale, cv::INTER_LINEAR);
+        preview = preview_;
+      } else if (rasterize) {
+        preview.copyTo(preview_);
+        preview = preview_;
+      }
+      if (rasterize) {
+        overlay.Rasterize(preview, roi.tl(), scale);
+      }
+      if (!encoder_.Encode(preview, quality_)) {
+        continue;
+      }
+      meta.roi_x = roi.x;
+      meta.roi_y = roi.y;
+      meta.roi_width = roi.width;
+      meta.roi_height = roi.height;
+      ring_.Publish(meta, encoder_.Data(), encoder_.Size(), detections.data(), detections.size());
+      if (server_.Subscribed()) {
+        server_.Publish(
+            std::make_shared<const std::vector<uint8_t>>(encoder_.Data(), encoder_.Data() + encoder_.Size()),
+            std::make_shared<const std::string>(ToJson(meta, detections, overlay)));
+      }
+    }
+  }
+
+  /// 预览图对应的原图区域，开启 roi 且有识别结果时为第一个目标周围的区域，否则为整张图
+  [[nodiscard]] cv::Rect Roi(const cv::Size size, std::vector<ViewerDetection> REF_IN detections) const {
+    if (!roi_ || detections.empty() || roi_width_ <= 0) {
+      return {0, 0, size.width, size.height};
+    }
+    const auto &pts = detections.front().pts;
+    const float center_x = (pts[0] + pts[2] + pts[4] + pts[6]) / 4;
+    const float center_y = (pts[1] + pts[3] + pts[5] + pts[7]) / 4;
+    const int width = std::min(roi_width_, size.width);
+    const int height = std::min(width * size.height / size.width, size.height);
+    const int x = std::clamp(static_cast<int>(center_x) - width / 2, 0, size.width - width);
+    const int y = std::clamp(static_cast<int>(center_y) - height / 2, 0, size.height - height);
+    return {x, y, width, height};
+  }
+
+  /// 将帧信息、识别结果和绘图转为 WebSocket 推送的 JSON
+  static std::string ToJson(ShmSlotHeader REF_IN meta, std::vector<ViewerDetection> REF_IN detections,
+                            Overlay REF_IN overlay) {
+    std::ostringstream json;
+    json << R"({"index":)" << meta.frame_index << R"(,"time_stamp":)" << meta.time_stamp << R"(,"fps":)"
+         << meta.fps << R"(,"cols":)" << meta.cols << R"(,"rows":)" << meta.rows << R"(,"roi":[)" << meta.roi_x << ","
+         << meta.roi_y << "," << meta.roi_width << "," << meta.roi_height << R"(],"detections":[)";
+    for (size_t i = 0; i < detections.size(); ++i) {
+      json << (i ? "," : "") << R"({"label":)" << detections[i].label << R"(,"prob":)" << detections[i].prob
+           << R"(,"pts":[)";
+      for (size_t j = 0; j < detections[i].pts.size(); ++j) {
+        json << (j ? "," : "") << detections[i].pts[j];
+      }
+      json << "]}";
+    }
+    json << R"(],"overlay":)";
+    overlay.WriteJson(json);
+    json << "}";
+    return json.str();
+  }
+
+  ShmRingWriter ring_;          ///< 共享内存环形缓冲区
+  HttpServer server_;           ///< 调试网页服务器
+  uint64_t frame_index_{};      ///< 帧序号
+  uint64_t last_time_stamp_{};  ///< 上一帧的时间戳
+  float fps_{};                 ///< 帧率的滑动平均
+  bool rasterize_{};            ///< 是否把绘图画到 JPEG 上
+  int quality_{};               ///< JPEG 编码质量
+  int preview_width_{};         ///< 预览图最大宽度，0 表示不缩小
+  uint64_t preview_period_{};   ///< 预览帧间隔，单位 ns
+  uint64_t next_send_{};        ///< 下一次发送的时间戳
+  bool roi_{};                  ///< 是否只发送目标周围的区域
+  int roi_width_{};             ///< 目标周围区域的宽度，高度按原图比例
+  JpegEncoder encoder_;         ///< JPEG 编码器，只在编码线程中使用
+  cv::Mat preview_;             ///< 复用的预览图缓冲区
+
+  cv::Mat image_;                            ///< 待编码的图像副本，与编码线程中的缓冲区轮换
+  PixelFormat pixel_format_{};               ///< 待编码图像的像素格式
+  std::vector<ViewerDetection> detections_;  ///< 待发送的识别结果
+  Overlay overlay_;                          ///< 待发送的绘图
+  ShmSlotHeader meta_;                       ///< 待发送的帧信息
+  bool ready_{};                             ///< 是否有待编码的帧
+  bool stop_flag_{};                         ///< 线程停止信号
+  std::mutex lock_;                          ///< 待编码帧的锁
+  std::condition_variable cv_;               ///< 待编码帧通知
+  std::thread thread_;                       ///< 编码线程
+};
+
+}  // namespace srm::viewer
+
+#endif  // SRM_VIEWER_VIEWER_WEB_HPP_
@@ -0,0 +1,55 @@
+// 通过 WebSocket 接收每帧的识别结果和绘图指令，绘制在视频上方的 canvas 上
+var overlayCanvas = document.getElementById('overlay')
+var overlayContext = overlayCanvas.getContext('2d')
+
+function drawOverlay(frame) {
+  var video = document.getElementById('video')
+  overlayCanvas.width = video.clientWidth
+  overlayCanvas.height = video.clientHeight
+  overlayCanvas.style.left = video.offsetLeft + 'px'
+  overlayCanvas.style.top = video.offsetTop + 'px'
+  overlayContext.clearRect(0, 0, overlayCanvas.width, overlayCanvas.height)
+  // 视频只显示原图中 roi 对应的区域
+  var roi = frame.roi || [0, 0, frame.cols, frame.rows]
+  if (!roi[2] || !roi[3]) return
+  // 图像以 object-fit: contain 方式显示，按相同的缩放和留白换算坐标
+  var scale = Math.min(overlayCanvas.width / roi[2], overlayCanvas.height / roi[3])
+  var offsetX = (overlayCanvas.width - roi[2] * scale) / 2 - roi[0] * scale
+  var offsetY = (overlayCanvas.height - roi[3] * scale) / 2 - roi[1] * scale
+  overlayContext.setTransform(scale, 0, 0, scale, offsetX, offsetY)
+  overlayContext.font = '16px sans-serif'
+  for (let shape of frame.overlay || []) {
+    overlayContext.strokeStyle = shape.color
+    overlayContext.fillStyle = shape.color
+    overlayContext.lineWidth = shape.width || 1
+    if (shape.type === 'polyline') {
+      overlayContext.beginPath()
+      for (let i = 0; i + 1 < shape.pts.length; i += 2) {
+        if (i === 0) overlayContext.moveTo(shape.pts[i], shape.pts[i + 1])
+        else overlayContext.lineTo(shape.pts[i], shape.pts[i + 1])
+      }
+      if (shape.closed) overlayContext.closePath()
+      overlayContext.stroke()
+    } else if (shape.type === 'circle') {
+      overlayContext.beginPath()
+      overlayContext.arc(shape.x, shape.y, shape.r, 0, 2 * Math.PI)
+      overlayContext.stroke()
+    } else if (shape.type === 'text') {
+      overlayContext.fillText(shape.text, shape.x, shape.y)
+    }
+  }
+  overlayContext.setTransform(1, 0, 0, 1, 0, 0)
+}
+
+function connectOverlay() {
+  var socket = new WebSocket((location.protocol === 'https:' ? 'wss://' : 'ws://') + location.host + '/ws')
+  socket.onmessage = function (event) {
+    drawOverlay(JSON.parse(event.data))
+  }
+  // 断线后重连
+  socket.onclose = function () {
+    setTimeout(connectOverlay, 1000)
+  }
+}
+
+connectOverlay()
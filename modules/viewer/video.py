@@ -1,21 +1,38 @@
+import ctypes
+import mmap
+import os
+import struct
+import sys
 import time
 
-import gunicorn
-from flask import Flask, render_template, request, jsonify, Response
-import mmap
 import posix_ipc
-import struct
+from flask import Flask, render_template, request, jsonify, Response
 
-shm_name = "srm_viewer_web_armor"
-shm_size = 0x100000
+# 用法：python video.py <共享内存名字> <端口>，例如 python video.py srm_viewer_web_armor 9003
+shm_name = sys.argv[1] if len(sys.argv) > 1 else "srm_viewer_web_armor"
+port = int(sys.argv[2]) if len(sys.argv) > 2 else 9003
 
 path = "config.toml"
 app = Flask(__name__)
 
-import tomli
+# 共享内存布局，与 srm/viewer/shm-ring.hpp 保持一致
+RING_HEADER = struct.Struct("<4sIIIII QQ")  # magic version slot_count slot_size futex reserved latest heartbeat
+# seq frame_index time_stamp fps jpeg_size detection_count cols rows roi_x roi_y roi_width roi_height
+SLOT_HEADER = struct.Struct("<QQQfIIIIIIII")
+HEADER_SIZE = 64
+FUTEX_OFFSET = 16
+LATEST_OFFSET = 24
+HEARTBEAT_OFFSET = 32
+DETECTION_SIZE = 40
+MAX_DETECTIONS = 32
+
+libc = ctypes.CDLL(None, use_errno=True)
+SYS_FUTEX = {"x86_64": 202, "aarch64": 98}.get(os.uname().machine)
+FUTEX_WAIT = 0
 
-with open(path, "rb") as f:
-    config = tomli.load(f)
+
+class Timespec(ctypes.Structure):
+    _fields_ = [("tv_sec", ctypes.c_long), ("tv_nsec", ctypes.c_long)]
 
 
 def read_fild(path):
@@ -29,20 +46,56 @@ def write_file(path, data):
         f.write(data)
 
 
+def wait_frame(shm_map, futex_value):
+    """在 futex 上阻塞等待新帧，最多等待 1 秒；不支持 futex 的平台退化为轮询"""
+    if SYS_FUTEX is None:
+        time.sleep(1 / 100)
+        return
+    address = ctypes.addressof(ctypes.c_char.from_buffer(shm_map, FUTEX_OFFSET))
+    timeout = Timespec(1, 0)
+    libc.syscall(SYS_FUTEX, ctypes.c_void_p(address), FUTEX_WAIT, ctypes.c_uint32(futex_value),
+                 ctypes.byref(timeout), None, 0)
+
+
+def read_slot(shm_map, slot_offset, slot_size):
+    """按顺序锁读取一个槽位，数据被写者改写时返回 None"""
+    seq = struct.unpack_from("<Q", shm_map, slot_offset)[0]
+    if seq & 1:
+        return None
+    header = SLOT_HEADER.unpack_from(shm_map, slot_offset)
+    jpeg_size = min(header[4], slot_size)
+    jpeg_offset = slot_offset + HEADER_SIZE + MAX_DETECTIONS * DETECTION_SIZE
+    data = bytes(shm_map[jpeg_offset:jpeg_offset + jpeg_size])
+    if struct.unpack_from("<Q", shm_map, slot_offset)[0] != seq:
+        return None
+    return header, data
+
+
 def generate():
     shm = posix_ipc.SharedMemory(shm_name)
-    shm_map = mmap.mmap(shm.fd, shm_size, mmap.MAP_SHARED, mmap.PROT_READ)
+    shm_map = mmap.mmap(shm.fd, shm.size, mmap.MAP_SHARED, mmap.PROT_READ | mmap.PROT_WRITE)
+    shm.close_fd()
+    magic, _, slot_count, slot_size, *_ = RING_HEADER.unpack_from(shm_map, 0)
+    if magic != b"SRMV":
+        return
+    stride = HEADER_SIZE + MAX_DETECTIONS * DETECTION_SIZE + slot_size
+    last = 0
     while True:
-        frame_size = struct.unpack("i", shm_map[:4])[0]
-        frame_data = shm_map[4:frame_size]
-        if frame_data is None:
+        # 更新心跳，写者据此判断是否需要编码
+        struct.pack_into("<Q", shm_map, HEARTBEAT_OFFSET, time.monotonic_ns())
+        futex_value = struct.unpack_from("<I", shm_map, FUTEX_OFFSET)[0]
+        latest = struct.unpack_from("<Q", shm_map, LATEST_OFFSET)[0]
+        if latest == last:
+            wait_frame(shm_map, futex_value)
+            continue
+        last = latest
+        slot = read_slot(shm_map, HEADER_SIZE + (latest % slot_count) * stride, slot_size)
+        if slot is None:
             continue
-        ###卡大概是因为刷新不完？
         yield (
             b"--frame\r\n"
-            b"Content-Type: image/jpeg\r\n\r\n" + frame_data + b"\r\n\r\n"
+            b"Content-Type: image/jpeg\r\n\r\n" + slot[1] + b"\r\n\r\n"
         )
-        time.sleep(1 / 40)  # 视频显示在30帧左右即可
 
 
 @app.route("/")
@@ -66,4 +119,4 @@ def save():
 
 
 if __name__ == "__main__":
-    app.run("0.0.0.0", config["viewer"]["web"]["port"], True, threaded=True)
+    app.run("0.0.0.0", port, True, threaded=True)